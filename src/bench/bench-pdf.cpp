@@ -0,0 +1,205 @@
+//-----------------------------------------------------------------------------
+// PDF plugin benchmarks
+//-----------------------------------------------------------------------------
+// PDFLayer needs a FontManager from the engine, so these call the plugin's
+// extraction and RichText build code (pdf/page-extract.h) without a layer:
+// - ExtractPage: extractPDFPage(), text, paragraphs and vector paths
+// - RichTextBuild: buildTextChars() in per-frame slices, as the layer does
+// - VectorCapture: fz_run_page into the vector capture device
+// - OpenDocument: parsing the document from an in-memory stream
+//-----------------------------------------------------------------------------
+
+#include "fixtures.h"
+#include "pdf/page-extract.h"
+#include "pdf/vector-paths.h"
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include <mupdf/fitz.h>
+}
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace yetty::bench {
+
+namespace {
+
+class MuPdfDoc {
+public:
+    explicit MuPdfDoc(const std::string& bytes) : bytes_(bytes) {
+        ctx_ = fz_new_context(nullptr, nullptr, FZ_STORE_DEFAULT);
+        if (!ctx_) return;
+        fz_register_document_handlers(ctx_);
+        doc_ = open();
+    }
+
+    ~MuPdfDoc() {
+        if (doc_) fz_drop_document(ctx_, doc_);
+        if (ctx_) fz_drop_context(ctx_);
+    }
+
+    MuPdfDoc(const MuPdfDoc&) = delete;
+    MuPdfDoc& operator=(const MuPdfDoc&) = delete;
+
+    fz_document* open() {
+        fz_document* doc = nullptr;
+        fz_stream* stm = nullptr;
+        fz_var(stm);
+        fz_try(ctx_) {
+            stm = fz_open_memory(ctx_, reinterpret_cast<const unsigned char*>(bytes_.data()),
+                                 bytes_.size());
+            doc = fz_open_document_with_stream(ctx_, "application/pdf", stm);
+        }
+        fz_always(ctx_) { fz_drop_stream(ctx_, stm); }
+        fz_catch(ctx_) { doc = nullptr; }
+        return doc;
+    }
+
+    fz_context* ctx() const { return ctx_; }
+    fz_document* doc() const { return doc_; }
+    int pageCount() const { return doc_ ? fz_count_pages(ctx_, doc_) : 0; }
+
+private:
+    std::string bytes_;
+    fz_context* ctx_ = nullptr;
+    fz_document* doc_ = nullptr;
+};
+
+bool captureVectors(MuPdfDoc& pdf, int pageNum, VectorPage& vectors) {
+    fz_context* ctx = pdf.ctx();
+    fz_page* page = nullptr;
+    fz_device* dev = nullptr;
+    bool ok = true;
+    fz_var(page);
+    fz_var(dev);
+
+    fz_try(ctx) {
+        page = fz_load_page(ctx, pdf.doc(), pageNum);
+        dev = static_cast<fz_device*>(newVectorCaptureDevice(ctx, &vectors));
+        fz_run_page(ctx, page, dev, fz_identity, nullptr);
+        fz_close_device(ctx, dev);
+    }
+    fz_always(ctx) {
+        fz_drop_device(ctx, dev);
+        if (page) fz_drop_page(ctx, page);
+    }
+    fz_catch(ctx) { ok = false; }
+    return ok;
+}
+
+// range(0): text lines per page
+void BM_PdfExtractPage(benchmark::State& state) {
+    MuPdfDoc pdf(makePdf(4, static_cast<int>(state.range(0)), 0));
+    if (!pdf.doc()) {
+        state.SkipWithError("failed to open generated PDF");
+        return;
+    }
+
+    int pages = pdf.pageCount();
+    int pageNum = 0;
+    size_t glyphCount = 0;
+    PDFExtractSink sink;  // No font registration or image cache outside a layer
+    PDFExtractedPage page;
+    for (auto _ : state) {
+        if (!extractPDFPage(pdf.ctx(), pdf.doc(), pageNum, page, sink)) {
+            state.SkipWithError("page extraction failed");
+            return;
+        }
+        glyphCount += page.chars.size();
+        benchmark::DoNotOptimize(page.paragraphs.data());
+        pageNum = (pageNum + 1) % pages;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(glyphCount));
+}
+BENCHMARK(BM_PdfExtractPage)->Arg(10)->Arg(60)->Arg(200)->Unit(benchmark::kMicrosecond);
+
+// range(0): text lines per page, range(1): per-frame budget in microseconds.
+// One iteration builds a whole page the way PDFLayer spreads it over frames;
+// "frames" is how many slices that took. TextChars go to a vector because
+// RichText needs a GPU context.
+void BM_PdfRichTextBuild(benchmark::State& state) {
+    MuPdfDoc pdf(makePdf(1, static_cast<int>(state.range(0)), 0));
+    PDFExtractedPage page;
+    if (!pdf.doc() || !extractPDFPage(pdf.ctx(), pdf.doc(), 0, page, PDFExtractSink{})) {
+        state.SkipWithError("failed to extract generated PDF");
+        return;
+    }
+
+    const auto budget = std::chrono::microseconds(state.range(1));
+    const float scale = 1200.0f / page.width;
+    std::vector<TextChar> chars;
+    size_t frames = 0;
+    for (auto _ : state) {
+        chars.clear();
+        size_t cursor = 0;
+        bool done = false;
+        while (!done) {
+            auto deadline = std::chrono::steady_clock::now() + budget;
+            done = buildTextChars(page, scale, nullptr, cursor, deadline,
+                                  [&chars](const TextChar& ch) { chars.push_back(ch); });
+            frames++;
+        }
+        benchmark::DoNotOptimize(chars.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * page.chars.size()));
+    state.counters["frames"] = benchmark::Counter(static_cast<double>(frames),
+                                                  benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PdfRichTextBuild)
+    ->Args({60, 4000})
+    ->Args({200, 4000})
+    ->Args({200, 500})
+    ->Unit(benchmark::kMicrosecond);
+
+// range(0): shapes per page
+void BM_PdfVectorCapture(benchmark::State& state) {
+    MuPdfDoc pdf(makePdf(4, 0, static_cast<int>(state.range(0))));
+    if (!pdf.doc()) {
+        state.SkipWithError("failed to open generated PDF");
+        return;
+    }
+
+    int pages = pdf.pageCount();
+    int pageNum = 0;
+    size_t pathCount = 0;
+    VectorPage vectors;
+    for (auto _ : state) {
+        vectors.clear();
+        if (!captureVectors(pdf, pageNum, vectors)) {
+            state.SkipWithError("vector capture failed");
+            return;
+        }
+        pathCount += vectors.paths.size();
+        benchmark::DoNotOptimize(vectors.vertices.data());
+        pageNum = (pageNum + 1) % pages;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(pathCount));
+}
+BENCHMARK(BM_PdfVectorCapture)->Arg(16)->Arg(256)->Arg(2048)->Unit(benchmark::kMicrosecond);
+
+// range(0): page count
+void BM_PdfOpenDocument(benchmark::State& state) {
+    MuPdfDoc pdf(makePdf(static_cast<int>(state.range(0)), 40, 16));
+    if (!pdf.doc()) {
+        state.SkipWithError("failed to open generated PDF");
+        return;
+    }
+
+    for (auto _ : state) {
+        fz_document* doc = pdf.open();
+        if (!doc) {
+            state.SkipWithError("fz_open_document_with_stream failed");
+            return;
+        }
+        benchmark::DoNotOptimize(fz_count_pages(pdf.ctx(), doc));
+        fz_drop_document(pdf.ctx(), doc);
+    }
+}
+BENCHMARK(BM_PdfOpenDocument)->Arg(1)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+} // namespace yetty::bench
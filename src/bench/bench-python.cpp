@@ -0,0 +1,68 @@
+//-----------------------------------------------------------------------------
+// Python plugin benchmarks
+//-----------------------------------------------------------------------------
+// PythonPlugin::execute redirects stdout/stderr into a StringIO around every
+// call; these measure that fixed overhead against the cost of the code itself.
+// The interpreter is started once with package installation and memory
+// tracking disabled, so only the embedding layer is measured.
+//-----------------------------------------------------------------------------
+
+#include "python/python.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <string>
+
+namespace yetty::bench {
+
+namespace {
+
+PythonPlugin* python() {
+    static PluginPtr plugin = [] {
+        setenv("YETTY_PYTHON_NO_INSTALL", "1", 0);
+        setenv("YETTY_PYTHON_SOFT_LIMIT_MB", "0", 0);
+        setenv("YETTY_PYTHON_HARD_LIMIT_MB", "0", 0);
+        auto res = PythonPlugin::create(nullptr);
+        return res ? *res : PluginPtr{};
+    }();
+    return static_cast<PythonPlugin*>(plugin.get());
+}
+
+void runExecute(benchmark::State& state, const std::string& code) {
+    PythonPlugin* py = python();
+    if (!py || !py->isInitialized()) {
+        state.SkipWithError("Python interpreter failed to start");
+        return;
+    }
+    for (auto _ : state) {
+        auto result = py->execute(code);
+        if (!result) {
+            state.SkipWithError(error_msg(result).c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(result->data());
+    }
+}
+
+void BM_PythonExecuteEmpty(benchmark::State& state) {
+    runExecute(state, "pass\n");
+}
+BENCHMARK(BM_PythonExecuteEmpty)->Unit(benchmark::kMicrosecond);
+
+void BM_PythonExecutePrint(benchmark::State& state) {
+    runExecute(state, "print('x' * 80)\n");
+}
+BENCHMARK(BM_PythonExecutePrint)->Unit(benchmark::kMicrosecond);
+
+// range(0): loop iterations inside the executed snippet
+void BM_PythonExecuteLoop(benchmark::State& state) {
+    runExecute(state, "_t = 0\nfor _i in range(" + std::to_string(state.range(0)) +
+                          "):\n    _t += _i\n");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PythonExecuteLoop)->Arg(100)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+} // namespace yetty::bench
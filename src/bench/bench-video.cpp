@@ -0,0 +1,177 @@
+//-----------------------------------------------------------------------------
+// Video plugin benchmarks
+//-----------------------------------------------------------------------------
+// - isVideoFormat: container sniffing over a mixed set of payloads, the way
+//   the plugin manager probes every incoming sequence
+// - SwsScale: the per-frame YUV -> RGBA conversion at common sizes/formats
+// - AvioOpen: VideoLayer::init on an in-memory clip (custom AVIO read
+//   callbacks, probing, stream setup); no GPU work happens before render()
+//-----------------------------------------------------------------------------
+
+#include "fixtures.h"
+#include "video/video.h"
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace yetty::bench {
+
+namespace {
+
+std::vector<std::string> makeFormatPayloads(size_t count, size_t payloadSize) {
+    // Headers of every container the sniffer knows, plus text and noise that
+    // have to fall through all checks
+    const std::array<std::string, 8> heads = {
+        std::string("\x00\x00\x00\x20" "ftypisom", 12),
+        std::string("\x1a\x45\xdf\xa3\x9f\x42\x86\x81\x01\x42\xf7\x81", 12),
+        std::string("RIFF\x24\x00\x00\x00" "AVI LIST", 16),
+        std::string("\x00\x00\x01\xba\x44\x00\x04\x00\x04\x01\x01\x89", 12),
+        std::string("FLV\x01\x05\x00\x00\x00\x09\x00\x00\x00", 12),
+        std::string("%PDF-1.7\n%\xe2\xe3\xcf\xd3\n", 15),
+        std::string("import yetty_wgpu\nprint(1)\n"),
+        std::string(),
+    };
+
+    std::mt19937 rng(1234);
+    std::vector<std::string> payloads;
+    payloads.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string p = heads[i % heads.size()];
+        p.reserve(payloadSize);
+        while (p.size() < payloadSize) {
+            p += static_cast<char>(rng() & 0xff);
+        }
+        payloads.push_back(std::move(p));
+    }
+    return payloads;
+}
+
+void BM_IsVideoFormat(benchmark::State& state) {
+    auto payloads = makeFormatPayloads(static_cast<size_t>(state.range(0)),
+                                       static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& p : payloads) {
+            hits += VideoPlugin::isVideoFormat(p) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(payloads.size()));
+}
+BENCHMARK(BM_IsVideoFormat)
+    ->Args({4096, 64})
+    ->Args({4096, 64 * 1024})
+    ->Args({65536, 256});
+
+struct Resolution {
+    int width;
+    int height;
+};
+
+constexpr std::array<Resolution, 4> RESOLUTIONS = {{
+    {640, 360}, {1280, 720}, {1920, 1080}, {3840, 2160},
+}};
+
+constexpr std::array<AVPixelFormat, 4> SOURCE_FORMATS = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12, AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUV420P10LE,
+};
+
+// range(0): index into SOURCE_FORMATS, range(1): index into RESOLUTIONS
+void BM_SwsScale(benchmark::State& state) {
+    AVPixelFormat srcFormat = SOURCE_FORMATS[state.range(0)];
+    Resolution res = RESOLUTIONS[state.range(1)];
+    state.SetLabel(std::string(av_get_pix_fmt_name(srcFormat)) + " " +
+                   std::to_string(res.width) + "x" + std::to_string(res.height));
+
+    SwsContext* sws = sws_getContext(res.width, res.height, srcFormat,
+                                     res.width, res.height, AV_PIX_FMT_RGBA,
+                                     SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!sws) {
+        state.SkipWithError("sws_getContext failed");
+        return;
+    }
+
+    uint8_t* src[4] = {};
+    int srcStride[4] = {};
+    uint8_t* dst[4] = {};
+    int dstStride[4] = {};
+    if (av_image_alloc(src, srcStride, res.width, res.height, srcFormat, 32) < 0 ||
+        av_image_alloc(dst, dstStride, res.width, res.height, AV_PIX_FMT_RGBA, 32) < 0) {
+        av_freep(&src[0]);
+        sws_freeContext(sws);
+        state.SkipWithError("av_image_alloc failed");
+        return;
+    }
+
+    // Gradient so the planes are not all zero
+    for (int p = 0; p < 4 && src[p]; ++p) {
+        int rows = p == 0 ? res.height : res.height / 2;
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < srcStride[p]; ++x) {
+                src[p][y * srcStride[p] + x] = static_cast<uint8_t>((x + y) & 0xff);
+            }
+        }
+    }
+
+    for (auto _ : state) {
+        sws_scale(sws, src, srcStride, 0, res.height, dst, dstStride);
+        benchmark::ClobberMemory();
+    }
+
+    int64_t pixels = static_cast<int64_t>(res.width) * res.height;
+    state.SetItemsProcessed(state.iterations() * pixels);
+    state.SetBytesProcessed(state.iterations() * pixels * 4);
+
+    av_freep(&src[0]);
+    av_freep(&dst[0]);
+    sws_freeContext(sws);
+}
+BENCHMARK(BM_SwsScale)
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMicrosecond);
+
+// range(0): index into RESOLUTIONS, range(1): frame count
+void BM_AvioOpen(benchmark::State& state) {
+    Resolution res = RESOLUTIONS[state.range(0)];
+    std::string clip = makeY4mClip(res.width, res.height, static_cast<int>(state.range(1)));
+    state.SetLabel(std::to_string(res.width) + "x" + std::to_string(res.height));
+
+    // VideoLayer logs every load to stdout
+    std::ostringstream sink;
+    std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+
+    for (auto _ : state) {
+        VideoLayer layer;
+        auto result = layer.init(clip);
+        if (!result) {
+            std::cout.rdbuf(saved);
+            state.SkipWithError(error_msg(result).c_str());
+            return;
+        }
+        (void)layer.dispose();
+        sink.str({});
+    }
+
+    std::cout.rdbuf(saved);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(clip.size()));
+}
+BENCHMARK(BM_AvioOpen)
+    ->Args({0, 4})
+    ->Args({2, 4})
+    ->Args({3, 2})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+} // namespace yetty::bench
@@ -0,0 +1,131 @@
+#include "fixtures.h"
+
+extern "C" {
+#include <mupdf/fitz.h>
+#include <mupdf/pdf.h>
+}
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace yetty::bench {
+
+std::string makeY4mClip(int width, int height, int frames) {
+    char header[128];
+    std::snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F30:1 Ip A1:1 C420jpeg\n", width, height);
+
+    int chromaW = (width + 1) / 2;
+    int chromaH = (height + 1) / 2;
+    size_t frameBytes = static_cast<size_t>(width) * height + 2 * static_cast<size_t>(chromaW) * chromaH;
+
+    std::string clip(header);
+    clip.reserve(clip.size() + frames * (6 + frameBytes));
+    for (int f = 0; f < frames; ++f) {
+        clip += "FRAME\n";
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                clip += static_cast<char>((x + y + f * 4) & 0xff);
+            }
+        }
+        for (int plane = 0; plane < 2; ++plane) {
+            for (int y = 0; y < chromaH; ++y) {
+                for (int x = 0; x < chromaW; ++x) {
+                    clip += static_cast<char>(plane ? (y * 2 + f) & 0xff : (x * 2) & 0xff);
+                }
+            }
+        }
+    }
+    return clip;
+}
+
+std::string makePdf(int pages, int lines, int shapes) {
+    fz_context* ctx = fz_new_context(nullptr, nullptr, FZ_STORE_DEFAULT);
+    if (!ctx) throw std::runtime_error("makePdf: failed to create MuPDF context");
+
+    std::string bytes;
+    pdf_document* doc = nullptr;
+    fz_font* font = nullptr;
+    fz_buffer* out = nullptr;
+    fz_var(doc);
+    fz_var(font);
+    fz_var(out);
+
+    fz_try(ctx) {
+        doc = pdf_create_document(ctx);
+        font = fz_new_base14_font(ctx, "Helvetica");
+        const fz_rect mediabox = {0, 0, 612, 792};
+        const float black[1] = {0.0f};
+
+        for (int p = 0; p < pages; ++p) {
+            pdf_obj* resources = nullptr;
+            fz_buffer* contents = nullptr;
+            fz_device* dev = pdf_page_write(ctx, doc, mediabox, &resources, &contents);
+
+            // Text: device space is y-down, so glyphs get a flipped matrix
+            fz_text* text = fz_new_text(ctx);
+            float lineHeight = 720.0f / (lines > 0 ? lines : 1);
+            float size = lineHeight * 0.8f;
+            for (int l = 0; l < lines; ++l) {
+                char line[128];
+                std::snprintf(line, sizeof(line),
+                              "Page %d line %d: the quick brown fox jumps over the lazy dog 0123456789",
+                              p + 1, l + 1);
+                fz_matrix trm = fz_make_matrix(size, 0, 0, -size, 36, 36 + lineHeight * (l + 1));
+                fz_show_string(ctx, text, font, trm, line, 0, 0, FZ_BIDI_LTR, FZ_LANG_UNSET);
+            }
+            fz_fill_text(ctx, dev, text, fz_identity, fz_device_gray(ctx), black, 1.0f,
+                         fz_default_color_params);
+            fz_drop_text(ctx, text);
+
+            for (int s = 0; s < shapes; ++s) {
+                float x = 40.0f + (s * 53) % 520;
+                float y = 40.0f + (s * 97) % 700;
+                fz_path* path = fz_new_path(ctx);
+                fz_moveto(ctx, path, x, y);
+                fz_curveto(ctx, path, x + 30, y - 20, x + 50, y + 20, x + 40, y + 40);
+                fz_lineto(ctx, path, x, y + 30);
+                fz_closepath(ctx, path);
+                const float rgb[3] = {(s % 3) / 2.0f, (s % 5) / 4.0f, 0.5f};
+                fz_fill_path(ctx, dev, path, 0, fz_identity, fz_device_rgb(ctx), rgb, 0.8f,
+                             fz_default_color_params);
+                fz_stroke_path(ctx, dev, path, &fz_default_stroke_state, fz_identity,
+                               fz_device_rgb(ctx), rgb, 1.0f, fz_default_color_params);
+                fz_drop_path(ctx, path);
+            }
+
+            fz_close_device(ctx, dev);
+            fz_drop_device(ctx, dev);
+
+            pdf_obj* page = pdf_add_page(ctx, doc, mediabox, 0, resources, contents);
+            pdf_insert_page(ctx, doc, -1, page);
+            pdf_drop_obj(ctx, page);
+            pdf_drop_obj(ctx, resources);
+            fz_drop_buffer(ctx, contents);
+        }
+
+        out = fz_new_buffer(ctx, 64 * 1024);
+        fz_output* output = fz_new_output_with_buffer(ctx, out);
+        pdf_write_document(ctx, doc, output, &pdf_default_write_options);
+        fz_close_output(ctx, output);
+        fz_drop_output(ctx, output);
+
+        unsigned char* data = nullptr;
+        size_t len = fz_buffer_storage(ctx, out, &data);
+        bytes.assign(reinterpret_cast<const char*>(data), len);
+    }
+    fz_always(ctx) {
+        fz_drop_buffer(ctx, out);
+        fz_drop_font(ctx, font);
+        pdf_drop_document(ctx, doc);
+    }
+    fz_catch(ctx) {
+        std::string message = fz_caught_message(ctx);
+        fz_drop_context(ctx);
+        throw std::runtime_error("makePdf: " + message);
+    }
+
+    fz_drop_context(ctx);
+    return bytes;
+}
+
+} // namespace yetty::bench
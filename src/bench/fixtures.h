@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+//-----------------------------------------------------------------------------
+// Synthetic inputs for yetty-plugins-bench
+//-----------------------------------------------------------------------------
+// Generated in memory so the benchmarks need no media files and give the same
+// input on every machine. The FFmpeg build has no encoders or muxers, so video
+// clips are uncompressed YUV4MPEG2 (y4m demuxer + rawvideo decoder).
+//-----------------------------------------------------------------------------
+
+namespace yetty::bench {
+
+// 4:2:0 y4m clip with a moving gradient
+std::string makeY4mClip(int width, int height, int frames);
+
+// PDF written with MuPDF: each page has `lines` lines of Helvetica text and
+// `shapes` filled and stroked curves
+std::string makePdf(int pages, int lines, int shapes);
+
+} // namespace yetty::bench
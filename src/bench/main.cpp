@@ -0,0 +1,27 @@
+//-----------------------------------------------------------------------------
+// yetty-plugins-bench - microbenchmarks for the plugins' CPU paths
+//-----------------------------------------------------------------------------
+// Usage:
+//   yetty-plugins-bench                                # run everything
+//   yetty-plugins-bench --benchmark_filter=SwsScale    # one group
+//   yetty-plugins-bench --benchmark_format=json --benchmark_out=run.json
+//
+// All inputs are generated in memory (see fixtures.h); no GPU, window or media
+// files are needed. Groups whose plugin is not built are left out.
+//-----------------------------------------------------------------------------
+
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+int main(int argc, char** argv) {
+    // Plugin code logs at info level on every load; keep the report readable
+    spdlog::set_level(spdlog::level::warn);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
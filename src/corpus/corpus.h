@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// yetty-corpus-gen - deterministic benchmark inputs
+//-----------------------------------------------------------------------------
+// Every generator derives its content from fixed seeds only; no clocks, host
+// names or thread-count dependent encoder paths. FFmpeg runs single-threaded
+// with the bitexact flags and MuPDF output gets a fixed trailer /ID, so the
+// same source tree produces byte-identical files on every machine. The
+// manifest written next to the files makes that checkable.
+//-----------------------------------------------------------------------------
+
+namespace corpus {
+
+namespace fs = std::filesystem;
+
+struct Options {
+    fs::path outDir;
+    bool quick = false;  // smaller matrix for CI and quick local runs
+};
+
+// Paths written, relative to Options::outDir
+using FileList = std::vector<std::string>;
+
+bool generateVideos(const Options& options, FileList& files);
+bool generatePdfs(const Options& options, FileList& files);
+bool generateData(const Options& options, FileList& files);
+
+// SplitMix64 - same sequence everywhere, unlike std:: distributions
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : _state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+
+private:
+    uint64_t _state;
+};
+
+// FNV-1a over a string, for deriving per-file seeds from names
+inline uint64_t seedFor(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace corpus
@@ -0,0 +1,123 @@
+#include "corpus.h"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdio>
+#include <memory>
+
+namespace corpus {
+
+namespace {
+
+using File = std::unique_ptr<FILE, int (*)(FILE*)>;
+
+File openFile(const fs::path& path) {
+    File file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (!file) spdlog::error("data: cannot open {} for writing", path.string());
+    return file;
+}
+
+constexpr const char* CATEGORIES[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta"};
+constexpr uint32_t CATEGORY_COUNT = sizeof(CATEGORIES) / sizeof(CATEGORIES[0]);
+
+// Mixed column types the way ymery tables and pandas demos read them:
+// integer id, float, category string, bool, quoted text with commas
+bool writeTable(const fs::path& path, const std::string& name, int rows) {
+    File file = openFile(path);
+    if (!file) return false;
+
+    Rng rng(seedFor(name));
+    std::fputs("id,value,score,category,flag,note\n", file.get());
+    for (int r = 0; r < rows; ++r) {
+        double value = rng.unit() * 1000.0 - 500.0;
+        double score = rng.unit();
+        const char* category = CATEGORIES[rng.below(CATEGORY_COUNT)];
+        bool flag = rng.below(2);
+        // %.6f / %.4f keep the text identical across libc implementations
+        std::fprintf(file.get(), "%d,%.6f,%.4f,%s,%s,\"row %d, %s\"\n", r, value, score, category,
+                     flag ? "true" : "false", r, category);
+    }
+    return std::fflush(file.get()) == 0;
+}
+
+// Wide numeric table, tab separated
+bool writeWideTable(const fs::path& path, const std::string& name, int rows, int columns) {
+    File file = openFile(path);
+    if (!file) return false;
+
+    Rng rng(seedFor(name));
+    for (int c = 0; c < columns; ++c) {
+        std::fprintf(file.get(), c ? "\tc%d" : "c%d", c);
+    }
+    std::fputc('\n', file.get());
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            std::fprintf(file.get(), c ? "\t%.5f" : "%.5f", rng.unit() * 2.0 - 1.0);
+        }
+        std::fputc('\n', file.get());
+    }
+    return std::fflush(file.get()) == 0;
+}
+
+// Raw little-endian float32 plus a JSON sidecar with dtype and shape, so
+// Python loads it with numpy.fromfile(...).reshape(shape)
+bool writeArray(const fs::path& dir, const std::string& name, const std::vector<size_t>& shape) {
+    size_t count = 1;
+    for (size_t dim : shape) count *= dim;
+
+    File file = openFile(dir / (name + ".f32"));
+    if (!file) return false;
+
+    Rng rng(seedFor(name));
+    std::vector<float> chunk;
+    chunk.reserve(64 * 1024);
+    for (size_t i = 0; i < count; ++i) {
+        chunk.push_back(static_cast<float>(rng.unit() * 2.0 - 1.0));
+        if (chunk.size() == chunk.capacity() || i + 1 == count) {
+            std::fwrite(chunk.data(), sizeof(float), chunk.size(), file.get());
+            chunk.clear();
+        }
+    }
+    if (std::fflush(file.get()) != 0) return false;
+
+    File sidecar = openFile(dir / (name + ".json"));
+    if (!sidecar) return false;
+    std::fprintf(sidecar.get(), "{\"dtype\": \"<f4\", \"shape\": [");
+    for (size_t i = 0; i < shape.size(); ++i) {
+        std::fprintf(sidecar.get(), i ? ", %zu" : "%zu", shape[i]);
+    }
+    std::fprintf(sidecar.get(), "], \"data\": \"%s.f32\"}\n", name.c_str());
+    return std::fflush(sidecar.get()) == 0;
+}
+
+} // namespace
+
+bool generateData(const Options& options, FileList& files) {
+    const fs::path dir = options.outDir / "data";
+    fs::create_directories(dir);
+
+    bool ok = true;
+    auto record = [&](bool written, std::initializer_list<std::string> names) {
+        for (const std::string& n : names) {
+            if (written) {
+                spdlog::info("data: data/{}", n);
+                files.push_back("data/" + n);
+            }
+        }
+        ok = ok && written;
+    };
+
+    const int bigRows = options.quick ? 100'000 : 1'000'000;
+    record(writeTable(dir / "table-10k.csv", "table-10k", 10'000), {"table-10k.csv"});
+    record(writeTable(dir / "table-large.csv", "table-large", bigRows), {"table-large.csv"});
+    record(writeWideTable(dir / "wide-64col.tsv", "wide-64col", 20'000, 64), {"wide-64col.tsv"});
+
+    record(writeArray(dir, "series-1m", {1'000'000}), {"series-1m.f32", "series-1m.json"});
+    record(writeArray(dir, "matrix-1024", {1024, 1024}), {"matrix-1024.f32", "matrix-1024.json"});
+    if (!options.quick) {
+        record(writeArray(dir, "volume-256", {256, 256, 256}), {"volume-256.f32", "volume-256.json"});
+    }
+    return ok;
+}
+
+} // namespace corpus
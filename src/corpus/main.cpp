@@ -0,0 +1,207 @@
+//-----------------------------------------------------------------------------
+// yetty-corpus-gen - Generate the benchmark input corpus
+//-----------------------------------------------------------------------------
+// Usage:
+//   yetty-corpus-gen [--out <dir>] [--quick] [--only video|pdf|data]
+//                    [--verify <manifest>] [--allow-missing]
+//
+// Writes videos, PDFs and data files under <dir> plus <dir>/manifest.txt
+// ("<fnv1a64> <size> <path>" per file, sorted). Two machines that generate
+// the same corpus produce the same manifest; --verify compares against a
+// manifest from elsewhere and fails on any difference, including files the
+// reference lists but this run did not generate (unless --allow-missing).
+//
+// --quick shrinks some files (fewer frames, rows), so it writes to
+// <dir>/quick to never mix with the full corpus. --only writes
+// manifest-<kind>.txt and leaves a complete manifest.txt alone.
+//
+// Examples:
+//   yetty-corpus-gen --out build-desktop-release/corpus
+//   yetty-corpus-gen --quick --only pdf
+//   yetty-corpus-gen --out corpus --verify reference-manifest.txt
+//-----------------------------------------------------------------------------
+
+#include "corpus.h"
+
+#include <spdlog/spdlog.h>
+#include <args.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using namespace corpus;
+
+//-----------------------------------------------------------------------------
+// Manifest
+//-----------------------------------------------------------------------------
+
+struct Entry {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+};
+
+bool hashFile(const fs::path& path, Entry& entry) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    entry.hash = 14695981039346656037ull;
+    entry.size = 0;
+    std::vector<char> buffer(1 << 20);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize got = in.gcount();
+        for (std::streamsize i = 0; i < got; ++i) {
+            entry.hash ^= static_cast<unsigned char>(buffer[i]);
+            entry.hash *= 1099511628211ull;
+        }
+        entry.size += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+bool writeManifest(const fs::path& path, const fs::path& outDir, FileList files,
+                   std::map<std::string, Entry>& entries) {
+    std::sort(files.begin(), files.end());
+    std::ofstream out(path);
+    if (!out) {
+        spdlog::error("Cannot write {}", path.string());
+        return false;
+    }
+    for (const std::string& rel : files) {
+        Entry entry;
+        if (!hashFile(outDir / rel, entry)) {
+            spdlog::error("Cannot read back {}", rel);
+            return false;
+        }
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(entry.hash));
+        out << hash << ' ' << entry.size << ' ' << rel << '\n';
+        entries[rel] = entry;
+    }
+    return static_cast<bool>(out);
+}
+
+int verifyManifest(const std::string& referencePath, const std::map<std::string, Entry>& entries,
+                   bool allowMissing) {
+    std::ifstream in(referencePath);
+    if (!in) {
+        spdlog::error("Cannot read reference manifest {}", referencePath);
+        return 1;
+    }
+
+    int mismatches = 0;
+    int missing = 0;
+    size_t checked = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::istringstream fields(line);
+        std::string hash;
+        uint64_t size = 0;
+        std::string rel;
+        if (!(fields >> hash >> size >> rel)) {
+            spdlog::error("Malformed manifest line: {}", line);
+            return 1;
+        }
+        checked++;
+        auto it = entries.find(rel);
+        if (it == entries.end()) {
+            // Not generated in this run, e.g. --only or --quick differ
+            if (allowMissing) {
+                spdlog::warn("{}: not generated", rel);
+            } else {
+                spdlog::error("{}: not generated", rel);
+                missing++;
+            }
+            continue;
+        }
+        char actual[17];
+        std::snprintf(actual, sizeof(actual), "%016llx", static_cast<unsigned long long>(it->second.hash));
+        if (hash != actual || size != it->second.size) {
+            spdlog::error("{}: differs (expected {} {} bytes, got {} {} bytes)", rel, hash, size, actual,
+                          it->second.size);
+            mismatches++;
+        }
+    }
+
+    if (mismatches > 0) {
+        spdlog::error("{} of {} files differ from {}", mismatches, checked, referencePath);
+    }
+    if (missing > 0) {
+        spdlog::error("{} of {} files in {} were not generated (--allow-missing to skip them)", missing,
+                      checked, referencePath);
+    }
+    if (mismatches > 0 || missing > 0) return 1;
+    spdlog::info("All generated files match {}", referencePath);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[]) {
+    spdlog::set_level(spdlog::level::info);
+
+    args::ArgumentParser parser("yetty-corpus-gen - Generate deterministic benchmark inputs");
+    args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
+    args::ValueFlag<std::string> outArg(parser, "dir", "Output directory", {'o', "out"}, "corpus");
+    args::Flag quick(parser, "quick", "Smaller matrix (no 4K video, fewer pages and rows)", {"quick"});
+    args::ValueFlag<std::string> onlyArg(parser, "kind", "Generate only video, pdf or data", {"only"});
+    args::ValueFlag<std::string> verifyArg(parser, "manifest", "Compare the result against a manifest",
+                                           {"verify"});
+    args::Flag allowMissing(parser, "allow-missing", "Only warn about reference files not generated",
+                            {"allow-missing"});
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const args::Help&) {
+        std::cout << parser;
+        return 0;
+    } catch (const args::ParseError& e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::string only = args::get(onlyArg);
+    if (!only.empty() && only != "video" && only != "pdf" && only != "data") {
+        std::cerr << "Unknown kind: " << only << std::endl;
+        return 1;
+    }
+
+    Options options;
+    options.outDir = args::get(outArg);
+    options.quick = quick;
+    if (options.quick) options.outDir /= "quick";
+    std::error_code ec;
+    fs::create_directories(options.outDir, ec);
+    if (ec) {
+        spdlog::error("Cannot create {}: {}", options.outDir.string(), ec.message());
+        return 1;
+    }
+
+    FileList files;
+    bool ok = true;
+    if (only.empty() || only == "video") ok = generateVideos(options, files) && ok;
+    if (only.empty() || only == "pdf") ok = generatePdfs(options, files) && ok;
+    if (only.empty() || only == "data") ok = generateData(options, files) && ok;
+
+    std::map<std::string, Entry> entries;
+    const std::string manifest = only.empty() ? "manifest.txt" : "manifest-" + only + ".txt";
+    if (!writeManifest(options.outDir / manifest, options.outDir, files, entries)) return 1;
+    spdlog::info("Wrote {} files to {}", files.size(), options.outDir.string());
+    if (!ok) {
+        spdlog::error("Some files failed to generate");
+        return 1;
+    }
+
+    if (verifyArg) {
+        return verifyManifest(args::get(verifyArg), entries, allowMissing);
+    }
+    return 0;
+}
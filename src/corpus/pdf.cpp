@@ -0,0 +1,238 @@
+#include "corpus.h"
+
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <mupdf/fitz.h>
+#include <mupdf/pdf.h>
+}
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace corpus {
+
+namespace {
+
+// Page mixes the PDF plugin cares about: glyph count per page drives text
+// extraction and rich text layout, font count drives glyph atlas churn, path
+// count drives vector capture
+struct PdfSpec {
+    std::string name;
+    int pages;
+    int linesPerPage;  // 0 = no body text
+    int fonts;         // how many base14 faces the body text cycles through
+    int shapesPerPage;
+};
+
+constexpr const char* FONTS[] = {
+    "Helvetica",     "Times-Roman",       "Courier",       "Helvetica-Bold",
+    "Times-Italic",  "Courier-Oblique",   "Times-Bold",    "Helvetica-Oblique",
+    "Courier-Bold",  "Times-BoldItalic",  "Helvetica-BoldOblique", "Courier-BoldOblique",
+};
+constexpr int FONT_COUNT = sizeof(FONTS) / sizeof(FONTS[0]);
+
+constexpr const char* WORDS[] = {
+    "terminal", "render",  "glyph",    "buffer",  "texture", "shader",  "frame",  "plugin",
+    "cursor",   "scroll",  "layout",   "atlas",   "vertex",  "compute", "pass",   "queue",
+    "a",        "the",     "of",       "and",     "to",      "in",      "is",     "with",
+    "performance", "deterministic", "synchronization", "rasterization", "interpolation",
+};
+constexpr int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+std::string makeLine(Rng& rng, size_t maxChars) {
+    std::string line;
+    while (line.size() < maxChars) {
+        const char* word = WORDS[rng.below(WORD_COUNT)];
+        if (!line.empty()) line += ' ';
+        line += word;
+    }
+    // Cut mid-word now and then, so extraction sees hyphenated line ends
+    if (line.size() > maxChars) {
+        line.resize(maxChars);
+        if (rng.below(4) == 0 && line.back() != ' ') line += '-';
+    }
+    return line;
+}
+
+void writePage(fz_context* ctx, fz_device* dev, const PdfSpec& spec, fz_font** fonts, int pageIndex,
+               Rng& rng) {
+    const float black[1] = {0.0f};
+
+    if (spec.linesPerPage > 0) {
+        // Denser pages get smaller type so the lines still fit the page
+        float lineHeight = 720.0f / spec.linesPerPage;
+        float size = std::min(14.0f, lineHeight * 0.85f);
+        size_t maxChars = static_cast<size_t>(540.0f / (size * 0.5f));
+
+        fz_text* text = fz_new_text(ctx);
+        fz_try(ctx) {
+            for (int l = 0; l < spec.linesPerPage; ++l) {
+                // Font changes per line, and mid-line on mixed-font pages
+                int face = (pageIndex + l) % spec.fonts;
+                std::string line = makeLine(rng, maxChars);
+                fz_matrix trm = fz_make_matrix(size, 0, 0, -size, 36, 36 + lineHeight * (l + 1));
+                if (spec.fonts > 1 && line.size() > 8) {
+                    size_t split = line.size() / 2;
+                    trm = fz_show_string(ctx, text, fonts[face], trm, line.substr(0, split).c_str(), 0, 0,
+                                         FZ_BIDI_LTR, FZ_LANG_UNSET);
+                    face = (face + 1) % spec.fonts;
+                    fz_show_string(ctx, text, fonts[face], trm, line.substr(split).c_str(), 0, 0,
+                                   FZ_BIDI_LTR, FZ_LANG_UNSET);
+                } else {
+                    fz_show_string(ctx, text, fonts[face], trm, line.c_str(), 0, 0, FZ_BIDI_LTR,
+                                   FZ_LANG_UNSET);
+                }
+            }
+            fz_fill_text(ctx, dev, text, fz_identity, fz_device_gray(ctx), black, 1.0f,
+                         fz_default_color_params);
+        }
+        fz_always(ctx) {
+            fz_drop_text(ctx, text);
+        }
+        fz_catch(ctx) {
+            fz_rethrow(ctx);
+        }
+    }
+
+    for (int s = 0; s < spec.shapesPerPage; ++s) {
+        float x = 36.0f + static_cast<float>(rng.unit()) * 500.0f;
+        float y = 36.0f + static_cast<float>(rng.unit()) * 680.0f;
+        float w = 10.0f + static_cast<float>(rng.unit()) * 60.0f;
+        float h = 10.0f + static_cast<float>(rng.unit()) * 60.0f;
+
+        fz_path* path = fz_new_path(ctx);
+        fz_try(ctx) {
+            fz_moveto(ctx, path, x, y);
+            switch (rng.below(3)) {
+                case 0:  // rectangle
+                    fz_lineto(ctx, path, x + w, y);
+                    fz_lineto(ctx, path, x + w, y + h);
+                    fz_lineto(ctx, path, x, y + h);
+                    break;
+                case 1:  // curved blob
+                    fz_curveto(ctx, path, x + w, y - h / 2, x + w * 1.5f, y + h, x + w / 2, y + h);
+                    fz_curveto(ctx, path, x, y + h * 1.2f, x - w / 3, y + h / 2, x, y);
+                    break;
+                default:  // polyline star
+                    for (int k = 1; k < 10; ++k) {
+                        float r = (k % 2) ? w / 2 : w / 5;
+                        float a = k * 0.6283185f;
+                        fz_lineto(ctx, path, x + r * std::sin(a), y - r * std::cos(a) + w / 2);
+                    }
+                    break;
+            }
+            fz_closepath(ctx, path);
+
+            const float rgb[3] = {static_cast<float>(rng.unit()), static_cast<float>(rng.unit()),
+                                  static_cast<float>(rng.unit())};
+            if (rng.below(2)) {
+                fz_fill_path(ctx, dev, path, 0, fz_identity, fz_device_rgb(ctx), rgb, 0.8f,
+                             fz_default_color_params);
+            }
+            fz_stroke_path(ctx, dev, path, &fz_default_stroke_state, fz_identity, fz_device_rgb(ctx),
+                           rgb, 1.0f, fz_default_color_params);
+        }
+        fz_always(ctx) {
+            fz_drop_path(ctx, path);
+        }
+        fz_catch(ctx) {
+            fz_rethrow(ctx);
+        }
+    }
+}
+
+bool writePdf(fz_context* ctx, const PdfSpec& spec, const fs::path& path) {
+    pdf_document* doc = nullptr;
+    fz_font* fonts[FONT_COUNT] = {};
+    fz_var(doc);
+    bool ok = true;
+
+    fz_try(ctx) {
+        doc = pdf_create_document(ctx);
+        for (int f = 0; f < spec.fonts; ++f) fonts[f] = fz_new_base14_font(ctx, FONTS[f]);
+
+        Rng rng(seedFor(spec.name));
+        const fz_rect mediabox = {0, 0, 612, 792};
+        for (int p = 0; p < spec.pages; ++p) {
+            pdf_obj* resources = nullptr;
+            fz_buffer* contents = nullptr;
+            fz_device* dev = pdf_page_write(ctx, doc, mediabox, &resources, &contents);
+            writePage(ctx, dev, spec, fonts, p, rng);
+            fz_close_device(ctx, dev);
+            fz_drop_device(ctx, dev);
+
+            pdf_obj* page = pdf_add_page(ctx, doc, mediabox, 0, resources, contents);
+            pdf_insert_page(ctx, doc, -1, page);
+            pdf_drop_obj(ctx, page);
+            pdf_drop_obj(ctx, resources);
+            fz_drop_buffer(ctx, contents);
+        }
+
+        // MuPDF would otherwise derive /ID from the clock
+        char idSeed[17];
+        std::snprintf(idSeed, sizeof(idSeed), "%016llx",
+                      static_cast<unsigned long long>(seedFor(spec.name)));
+        pdf_obj* id = pdf_new_array(ctx, doc, 2);
+        pdf_array_push_string(ctx, id, idSeed, 16);
+        pdf_array_push_string(ctx, id, idSeed, 16);
+        pdf_dict_put_drop(ctx, pdf_trailer(ctx, doc), PDF_NAME(ID), id);
+
+        pdf_write_options opts = pdf_default_write_options;
+        opts.do_compress = 1;
+        opts.do_garbage = 1;
+        opts.dont_regenerate_id = 1;
+        pdf_save_document(ctx, doc, path.c_str(), &opts);
+    }
+    fz_always(ctx) {
+        for (fz_font* font : fonts) fz_drop_font(ctx, font);
+        pdf_drop_document(ctx, doc);
+    }
+    fz_catch(ctx) {
+        spdlog::error("{}: {}", spec.name, fz_caught_message(ctx));
+        ok = false;
+    }
+    return ok;
+}
+
+std::vector<PdfSpec> pdfMatrix(bool quick) {
+    std::vector<PdfSpec> specs = {
+        {"text-sparse-1p", 1, 12, 1, 0},
+        {"text-dense-20p", 20, 80, 1, 0},
+        {"fonts-mixed-10p", 10, 50, FONT_COUNT, 0},
+        {"vector-heavy-5p", 5, 0, 1, 400},
+        {"mixed-50p", 50, 45, 4, 40},
+    };
+    if (!quick) {
+        specs.push_back({"text-dense-200p", 200, 80, 1, 0});
+        specs.push_back({"vector-heavy-50p", 50, 0, 1, 2000});
+    }
+    return specs;
+}
+
+} // namespace
+
+bool generatePdfs(const Options& options, FileList& files) {
+    fz_context* ctx = fz_new_context(nullptr, nullptr, FZ_STORE_DEFAULT);
+    if (!ctx) {
+        spdlog::error("pdf: failed to create MuPDF context");
+        return false;
+    }
+    fs::create_directories(options.outDir / "pdf");
+
+    bool ok = true;
+    for (const PdfSpec& spec : pdfMatrix(options.quick)) {
+        std::string rel = "pdf/" + spec.name + ".pdf";
+        spdlog::info("pdf: {}", rel);
+        if (writePdf(ctx, spec, options.outDir / rel)) {
+            files.push_back(rel);
+        } else {
+            ok = false;
+        }
+    }
+    fz_drop_context(ctx);
+    return ok;
+}
+
+} // namespace corpus
@@ -0,0 +1,249 @@
+#include "corpus.h"
+
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include <algorithm>
+#include <cmath>
+
+namespace corpus {
+
+namespace {
+
+struct VideoSpec {
+    std::string name;  // file name without extension
+    const char* encoder;
+    const char* extension;  // picks the muxer
+    AVPixelFormat pixFmt;
+    int width;
+    int height;
+    int gop;
+    int bFrames;
+    int frames;
+    bool fullRange = false;
+};
+
+std::string ffmpegError(int err) {
+    char buf[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(err, buf, sizeof(buf));
+    return buf;
+}
+
+// Gradient background, a box moving across it and seeded noise, so inter
+// frames have real motion and residuals to code
+void fillFrame(AVFrame* frame, int index, Rng& rng) {
+    const bool deep = frame->format == AV_PIX_FMT_YUV420P10LE;
+    const int w = frame->width;
+    const int h = frame->height;
+    const int boxSize = std::max(16, h / 6);
+    const int boxX = (index * 7) % std::max(1, w - boxSize);
+    const int boxY = static_cast<int>((h - boxSize) * (0.5 + 0.4 * std::sin(index * 0.15)));
+
+    auto store = [&](int plane, int x, int y, int value8) {
+        if (deep) {
+            auto* row = reinterpret_cast<uint16_t*>(frame->data[plane] + y * frame->linesize[plane]);
+            row[x] = static_cast<uint16_t>(value8 << 2);
+        } else {
+            frame->data[plane][y * frame->linesize[plane] + x] = static_cast<uint8_t>(value8);
+        }
+    };
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            bool inBox = x >= boxX && x < boxX + boxSize && y >= boxY && y < boxY + boxSize;
+            int luma = inBox ? 235 : 16 + (x * 160 / w + y * 40 / h + index) % 200;
+            luma += static_cast<int>(rng.below(9)) - 4;
+            store(0, x, y, std::clamp(luma, 0, 255));
+        }
+    }
+    for (int y = 0; y < (h + 1) / 2; ++y) {
+        for (int x = 0; x < (w + 1) / 2; ++x) {
+            store(1, x, y, (64 + x * 128 / w + index) & 0xff);
+            store(2, x, y, (192 - y * 128 / h) & 0xff);
+        }
+    }
+}
+
+bool drain(AVCodecContext* codec, AVFormatContext* format, AVStream* stream, AVPacket* packet,
+           const std::string& name) {
+    while (true) {
+        int ret = avcodec_receive_packet(codec, packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret < 0) {
+            spdlog::error("{}: encode failed: {}", name, ffmpegError(ret));
+            return false;
+        }
+        av_packet_rescale_ts(packet, codec->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        ret = av_interleaved_write_frame(format, packet);
+        if (ret < 0) {
+            spdlog::error("{}: write failed: {}", name, ffmpegError(ret));
+            return false;
+        }
+    }
+}
+
+bool encodeVideo(const VideoSpec& spec, const fs::path& path) {
+    const AVCodec* encoder = avcodec_find_encoder_by_name(spec.encoder);
+    if (!encoder) {
+        spdlog::error("{}: encoder '{}' not in this FFmpeg build", spec.name, spec.encoder);
+        return false;
+    }
+
+    AVFormatContext* format = nullptr;
+    int ret = avformat_alloc_output_context2(&format, nullptr, nullptr, path.c_str());
+    if (ret < 0 || !format) {
+        spdlog::error("{}: no muxer for {}: {}", spec.name, path.string(), ffmpegError(ret));
+        return false;
+    }
+    format->flags |= AVFMT_FLAG_BITEXACT;
+
+    AVCodecContext* codec = avcodec_alloc_context3(encoder);
+    AVStream* stream = avformat_new_stream(format, nullptr);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    bool ok = codec && stream && frame && packet;
+
+    if (ok) {
+        codec->width = spec.width;
+        codec->height = spec.height;
+        codec->pix_fmt = spec.pixFmt;
+        codec->time_base = {1, 30};
+        codec->framerate = {30, 1};
+        codec->gop_size = spec.gop;
+        codec->max_b_frames = spec.bFrames;
+        codec->thread_count = 1;
+        codec->flags |= AV_CODEC_FLAG_BITEXACT;
+        if (spec.fullRange) codec->color_range = AVCOL_RANGE_JPEG;
+        // Fixed quantizer instead of rate control: same quality at every size
+        if (encoder->id == AV_CODEC_ID_MPEG4 || encoder->id == AV_CODEC_ID_MPEG2VIDEO ||
+            encoder->id == AV_CODEC_ID_MJPEG) {
+            codec->flags |= AV_CODEC_FLAG_QSCALE;
+            codec->global_quality = FF_QP2LAMBDA * 4;
+        }
+        if (format->oformat->flags & AVFMT_GLOBALHEADER) {
+            codec->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+
+        ret = avcodec_open2(codec, encoder, nullptr);
+        if (ret < 0) {
+            spdlog::error("{}: cannot open encoder: {}", spec.name, ffmpegError(ret));
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        avcodec_parameters_from_context(stream->codecpar, codec);
+        stream->time_base = codec->time_base;
+        ret = avio_open(&format->pb, path.c_str(), AVIO_FLAG_WRITE);
+        if (ret < 0) {
+            spdlog::error("{}: cannot open {}: {}", spec.name, path.string(), ffmpegError(ret));
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        ret = avformat_write_header(format, nullptr);
+        if (ret < 0) {
+            spdlog::error("{}: cannot write header: {}", spec.name, ffmpegError(ret));
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        frame->format = spec.pixFmt;
+        frame->width = spec.width;
+        frame->height = spec.height;
+        ok = av_frame_get_buffer(frame, 0) >= 0;
+    }
+
+    Rng rng(seedFor(spec.name));
+    for (int i = 0; ok && i < spec.frames; ++i) {
+        ok = av_frame_make_writable(frame) >= 0;
+        if (!ok) break;
+        fillFrame(frame, i, rng);
+        frame->pts = i;
+        ret = avcodec_send_frame(codec, frame);
+        if (ret < 0) {
+            spdlog::error("{}: send frame failed: {}", spec.name, ffmpegError(ret));
+            ok = false;
+            break;
+        }
+        ok = drain(codec, format, stream, packet, spec.name);
+    }
+
+    if (ok) {
+        avcodec_send_frame(codec, nullptr);
+        ok = drain(codec, format, stream, packet, spec.name);
+    }
+    if (ok) {
+        ok = av_write_trailer(format) >= 0;
+    }
+
+    if (format->pb) avio_closep(&format->pb);
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&codec);
+    avformat_free_context(format);
+    return ok;
+}
+
+std::vector<VideoSpec> videoMatrix(bool quick) {
+    struct Size {
+        const char* label;
+        int width;
+        int height;
+    };
+    std::vector<Size> sizes = {{"360p", 640, 360}, {"720p", 1280, 720}, {"1080p", 1920, 1080}};
+    if (!quick) sizes.push_back({"2160p", 3840, 2160});
+    const int frames = quick ? 30 : 90;
+
+    std::vector<VideoSpec> specs;
+    for (const Size& s : sizes) {
+        std::string res = s.label;
+        // GOP structures: all-intra, short GOP with B-frames, long GOP
+        specs.push_back({"mpeg4-" + res + "-intra", "mpeg4", "mp4", AV_PIX_FMT_YUV420P,
+                         s.width, s.height, 1, 0, frames});
+        specs.push_back({"mpeg4-" + res + "-gop12-b2", "mpeg4", "mp4", AV_PIX_FMT_YUV420P,
+                         s.width, s.height, 12, 2, frames});
+        specs.push_back({"mpeg4-" + res + "-gop250", "mpeg4", "mkv", AV_PIX_FMT_YUV420P,
+                         s.width, s.height, 250, 0, frames});
+        specs.push_back({"mpeg2-" + res + "-gop12-b2", "mpeg2video", "ts", AV_PIX_FMT_YUV420P,
+                         s.width, s.height, 12, 2, frames});
+        specs.push_back({"mjpeg-" + res, "mjpeg", "avi", AV_PIX_FMT_YUV420P,
+                         s.width, s.height, 1, 0, frames, true});
+        specs.push_back({"ffv1-" + res + "-8bit", "ffv1", "mkv", AV_PIX_FMT_YUV420P,
+                         s.width, s.height, 1, 0, frames});
+        specs.push_back({"ffv1-" + res + "-10bit", "ffv1", "mkv", AV_PIX_FMT_YUV420P10LE,
+                         s.width, s.height, 1, 0, frames});
+    }
+    // Uncompressed; large, so only the small sizes
+    specs.push_back({"raw-360p", "rawvideo", "y4m", AV_PIX_FMT_YUV420P, 640, 360, 1, 0, frames});
+    specs.push_back({"raw-720p", "rawvideo", "y4m", AV_PIX_FMT_YUV420P, 1280, 720, 1, 0, frames});
+    return specs;
+}
+
+} // namespace
+
+bool generateVideos(const Options& options, FileList& files) {
+    av_log_set_level(AV_LOG_ERROR);
+    fs::create_directories(options.outDir / "video");
+
+    bool ok = true;
+    for (const VideoSpec& spec : videoMatrix(options.quick)) {
+        std::string rel = "video/" + spec.name + "." + spec.extension;
+        spdlog::info("video: {}", rel);
+        if (encodeVideo(spec, options.outDir / rel)) {
+            files.push_back(rel);
+        } else {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+} // namespace corpus
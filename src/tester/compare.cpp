@@ -0,0 +1,240 @@
+#include "compare.h"
+
+#include <spdlog/spdlog.h>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Samples = std::vector<double>;
+
+//-----------------------------------------------------------------------------
+// Loading - JSON is read with yaml-cpp, which parses it as YAML flow style
+//-----------------------------------------------------------------------------
+
+Samples readSamples(const YAML::Node& node) {
+    Samples samples;
+    if (!node || !node.IsSequence()) return samples;
+    samples.reserve(node.size());
+    for (const auto& value : node) {
+        // Non-finite values were written as null
+        if (value.IsScalar()) samples.push_back(value.as<double>());
+    }
+    return samples;
+}
+
+bool loadMetrics(const std::string& path, std::map<std::string, Samples>& metrics) {
+    YAML::Node root;
+    try {
+        root = YAML::LoadFile(path);
+    } catch (const YAML::Exception& e) {
+        spdlog::error("Failed to read run report {}: {}", path, e.what());
+        return false;
+    }
+    if (!root.IsMap() || !root["work_times_ms"]) {
+        spdlog::error("{} is not a yetty-plugin-tester run report", path);
+        return false;
+    }
+
+    // frame_times_ms is left out: it includes the frame pacing sleep and the
+    // swapchain wait, which hide changes in the plugin's own work
+    metrics["work_ms"] = readSamples(root["work_times_ms"]);
+    if (const auto stages = root["stage_frame_ms"]; stages && stages.IsMap()) {
+        for (const auto& entry : stages) {
+            metrics["stage:" + entry.first.as<std::string>()] = readSamples(entry.second);
+        }
+    }
+    if (const auto memory = root["memory"]; memory && memory.IsMap()) {
+        metrics["rss_mb"] = readSamples(memory["rss_mb"]);
+    }
+    if (const auto gpu = root["gpu_calls"]; gpu && gpu["per_frame"] && gpu["per_frame"].IsMap()) {
+        for (const auto& entry : gpu["per_frame"]) {
+            metrics["gpu:" + entry.first.as<std::string>()] = readSamples(entry.second["samples"]);
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Statistics
+//-----------------------------------------------------------------------------
+
+double median(Samples values) {
+    if (values.empty()) return NAN;
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2) return upper;
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2.0;
+}
+
+// Two-sided Mann-Whitney U test, normal approximation with tie and continuity
+// correction. Also returns P(new > base) as an effect size.
+struct MannWhitney {
+    double p = 1.0;
+    double probGreater = 0.5;
+};
+
+MannWhitney mannWhitney(const Samples& base, const Samples& next) {
+    struct Ranked {
+        double value;
+        bool fromBase;
+    };
+    std::vector<Ranked> all;
+    all.reserve(base.size() + next.size());
+    for (double v : base) all.push_back({v, true});
+    for (double v : next) all.push_back({v, false});
+    std::sort(all.begin(), all.end(), [](const Ranked& a, const Ranked& b) { return a.value < b.value; });
+
+    double n1 = static_cast<double>(base.size());
+    double n2 = static_cast<double>(next.size());
+    double n = n1 + n2;
+    double rankSumBase = 0.0;
+    double tieTerm = 0.0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].value == all[i].value) ++j;
+        double avgRank = (i + 1 + j) / 2.0;  // ranks i+1 .. j
+        double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].fromBase) rankSumBase += avgRank;
+        }
+        i = j;
+    }
+
+    MannWhitney result;
+    double uBase = rankSumBase - n1 * (n1 + 1.0) / 2.0;
+    double uNext = n1 * n2 - uBase;
+    result.probGreater = uNext / (n1 * n2);
+
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+    if (variance <= 0.0) return result;  // every value identical
+    double diff = std::fabs(uNext - mean) - 0.5;
+    double z = std::max(diff, 0.0) / std::sqrt(variance);
+    result.p = std::erfc(z / std::sqrt(2.0));
+    return result;
+}
+
+// Percentile bootstrap interval of the relative change of the median, in %
+struct Interval {
+    double low = NAN;
+    double high = NAN;
+};
+
+Interval bootstrapChange(const Samples& base, const Samples& next, int resamples, double alpha,
+                         uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> pickBase(0, base.size() - 1);
+    std::uniform_int_distribution<size_t> pickNext(0, next.size() - 1);
+
+    Samples changes;
+    changes.reserve(resamples);
+    Samples a(base.size());
+    Samples b(next.size());
+    for (int r = 0; r < resamples; ++r) {
+        for (auto& v : a) v = base[pickBase(rng)];
+        for (auto& v : b) v = next[pickNext(rng)];
+        double mBase = median(a);
+        if (mBase == 0.0) continue;
+        changes.push_back((median(b) - mBase) / std::fabs(mBase) * 100.0);
+    }
+    if (changes.empty()) return {};
+
+    std::sort(changes.begin(), changes.end());
+    auto at = [&](double q) {
+        size_t i = static_cast<size_t>(std::clamp(q, 0.0, 1.0) * (changes.size() - 1));
+        return changes[i];
+    };
+    return {at(alpha / 2.0), at(1.0 - alpha / 2.0)};
+}
+
+//-----------------------------------------------------------------------------
+// Report
+//-----------------------------------------------------------------------------
+
+enum class Verdict { Same, Regression, Improvement, Insufficient, Missing };
+
+const char* verdictName(Verdict v) {
+    switch (v) {
+        case Verdict::Same: return "same";
+        case Verdict::Regression: return "REGRESSION";
+        case Verdict::Improvement: return "improvement";
+        case Verdict::Insufficient: return "too few samples";
+        case Verdict::Missing: return "missing in one run";
+    }
+    return "";
+}
+
+} // namespace
+
+int cmdCompare(const std::string& basePath, const std::string& newPath,
+               const CompareOptions& options) {
+    std::map<std::string, Samples> baseMetrics;
+    std::map<std::string, Samples> newMetrics;
+    if (!loadMetrics(basePath, baseMetrics) || !loadMetrics(newPath, newMetrics)) {
+        return 1;
+    }
+
+    std::map<std::string, bool> names;
+    for (const auto& [name, samples] : baseMetrics) names[name] = true;
+    for (const auto& [name, samples] : newMetrics) names[name] = true;
+
+    bool useBootstrap = options.method == CompareOptions::Method::Bootstrap;
+    std::printf("base: %s\nnew:  %s\n", basePath.c_str(), newPath.c_str());
+    std::printf("method: %s, alpha %.3g, threshold %.3g%%\n\n",
+                useBootstrap ? "bootstrap" : "mann-whitney", options.alpha, options.thresholdPct);
+    std::printf("%-28s %7s %7s %11s %11s %8s %20s %9s  %s\n", "metric", "n base", "n new",
+                "median base", "median new", "change", "CI", "p", "verdict");
+
+    int regressions = 0;
+    for (const auto& [name, present] : names) {
+        (void)present;
+        auto baseIt = baseMetrics.find(name);
+        auto newIt = newMetrics.find(name);
+        if (baseIt == baseMetrics.end() || newIt == newMetrics.end()) {
+            std::printf("%-28s %s\n", name.c_str(), verdictName(Verdict::Missing));
+            continue;
+        }
+        const Samples& base = baseIt->second;
+        const Samples& next = newIt->second;
+        if (base.size() < options.minSamples || next.size() < options.minSamples) {
+            std::printf("%-28s %7zu %7zu %s\n", name.c_str(), base.size(), next.size(),
+                        verdictName(Verdict::Insufficient));
+            continue;
+        }
+
+        double mBase = median(base);
+        double mNext = median(next);
+        double change = mBase != 0.0 ? (mNext - mBase) / std::fabs(mBase) * 100.0
+                                     : (mNext == 0.0 ? 0.0 : INFINITY);
+        MannWhitney mw = mannWhitney(base, next);
+        Interval ci = bootstrapChange(base, next, options.resamples, options.alpha, options.seed);
+
+        bool significant = useBootstrap ? (ci.low > 0.0 || ci.high < 0.0) : mw.p < options.alpha;
+        Verdict verdict = Verdict::Same;
+        if (significant && change > options.thresholdPct) {
+            verdict = Verdict::Regression;
+            regressions++;
+        } else if (significant && change < -options.thresholdPct) {
+            verdict = Verdict::Improvement;
+        }
+
+        char interval[48];
+        std::snprintf(interval, sizeof(interval), "[%+.1f%%, %+.1f%%]", ci.low, ci.high);
+        std::printf("%-28s %7zu %7zu %11.4g %11.4g %+7.1f%% %20s %9.2g  %s\n", name.c_str(),
+                    base.size(), next.size(), mBase, mNext, change, interval, mw.p,
+                    verdictName(verdict));
+    }
+
+    std::printf("\n%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+    return regressions > 0 ? 2 : 0;
+}
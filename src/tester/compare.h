@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//-----------------------------------------------------------------------------
+// yetty-plugin-tester compare - significance test between two run reports
+//-----------------------------------------------------------------------------
+// Reads two `run --json` reports and compares every per-frame sample series
+// they share: render work time, time in each plugin stage, resident memory and
+// WebGPU calls per frame. For
+// each metric it prints both medians, the relative change, a bootstrap
+// confidence interval of that change and the Mann-Whitney U p-value.
+//
+// A metric is flagged as a regression (or improvement) when the selected
+// test finds the difference significant at `alpha` AND the median moved by
+// more than `thresholdPct`, so statistically real but negligible shifts are
+// not reported. Higher is worse for every metric.
+//
+// Consecutive frames are not fully independent (a slow frame tends to be
+// followed by another), so p-values on long runs are optimistic; compare
+// runs of similar length and prefer the bootstrap interval for borderline
+// cases.
+//-----------------------------------------------------------------------------
+
+struct CompareOptions {
+    enum class Method { MannWhitney, Bootstrap };
+
+    Method method = Method::MannWhitney;
+    double alpha = 0.05;
+    double thresholdPct = 2.0;
+    int resamples = 2000;
+    uint64_t seed = 1;
+    size_t minSamples = 8;
+};
+
+// Returns 0 if nothing regressed, 2 if any metric regressed, 1 on errors
+int cmdCompare(const std::string& basePath, const std::string& newPath,
+               const CompareOptions& options);
@@ -5,14 +5,20 @@
 //   yetty-plugin-tester run <plugin-name> [options]
 //   yetty-plugin-tester list
 //   yetty-plugin-tester info <plugin-name>
+//   yetty-plugin-tester compare <base.json> <new.json> [options]
 //
 // Examples:
 //   yetty-plugin-tester run pdf --file document.pdf --rect 0,0,800,600
 //   yetty-plugin-tester run video --file video.mp4 --rect 0,0,1280,720
 //   yetty-plugin-tester run python --code "print('hello')"
 //   yetty-plugin-tester run python --file script.py --pygfx
+//   yetty-plugin-tester run video --file video.mp4 -t 5000 --json run.json --perf-counters
+//   yetty-plugin-tester compare before.json after.json --threshold 3
 //-----------------------------------------------------------------------------
 
+#include "compare.h"
+#include "report.h"
+
 #include <yetty/plugin.h>
 #include <yetty/webgpu-context.h>
 #include <webgpu/webgpu.h>
@@ -22,10 +28,12 @@
 #include <args.hxx>
 
 #include <dlfcn.h>
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -161,7 +169,9 @@ int cmdRun(const std::string& pluginDir,
            const std::string& payload,
            int x, int y, int width, int height,
            bool headless,
-           int durationMs) {
+           int durationMs,
+           const std::string& jsonPath,
+           bool perfCounters) {
 
     // Load plugin
     auto handle = loadPlugin(pluginDir, pluginName);
@@ -215,6 +225,20 @@ int cmdRun(const std::string& pluginDir,
     }
     handle->plugin = *pluginResult;
 
+    // Stage instrumentation starts before the layer so its initial load
+    // (first PDF page, first video frame) is included
+    auto& perfStages = yetty::PerfStages::instance();
+    auto& gpuTrace = yetty::WgpuTrace::instance();
+    auto gpuStart = gpuTrace.snapshot();
+    bool recordStages = !jsonPath.empty() || perfCounters;
+    if (recordStages) {
+        perfStages.reset();
+        if (!perfStages.enable(perfCounters) && perfCounters) {
+            spdlog::warn("Hardware counters unavailable ({}), recording wall time only",
+                         perfStages.countersError());
+        }
+    }
+
     // For Python plugin: set WebGPU handles before creating layer
     // This allows yetty_pygfx to work during payload execution
     if (pluginName == "python") {
@@ -263,6 +287,12 @@ int cmdRun(const std::string& pluginDir,
     auto startTime = std::chrono::steady_clock::now();
     auto lastFrameTime = startTime;
     int frameCount = 0;
+    RunReport report;
+    FrameSampler sampler;
+    if (recordStages) {
+        report.gpuInterposed = gpuTrace.interposed();
+        sampler.begin();
+    }
 
     while (!glfwWindowShouldClose(window) && !g_shouldClose) {
         glfwPollEvents();
@@ -291,6 +321,9 @@ int cmdRun(const std::string& pluginDir,
         float deltaTime = std::chrono::duration<float>(now - lastFrameTime).count();
         lastFrameTime = now;
         renderCtx.deltaTime = deltaTime;
+        if (recordStages && frameCount > 0) {
+            report.frameTimesMs.push_back(deltaTime * 1000.0);
+        }
         layer->setRenderContext(renderCtx);
 
         // Get current texture view
@@ -303,6 +336,7 @@ int cmdRun(const std::string& pluginDir,
         layer->setRenderContext(renderCtx);
 
         // Render the layer (it will handle its own clear and blit)
+        auto workStart = std::chrono::steady_clock::now();
         auto renderResult = layer->render(*ctx);
         if (!renderResult) {
             spdlog::warn("Layer render failed: {}", renderResult.error().message());
@@ -310,6 +344,13 @@ int cmdRun(const std::string& pluginDir,
 
         ctx->present();
         frameCount++;
+        if (recordStages) {
+            // Render through submit and present; unlike the frame interval
+            // this leaves out the headless sleep and the swapchain wait
+            report.workTimesMs.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - workStart).count());
+            sampler.sample(report);
+        }
 
         // Limit frame rate in headless mode
         if (headless) {
@@ -323,6 +364,47 @@ int cmdRun(const std::string& pluginDir,
     spdlog::info("Rendered {} frames in {:.2f}s ({:.1f} fps)",
                  frameCount, totalTime, frameCount / totalTime);
 
+    int exitCode = 0;
+    if (recordStages) {
+        report.plugin = pluginName;
+        report.payload = payload;
+        report.frames = frameCount;
+        report.seconds = totalTime;
+        report.peakRssMb = peakRssMb();
+        report.countersRequested = perfCounters;
+        report.countersAvailable = perfStages.countersEnabled();
+        report.countersError = perfStages.countersError();
+        report.stages = perfStages.snapshot();
+        perfStages.disable();
+
+        if (report.gpuInterposed) {
+            auto gpuEnd = gpuTrace.snapshot();
+            for (int i = 0; i < yetty::WgpuTrace::COUNTER_COUNT; ++i) {
+                report.gpuTotals[i] = gpuEnd[i] - gpuStart[i];
+            }
+            // Setup creates most objects; the per-frame means show steady state
+            std::string perFrame;
+            for (const auto& [name, samples] : report.gpuFrame) {
+                double sum = 0.0;
+                for (double v : samples) sum += v;
+                if (sum > 0.0 && !samples.empty()) {
+                    perFrame += fmt::format(" {}={:.2f}", name, sum / samples.size());
+                }
+            }
+            spdlog::info("WebGPU calls per frame:{}", perFrame.empty() ? " none" : perFrame);
+        } else {
+            spdlog::warn("WebGPU call tracing not active (wgpu-native resolved before the trace library)");
+        }
+
+        for (const auto& stage : report.stages) {
+            spdlog::info("Stage {}: {} calls, {:.3f} ms/call", stage.name, stage.calls,
+                         stage.calls ? stage.wallNs / 1e6 / stage.calls : 0.0);
+        }
+        if (!jsonPath.empty() && !writeRunReport(report, jsonPath)) {
+            exitCode = 1;
+        }
+    }
+
     // Cleanup - order matters!
     // First, clear std::expected's references so reset() calls are final drops
     if (layerResult) {
@@ -341,7 +423,7 @@ int cmdRun(const std::string& pluginDir,
     glfwDestroyWindow(window);
     glfwTerminate();
 
-    return 0;
+    return exitCode;
 }
 
 //-----------------------------------------------------------------------------
@@ -358,6 +440,7 @@ int main(int argc, char* argv[]) {
     args::Command listCmd(commands, "list", "List available plugins");
     args::Command infoCmd(commands, "info", "Show plugin information");
     args::Command runCmd(commands, "run", "Run a plugin");
+    args::Command compareCmd(commands, "compare", "Compare two run reports (--json) for significant regressions");
 
     // Global options
     args::ValueFlag<std::string> pluginDir(parser, "dir", "Plugin directory",
@@ -378,10 +461,24 @@ int main(int argc, char* argv[]) {
     args::ValueFlag<int> duration(runCmd, "ms", "Run for specified duration in milliseconds",
                                   {'t', "duration"}, 0);
     args::Flag pygfx(runCmd, "pygfx", "Initialize pygfx for Python plugin", {"pygfx"});
+    args::ValueFlag<std::string> jsonArg(runCmd, "path", "Write frame times and stage timings as JSON ('-' for stdout)",
+                                         {"json"}, "");
+    args::Flag perfCounters(runCmd, "perf-counters", "Read hardware counters (perf_event_open) around plugin stages",
+                            {"perf-counters"});
 
     // Info command options
     args::Positional<std::string> infoPluginName(infoCmd, "plugin", "Plugin name");
 
+    // Compare command options
+    args::Positional<std::string> baseReport(compareCmd, "base", "Baseline run report");
+    args::Positional<std::string> newReport(compareCmd, "new", "Run report to check");
+    args::ValueFlag<std::string> methodArg(compareCmd, "method", "Significance test: mann-whitney or bootstrap",
+                                           {"method"}, "mann-whitney");
+    args::ValueFlag<double> alphaArg(compareCmd, "alpha", "Significance level", {"alpha"}, 0.05);
+    args::ValueFlag<double> thresholdArg(compareCmd, "percent", "Ignore median changes smaller than this",
+                                         {"threshold"}, 2.0);
+    args::ValueFlag<int> resamplesArg(compareCmd, "n", "Bootstrap resamples", {"resamples"}, 2000);
+
     try {
         parser.ParseCLI(argc, argv);
     } catch (const args::Help&) {
@@ -415,6 +512,25 @@ int main(int argc, char* argv[]) {
         return cmdInfo(dir, args::get(infoPluginName));
     }
 
+    if (compareCmd) {
+        if (!baseReport || !newReport) {
+            std::cerr << "Two run reports required for compare command" << std::endl;
+            return 1;
+        }
+        CompareOptions options;
+        std::string method = args::get(methodArg);
+        if (method == "bootstrap") {
+            options.method = CompareOptions::Method::Bootstrap;
+        } else if (method != "mann-whitney") {
+            std::cerr << "Unknown method: " << method << std::endl;
+            return 1;
+        }
+        options.alpha = args::get(alphaArg);
+        options.thresholdPct = args::get(thresholdArg);
+        options.resamples = std::max(100, args::get(resamplesArg));
+        return cmdCompare(args::get(baseReport), args::get(newReport), options);
+    }
+
     if (runCmd) {
         if (!pluginName) {
             std::cerr << "Plugin name required for run command" << std::endl;
@@ -448,7 +564,8 @@ int main(int argc, char* argv[]) {
         }
 
         return cmdRun(dir, args::get(pluginName), payloadStr,
-                      x, y, w, h, headless, args::get(duration));
+                      x, y, w, h, headless, args::get(duration),
+                      args::get(jsonArg), perfCounters);
     }
 
     // No command specified
@@ -0,0 +1,248 @@
+#include "report.h"
+
+#include <spdlog/spdlog.h>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using yetty::PerfStages;
+using yetty::WgpuTrace;
+
+namespace {
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) return "null";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6g", value);
+    return buf;
+}
+
+// Counter value, or null when the kernel did not provide it
+std::string counter(const PerfStages::Stage& stage, uint32_t bit, double value) {
+    return (stage.available & bit) ? jsonNumber(value) : "null";
+}
+
+void writeStage(std::ostream& out, const PerfStages::Stage& stage, int frames) {
+    double calls = static_cast<double>(stage.calls);
+    double perFrame = frames > 0 ? 1.0 / frames : NAN;
+    double wallMs = stage.wallNs / 1e6;
+
+    const auto& c = stage.counters;
+    double cycles = static_cast<double>(c.cycles);
+    double instructions = static_cast<double>(c.instructions);
+    double cacheMisses = static_cast<double>(c.cacheMisses);
+    double branchMisses = static_cast<double>(c.branchMisses);
+    double kiloInstr = instructions / 1000.0;
+    bool haveIpc = (stage.available & PerfStages::CYCLES) &&
+                   (stage.available & PerfStages::INSTRUCTIONS) && c.cycles > 0;
+    bool haveMpki = (stage.available & PerfStages::INSTRUCTIONS) && c.instructions > 0;
+
+    out << "    " << jsonString(stage.name) << ": {\n"
+        << "      \"calls\": " << stage.calls << ",\n"
+        << "      \"wall_ms\": " << jsonNumber(wallMs) << ",\n"
+        << "      \"wall_ms_per_call\": " << jsonNumber(wallMs / calls) << ",\n"
+        << "      \"wall_ms_per_frame\": " << jsonNumber(wallMs * perFrame) << ",\n"
+        << "      \"cycles\": " << counter(stage, PerfStages::CYCLES, cycles) << ",\n"
+        << "      \"instructions\": " << counter(stage, PerfStages::INSTRUCTIONS, instructions) << ",\n"
+        << "      \"cache_misses\": " << counter(stage, PerfStages::CACHE_MISSES, cacheMisses) << ",\n"
+        << "      \"branch_misses\": " << counter(stage, PerfStages::BRANCH_MISSES, branchMisses) << ",\n"
+        << "      \"ipc\": " << (haveIpc ? jsonNumber(instructions / cycles) : "null") << ",\n"
+        << "      \"cycles_per_call\": " << counter(stage, PerfStages::CYCLES, cycles / calls) << ",\n"
+        << "      \"cache_misses_per_call\": "
+        << counter(stage, PerfStages::CACHE_MISSES, cacheMisses / calls) << ",\n"
+        << "      \"branch_misses_per_call\": "
+        << counter(stage, PerfStages::BRANCH_MISSES, branchMisses / calls) << ",\n"
+        << "      \"cache_misses_per_frame\": "
+        << counter(stage, PerfStages::CACHE_MISSES, cacheMisses * perFrame) << ",\n"
+        << "      \"branch_misses_per_frame\": "
+        << counter(stage, PerfStages::BRANCH_MISSES, branchMisses * perFrame) << ",\n"
+        << "      \"cache_mpki\": "
+        << (haveMpki ? counter(stage, PerfStages::CACHE_MISSES, cacheMisses / kiloInstr) : "null")
+        << ",\n"
+        << "      \"branch_mpki\": "
+        << (haveMpki ? counter(stage, PerfStages::BRANCH_MISSES, branchMisses / kiloInstr) : "null")
+        << "\n"
+        << "    }";
+}
+
+void writeSamples(std::ostream& out, const std::vector<double>& samples) {
+    out << "[";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        out << (i ? ", " : "") << jsonNumber(samples[i]);
+    }
+    out << "]";
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+// Sampling
+//-----------------------------------------------------------------------------
+
+double currentRssMb() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0, residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) return 0.0;
+    return static_cast<double>(residentPages) * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+double peakRssMb() {
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return usage.ru_maxrss / 1024.0;  // KiB on Linux
+}
+
+void FrameSampler::begin() {
+    _last_ns.clear();
+    for (const auto& stage : PerfStages::instance().snapshot()) {
+        _last_ns[stage.name] = stage.wallNs;
+    }
+    _last_gpu = WgpuTrace::instance().snapshot();
+    _frames = 0;
+}
+
+void FrameSampler::sample(RunReport& report) {
+    for (const auto& stage : PerfStages::instance().snapshot()) {
+        auto it = _last_ns.try_emplace(stage.name, 0).first;
+        auto& samples = report.stageFrameMs[stage.name];
+        // A stage first seen now spent no time in the earlier frames
+        samples.resize(_frames, 0.0);
+        samples.push_back((stage.wallNs - it->second) / 1e6);
+        it->second = stage.wallNs;
+    }
+    for (auto& [name, samples] : report.stageFrameMs) {
+        samples.resize(_frames + 1, 0.0);
+    }
+    report.rssMb.push_back(currentRssMb());
+
+    if (report.gpuInterposed) {
+        auto gpu = WgpuTrace::instance().snapshot();
+        for (int i = 0; i < WgpuTrace::COUNTER_COUNT; ++i) {
+            report.gpuFrame[WgpuTrace::counterName(i)].push_back(
+                static_cast<double>(gpu[i] - _last_gpu[i]));
+        }
+        _last_gpu = gpu;
+    }
+    _frames++;
+}
+
+//-----------------------------------------------------------------------------
+// JSON
+//-----------------------------------------------------------------------------
+
+bool writeRunReport(const RunReport& report, const std::string& path) {
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"plugin\": " << jsonString(report.plugin) << ",\n"
+        << "  \"payload\": " << jsonString(report.payload.substr(0, 200)) << ",\n"
+        << "  \"frames\": " << report.frames << ",\n"
+        << "  \"seconds\": " << jsonNumber(report.seconds) << ",\n"
+        << "  \"fps\": "
+        << jsonNumber(report.seconds > 0.0 ? report.frames / report.seconds : NAN) << ",\n";
+
+    out << "  \"frame_times_ms\": ";
+    writeSamples(out, report.frameTimesMs);
+    out << ",\n";
+
+    out << "  \"work_times_ms\": ";
+    writeSamples(out, report.workTimesMs);
+    out << ",\n";
+
+    out << "  \"stage_frame_ms\": {";
+    bool first = true;
+    for (const auto& [name, samples] : report.stageFrameMs) {
+        out << (first ? "\n" : ",\n") << "    " << jsonString(name) << ": ";
+        writeSamples(out, samples);
+        first = false;
+    }
+    out << (first ? "},\n" : "\n  },\n");
+
+    out << "  \"memory\": {\n"
+        << "    \"peak_rss_mb\": " << jsonNumber(report.peakRssMb) << ",\n"
+        << "    \"rss_mb\": ";
+    writeSamples(out, report.rssMb);
+    out << "\n  },\n";
+
+    out << "  \"gpu_calls\": {\n"
+        << "    \"interposed\": " << (report.gpuInterposed ? "true" : "false") << ",\n"
+        << "    \"totals\": {";
+    for (int i = 0; i < WgpuTrace::COUNTER_COUNT; ++i) {
+        out << (i ? ", " : "") << jsonString(WgpuTrace::counterName(i)) << ": "
+            << (report.gpuInterposed ? std::to_string(report.gpuTotals[i]) : "null");
+    }
+    out << "},\n"
+        << "    \"per_frame\": {";
+    first = true;
+    for (const auto& [name, samples] : report.gpuFrame) {
+        double sum = 0.0;
+        double peak = 0.0;
+        for (double v : samples) {
+            sum += v;
+            peak = std::max(peak, v);
+        }
+        out << (first ? "\n" : ",\n") << "      " << jsonString(name) << ": {\"mean\": "
+            << jsonNumber(samples.empty() ? NAN : sum / samples.size())
+            << ", \"max\": " << jsonNumber(peak) << ", \"samples\": ";
+        writeSamples(out, samples);
+        out << "}";
+        first = false;
+    }
+    out << (first ? "}\n" : "\n    }\n") << "  },\n";
+
+    out << "  \"counters\": {\n"
+        << "    \"requested\": " << (report.countersRequested ? "true" : "false") << ",\n"
+        << "    \"available\": " << (report.countersAvailable ? "true" : "false") << ",\n"
+        << "    \"error\": " << jsonString(report.countersError) << "\n"
+        << "  },\n";
+
+    out << "  \"stages\": {";
+    for (size_t i = 0; i < report.stages.size(); ++i) {
+        out << (i ? ",\n" : "\n");
+        writeStage(out, report.stages[i], report.frames);
+    }
+    out << (report.stages.empty() ? "}\n" : "\n  }\n");
+    out << "}\n";
+
+    if (path == "-") {
+        std::cout << out.str();
+        return true;
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        spdlog::error("Failed to open report file: {}", path);
+        return false;
+    }
+    file << out.str();
+    spdlog::info("Wrote run report to {}", path);
+    return true;
+}
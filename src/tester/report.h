@@ -0,0 +1,70 @@
+#pragma once
+
+#include "perf-stages.h"
+#include "wgpu-trace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// RunReport - machine-readable result of `yetty-plugin-tester run --json`
+//-----------------------------------------------------------------------------
+// Frame times, render work times and the PerfStages recorded by the plugin.
+// For every stage the JSON carries totals, per-call values (a call is a
+// decoded frame, an extracted page, ...) and per-rendered-frame values; with
+// hardware counters also IPC and cache/branch misses per call, per frame and
+// per 1000 instructions. Counters the kernel did not provide are written as null.
+//
+// WebGPU calls seen by WgpuTrace are reported as totals and per frame
+// (submits, passes, draws, object creations, uploaded and copied bytes).
+//
+// Per-frame samples (render work time, time spent in each stage, resident memory,
+// WebGPU call counts) are kept as arrays so `yetty-plugin-tester compare` can test two runs
+// against each other rather than two averages.
+//-----------------------------------------------------------------------------
+struct RunReport {
+    std::string plugin;
+    std::string payload;
+    int frames = 0;
+    double seconds = 0.0;
+    std::vector<double> frameTimesMs;  // interval between frame starts, pacing included
+    std::vector<double> workTimesMs;   // render() through present(), per frame
+    std::map<std::string, std::vector<double>> stageFrameMs;  // ms in stage, per frame
+    std::vector<double> rssMb;                                // resident set, per frame
+    double peakRssMb = 0.0;
+
+    bool gpuInterposed = false;
+    yetty::WgpuTrace::Counts gpuTotals{};                 // since recording started
+    std::map<std::string, std::vector<double>> gpuFrame;  // calls per frame, by counter
+
+    bool countersRequested = false;
+    bool countersAvailable = false;
+    std::string countersError;
+    std::vector<yetty::PerfStages::Stage> stages;
+};
+
+//-----------------------------------------------------------------------------
+// FrameSampler - appends one sample per rendered frame to a RunReport
+//-----------------------------------------------------------------------------
+class FrameSampler {
+public:
+    // Stage time and GPU calls recorded before this call (layer setup) are
+    // left out of the per-frame samples
+    void begin();
+    void sample(RunReport& report);
+
+private:
+    std::map<std::string, uint64_t, std::less<>> _last_ns;
+    yetty::WgpuTrace::Counts _last_gpu{};
+    size_t _frames = 0;
+};
+
+// Resident set size of this process in MiB (0 if unknown)
+double currentRssMb();
+double peakRssMb();
+
+// Writes the report; "-" writes to stdout
+bool writeRunReport(const RunReport& report, const std::string& path);
@@ -0,0 +1,281 @@
+#include "color-transform.h"
+#include <yetty/webgpu-context.h>
+#include <yetty/wgpu-compat.h>
+#include <algorithm>
+
+namespace yetty {
+
+struct ColorTransformUniforms {
+    float rect[4];        // NDC x, y, w, h
+    float params[4];      // mode, contrast, unused, unused
+    float foreground[4];
+    float background[4];
+};
+
+PDFColorTransform::~PDFColorTransform() { dispose(); }
+
+Result<WGPUTextureView> PDFColorTransform::begin(WebGPUContext& ctx, WGPUTextureFormat format,
+                                                 uint32_t width, uint32_t height) {
+    WGPUDevice device = ctx.getDevice();
+    width = std::max(1u, width);
+    height = std::max(1u, height);
+
+    if (!pipeline_ || format_ != format) {
+        if (auto res = createPipeline(ctx, format); !res) {
+            return Err<WGPUTextureView>("Failed to create color transform pipeline", res);
+        }
+    }
+
+    // Recreate the offscreen target when the layer is resized
+    if (!texture_ || width_ != width || height_ != height) {
+        if (bindGroup_) { wgpuBindGroupRelease(bindGroup_); bindGroup_ = nullptr; }
+        if (view_) { wgpuTextureViewRelease(view_); view_ = nullptr; }
+        if (texture_) { wgpuTextureRelease(texture_); texture_ = nullptr; }
+
+        WGPUTextureDescriptor texDesc = {};
+        texDesc.size = {width, height, 1};
+        texDesc.format = format;
+        texDesc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+        texDesc.dimension = WGPUTextureDimension_2D;
+        texDesc.mipLevelCount = 1;
+        texDesc.sampleCount = 1;
+        texture_ = wgpuDeviceCreateTexture(device, &texDesc);
+        if (!texture_) return Err<WGPUTextureView>("Failed to create offscreen texture");
+
+        view_ = wgpuTextureCreateView(texture_, nullptr);
+        if (!view_) return Err<WGPUTextureView>("Failed to create offscreen view");
+
+        WGPUBindGroupEntry bgE[3] = {};
+        bgE[0].binding = 0; bgE[0].buffer = uniformBuffer_; bgE[0].size = sizeof(ColorTransformUniforms);
+        bgE[1].binding = 1; bgE[1].sampler = sampler_;
+        bgE[2].binding = 2; bgE[2].textureView = view_;
+        WGPUBindGroupDescriptor bgDesc = {};
+        bgDesc.layout = bgl_; bgDesc.entryCount = 3; bgDesc.entries = bgE;
+        bindGroup_ = wgpuDeviceCreateBindGroup(device, &bgDesc);
+        if (!bindGroup_) return Err<WGPUTextureView>("Failed to create color transform bind group");
+
+        width_ = width;
+        height_ = height;
+    }
+
+    // Clear to transparent; content is blended in premultiplied
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+    if (!encoder) return Err<WGPUTextureView>("Failed to create command encoder");
+
+    WGPURenderPassColorAttachment colorAttachment = {};
+    colorAttachment.view = view_;
+    colorAttachment.loadOp = WGPULoadOp_Clear;
+    colorAttachment.storeOp = WGPUStoreOp_Store;
+    colorAttachment.clearValue = {0.0, 0.0, 0.0, 0.0};
+    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+    WGPURenderPassDescriptor passDesc = {};
+    passDesc.colorAttachmentCount = 1;
+    passDesc.colorAttachments = &colorAttachment;
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &passDesc);
+    if (!pass) {
+        wgpuCommandEncoderRelease(encoder);
+        return Err<WGPUTextureView>("Failed to begin render pass");
+    }
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+
+    WGPUCommandBufferDescriptor cmdDesc = {};
+    WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdDesc);
+    if (cmdBuffer) {
+        wgpuQueueSubmit(ctx.getQueue(), 1, &cmdBuffer);
+        wgpuCommandBufferRelease(cmdBuffer);
+    }
+    wgpuCommandEncoderRelease(encoder);
+
+    return Ok(view_);
+}
+
+Result<void> PDFColorTransform::composite(WebGPUContext& ctx, WGPUTextureView target,
+                                          uint32_t screenWidth, uint32_t screenHeight,
+                                          float pixelX, float pixelY) {
+    if (!bindGroup_) return Err<void>("Color transform used before begin()");
+
+    ColorTransformUniforms uniforms = {};
+    uniforms.rect[0] = (pixelX / screenWidth) * 2.0f - 1.0f;
+    uniforms.rect[1] = 1.0f - (pixelY / screenHeight) * 2.0f;
+    uniforms.rect[2] = (static_cast<float>(width_) / screenWidth) * 2.0f;
+    uniforms.rect[3] = (static_cast<float>(height_) / screenHeight) * 2.0f;
+    uniforms.params[0] = static_cast<float>(static_cast<uint32_t>(theme_.mode));
+    uniforms.params[1] = theme_.contrast;
+    for (int i = 0; i < 4; i++) {
+        uniforms.foreground[i] = theme_.foreground[i];
+        uniforms.background[i] = theme_.background[i];
+    }
+    wgpuQueueWriteBuffer(ctx.getQueue(), uniformBuffer_, 0, &uniforms, sizeof(uniforms));
+
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(ctx.getDevice(), &encoderDesc);
+    if (!encoder) return Err<void>("Failed to create command encoder");
+
+    WGPURenderPassColorAttachment colorAttachment = {};
+    colorAttachment.view = target;
+    colorAttachment.loadOp = WGPULoadOp_Load;
+    colorAttachment.storeOp = WGPUStoreOp_Store;
+    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+    WGPURenderPassDescriptor passDesc = {};
+    passDesc.colorAttachmentCount = 1;
+    passDesc.colorAttachments = &colorAttachment;
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &passDesc);
+    if (!pass) {
+        wgpuCommandEncoderRelease(encoder);
+        return Err<void>("Failed to begin render pass");
+    }
+
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline_);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, bindGroup_, 0, nullptr);
+    wgpuRenderPassEncoderDraw(pass, 6, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+
+    WGPUCommandBufferDescriptor cmdDesc = {};
+    WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdDesc);
+    if (cmdBuffer) {
+        wgpuQueueSubmit(ctx.getQueue(), 1, &cmdBuffer);
+        wgpuCommandBufferRelease(cmdBuffer);
+    }
+    wgpuCommandEncoderRelease(encoder);
+    return Ok();
+}
+
+Result<void> PDFColorTransform::createPipeline(WebGPUContext& ctx, WGPUTextureFormat format) {
+    WGPUDevice device = ctx.getDevice();
+
+    if (pipeline_) { wgpuRenderPipelineRelease(pipeline_); pipeline_ = nullptr; }
+
+    if (!sampler_) {
+        WGPUSamplerDescriptor samplerDesc = {};
+        samplerDesc.minFilter = WGPUFilterMode_Nearest;
+        samplerDesc.magFilter = WGPUFilterMode_Nearest;
+        samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+        samplerDesc.maxAnisotropy = 1;
+        sampler_ = wgpuDeviceCreateSampler(device, &samplerDesc);
+        if (!sampler_) return Err<void>("Failed to create sampler");
+    }
+
+    if (!uniformBuffer_) {
+        WGPUBufferDescriptor bufDesc = {};
+        bufDesc.size = sizeof(ColorTransformUniforms);
+        bufDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+        uniformBuffer_ = wgpuDeviceCreateBuffer(device, &bufDesc);
+        if (!uniformBuffer_) return Err<void>("Failed to create uniform buffer");
+    }
+
+    if (!bgl_) {
+        WGPUBindGroupLayoutEntry entries[3] = {};
+        entries[0].binding = 0; entries[0].visibility = WGPUShaderStage_Vertex | WGPUShaderStage_Fragment;
+        entries[0].buffer.type = WGPUBufferBindingType_Uniform;
+        entries[1].binding = 1; entries[1].visibility = WGPUShaderStage_Fragment;
+        entries[1].sampler.type = WGPUSamplerBindingType_Filtering;
+        entries[2].binding = 2; entries[2].visibility = WGPUShaderStage_Fragment;
+        entries[2].texture.sampleType = WGPUTextureSampleType_Float;
+        entries[2].texture.viewDimension = WGPUTextureViewDimension_2D;
+        WGPUBindGroupLayoutDescriptor bglDesc = {};
+        bglDesc.entryCount = 3; bglDesc.entries = entries;
+        bgl_ = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+        if (!bgl_) return Err<void>("Failed to create bgl");
+    }
+
+    // The offscreen content is premultiplied; transform the straight colour
+    const char* shaderCode = R"(
+struct Uniforms { rect: vec4<f32>, params: vec4<f32>, fg: vec4<f32>, bg: vec4<f32>, }
+@group(0) @binding(0) var<uniform> u: Uniforms;
+@group(0) @binding(1) var texSampler: sampler;
+@group(0) @binding(2) var tex: texture_2d<f32>;
+struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) uv: vec2<f32>, }
+@vertex fn vs_main(@builtin(vertex_index) vi: u32) -> VertexOutput {
+    var p = array<vec2<f32>,6>(vec2(0.,0.),vec2(1.,0.),vec2(1.,1.),vec2(0.,0.),vec2(1.,1.),vec2(0.,1.));
+    let pos = p[vi];
+    var o: VertexOutput;
+    o.position = vec4(u.rect.x + pos.x * u.rect.z, u.rect.y - pos.y * u.rect.w, 0., 1.);
+    o.uv = pos;
+    return o;
+}
+@fragment fn fs_main(@location(0) uv: vec2<f32>) -> @location(0) vec4<f32> {
+    let c = textureSample(tex, texSampler, uv);
+    if (c.a <= 0.0) { return vec4(0.); }
+    var rgb = c.rgb / c.a;
+    let y = dot(rgb, vec3(0.2126, 0.7152, 0.0722));
+    let mode = u32(u.params.x);
+    if (mode == 1u) {
+        rgb = clamp(rgb + (1.0 - 2.0 * y), vec3(0.), vec3(1.));
+    } else if (mode == 2u) {
+        rgb = mix(u.fg.rgb, u.bg.rgb, y);
+    }
+    rgb = clamp((rgb - 0.5) * u.params.y + 0.5, vec3(0.), vec3(1.));
+    return vec4(rgb * c.a, c.a);
+}
+)";
+
+    WGPUShaderSourceWGSL wgslDesc = {};
+    wgslDesc.chain.sType = WGPUSType_ShaderSourceWGSL;
+    wgslDesc.code = WGPU_STR(shaderCode);
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = &wgslDesc.chain;
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
+    if (!shaderModule) return Err<void>("Failed to create color transform shader module");
+
+    WGPUPipelineLayoutDescriptor plDesc = {};
+    plDesc.bindGroupLayoutCount = 1; plDesc.bindGroupLayouts = &bgl_;
+    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
+
+    WGPURenderPipelineDescriptor pipelineDesc = {};
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.vertex.module = shaderModule;
+    pipelineDesc.vertex.entryPoint = WGPU_STR("vs_main");
+    WGPUFragmentState fragState = {};
+    fragState.module = shaderModule; fragState.entryPoint = WGPU_STR("fs_main");
+    WGPUColorTargetState colorTarget = {};
+    colorTarget.format = format; colorTarget.writeMask = WGPUColorWriteMask_All;
+    WGPUBlendState blend = {};
+    blend.color.srcFactor = WGPUBlendFactor_One;
+    blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.color.operation = WGPUBlendOperation_Add;
+    blend.alpha.srcFactor = WGPUBlendFactor_One;
+    blend.alpha.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.alpha.operation = WGPUBlendOperation_Add;
+    colorTarget.blend = &blend;
+    fragState.targetCount = 1; fragState.targets = &colorTarget;
+    pipelineDesc.fragment = &fragState;
+    pipelineDesc.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipelineDesc.multisample.count = 1; pipelineDesc.multisample.mask = ~0u;
+
+    pipeline_ = wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
+
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+
+    if (!pipeline_) return Err<void>("Failed to create color transform pipeline");
+    format_ = format;
+
+    // The offscreen texture must match the new format
+    if (bindGroup_) { wgpuBindGroupRelease(bindGroup_); bindGroup_ = nullptr; }
+    if (view_) { wgpuTextureViewRelease(view_); view_ = nullptr; }
+    if (texture_) { wgpuTextureRelease(texture_); texture_ = nullptr; }
+    return Ok();
+}
+
+void PDFColorTransform::dispose() {
+    if (pipeline_) { wgpuRenderPipelineRelease(pipeline_); pipeline_ = nullptr; }
+    if (bindGroup_) { wgpuBindGroupRelease(bindGroup_); bindGroup_ = nullptr; }
+    if (bgl_) { wgpuBindGroupLayoutRelease(bgl_); bgl_ = nullptr; }
+    if (uniformBuffer_) { wgpuBufferRelease(uniformBuffer_); uniformBuffer_ = nullptr; }
+    if (sampler_) { wgpuSamplerRelease(sampler_); sampler_ = nullptr; }
+    if (view_) { wgpuTextureViewRelease(view_); view_ = nullptr; }
+    if (texture_) { wgpuTextureRelease(texture_); texture_ = nullptr; }
+    width_ = height_ = 0;
+    format_ = WGPUTextureFormat_Undefined;
+}
+
+} // namespace yetty
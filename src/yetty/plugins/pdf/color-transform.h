@@ -0,0 +1,76 @@
+#pragma once
+
+#include <yetty/plugin.h>
+#include <webgpu/webgpu.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace yetty {
+
+class WebGPUContext;
+
+//-----------------------------------------------------------------------------
+// PDFColorTransform - composites a layer's offscreen content with a theme
+//-----------------------------------------------------------------------------
+// Text, vector paths and images are drawn in their document colours into an
+// offscreen texture; the composite pass maps them through the current theme.
+// Switching themes only rewrites a uniform, the glyph data is never rebuilt.
+//-----------------------------------------------------------------------------
+class PDFColorTransform {
+public:
+    enum class Mode : uint32_t {
+        None = 0,     // Document colours
+        Invert = 1,   // Invert lightness, keep hue
+        Palette = 2,  // Map lightness onto foreground..background
+    };
+
+    struct Theme {
+        Mode mode = Mode::Invert;
+        float contrast = 0.8f;  // 1 = unchanged, < 1 pulls towards mid grey
+        float foreground[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        float background[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    };
+
+    ~PDFColorTransform();
+
+    void setTheme(const Theme& theme) { theme_ = theme; }
+    const Theme& theme() const { return theme_; }
+
+    // Clear and return the offscreen target for this frame's content
+    Result<WGPUTextureView> begin(WebGPUContext& ctx, WGPUTextureFormat format,
+                                  uint32_t width, uint32_t height);
+
+    // Draw the offscreen content at the given pixel rect of the real target
+    Result<void> composite(WebGPUContext& ctx, WGPUTextureView target,
+                           uint32_t screenWidth, uint32_t screenHeight,
+                           float pixelX, float pixelY);
+
+    void dispose();
+
+    size_t gpuBytes() const { return static_cast<size_t>(width_) * height_ * 4; }
+
+    // The offscreen target exists at this size and keeps last frame's content
+    bool holds(uint32_t width, uint32_t height) const {
+        return view_ && width_ == std::max(1u, width) && height_ == std::max(1u, height);
+    }
+
+private:
+    Result<void> createPipeline(WebGPUContext& ctx, WGPUTextureFormat format);
+
+    Theme theme_;
+
+    WGPUTexture texture_ = nullptr;
+    WGPUTextureView view_ = nullptr;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+
+    WGPURenderPipeline pipeline_ = nullptr;
+    WGPUTextureFormat format_ = WGPUTextureFormat_Undefined;
+    WGPUBindGroupLayout bgl_ = nullptr;
+    WGPUBindGroup bindGroup_ = nullptr;
+    WGPUBuffer uniformBuffer_ = nullptr;
+    WGPUSampler sampler_ = nullptr;
+};
+
+} // namespace yetty
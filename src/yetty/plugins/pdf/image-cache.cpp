@@ -0,0 +1,664 @@
+#include "image-cache.h"
+#include <yetty/webgpu-context.h>
+#include <yetty/wgpu-compat.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <mupdf/fitz.h>
+}
+
+namespace yetty {
+
+// Images are decoded no larger than this (JPEG decodes subsample for free)
+static constexpr int MAX_IMAGE_SIZE = 2048;
+
+// Textures plus compressed data held beyond what the current frame draws
+static constexpr size_t IMAGE_CACHE_BUDGET = 256u * 1024 * 1024;
+
+struct ImageVertex {
+    float x, y;
+    float u, v;
+};
+
+static uint64_t fnv1a64(const unsigned char* data, size_t len,
+                        uint64_t hash = 0xcbf29ce484222325ull) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Source pixels covering each destination pixel of a 2:1 reduction, with
+// their overlap as weight. An odd size gives every destination pixel a
+// share of 2 + 1/n source pixels, so the last row/column is not dropped.
+struct MipTap {
+    uint32_t first;
+    float weights[3];
+};
+
+static std::vector<MipTap> mipTaps(uint32_t size, uint32_t reduced) {
+    std::vector<MipTap> taps(reduced);
+    double step = static_cast<double>(size) / reduced;
+    for (uint32_t i = 0; i < reduced; i++) {
+        double lo = i * step;
+        double hi = lo + step;
+        MipTap& tap = taps[i];
+        tap.first = static_cast<uint32_t>(lo);
+        for (uint32_t k = 0; k < 3; k++) {
+            double cellLo = tap.first + k;
+            double overlap = std::min(hi, cellLo + 1.0) - std::max(lo, cellLo);
+            tap.weights[k] = tap.first + k < size && overlap > 0.0
+                ? static_cast<float>(overlap / step) : 0.0f;
+        }
+    }
+    return taps;
+}
+
+static std::vector<uint8_t> downsample(const std::vector<uint8_t>& src, uint32_t w, uint32_t h,
+                                       uint32_t nw, uint32_t nh) {
+    auto tx = mipTaps(w, nw);
+    auto ty = mipTaps(h, nh);
+
+    // Horizontal, then vertical, in float to keep the fractional weights
+    std::vector<float> rows(static_cast<size_t>(nw) * h * 4);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < nw; x++) {
+            const MipTap& tap = tx[x];
+            for (int c = 0; c < 4; c++) {
+                float sum = 0.0f;
+                for (uint32_t k = 0; k < 3; k++) {
+                    if (tap.weights[k] > 0.0f) {
+                        sum += tap.weights[k] * src[(static_cast<size_t>(y) * w + tap.first + k) * 4 + c];
+                    }
+                }
+                rows[(static_cast<size_t>(y) * nw + x) * 4 + c] = sum;
+            }
+        }
+    }
+
+    std::vector<uint8_t> out(static_cast<size_t>(nw) * nh * 4);
+    for (uint32_t y = 0; y < nh; y++) {
+        const MipTap& tap = ty[y];
+        for (uint32_t x = 0; x < nw; x++) {
+            for (int c = 0; c < 4; c++) {
+                float sum = 0.0f;
+                for (uint32_t k = 0; k < 3; k++) {
+                    if (tap.weights[k] > 0.0f) {
+                        sum += tap.weights[k] * rows[((static_cast<size_t>(tap.first) + k) * nw + x) * 4 + c];
+                    }
+                }
+                out[(static_cast<size_t>(y) * nw + x) * 4 + c] =
+                    static_cast<uint8_t>(std::clamp(sum + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    }
+    return out;
+}
+
+PDFImageCache::PDFImageCache(void* fzCtx) : fzCtx_(fzCtx) {}
+
+PDFImageCache::~PDFImageCache() {
+    if (worker_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        worker_.join();
+    }
+
+    fz_context* ctx = static_cast<fz_context*>(fzCtx_);
+    for (auto& job : jobs_) {
+        fz_drop_image(ctx, static_cast<fz_image*>(job.image));
+    }
+    jobs_.clear();
+
+    disposeGpu();
+    for (auto& [key, entry] : entries_) {
+        fz_drop_image(ctx, static_cast<fz_image*>(entry.image));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Decoding
+//-----------------------------------------------------------------------------
+
+uint64_t PDFImageCache::request(void* fzImage) {
+    fz_context* ctx = static_cast<fz_context*>(fzCtx_);
+    fz_image* image = static_cast<fz_image*>(fzImage);
+
+    // Same stream bytes = same image, regardless of page or document build
+    uint64_t key = fnv1a64(reinterpret_cast<const unsigned char*>(&image->w), sizeof(image->w));
+    key = fnv1a64(reinterpret_cast<const unsigned char*>(&image->h), sizeof(image->h), key);
+    fz_compressed_buffer* cbuf = fz_compressed_image_buffer(ctx, image);
+    if (cbuf && cbuf->buffer) {
+        unsigned char* data = nullptr;
+        size_t len = fz_buffer_storage(ctx, cbuf->buffer, &data);
+        key = fnv1a64(data, len, key);
+    } else {
+        key = fnv1a64(reinterpret_cast<const unsigned char*>(&image), sizeof(image), key);
+    }
+
+    if (auto it = entries_.find(key); it != entries_.end()) {
+        it->second.refs++;
+        return key;
+    }
+
+    Entry& entry = entries_[key];
+    entry.image = fz_keep_image(ctx, image);
+    entry.sourceBytes = cbuf && cbuf->buffer ? cbuf->buffer->len : 0;
+    entry.refs = 1;
+    sourceBytes_ += entry.sourceBytes;
+    enqueue(key, entry);
+    return key;
+}
+
+void PDFImageCache::release(const std::vector<Placement>& placements) {
+    for (const auto& placement : placements) {
+        auto it = entries_.find(placement.key);
+        if (it != entries_.end() && it->second.refs > 0) it->second.refs--;
+    }
+    evict();
+}
+
+void PDFImageCache::beginFrame(const void* layer, const void* frameToken) {
+    // The token alone is not enough: a surface may hand out the same view
+    // handle every frame
+    if (frameToken == frameToken_ && frameLayers_.insert(layer).second) return;
+    frameToken_ = frameToken;
+    frameLayers_.clear();
+    frameLayers_.insert(layer);
+    frame_++;
+}
+
+void PDFImageCache::enqueue(uint64_t key, Entry& entry) {
+    fz_context* ctx = static_cast<fz_context*>(fzCtx_);
+
+    if (!worker_.joinable()) {
+        fz_context* workerCtx = fz_clone_context(ctx);
+        if (!workerCtx) {
+            spdlog::warn("PDFImageCache: cannot clone MuPDF context, images disabled");
+            entry.state = State::Failed;
+            return;
+        }
+        worker_ = std::thread(&PDFImageCache::workerLoop, this, workerCtx);
+    }
+
+    entry.state = State::Queued;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back({key, fz_keep_image(ctx, static_cast<fz_image*>(entry.image))});
+    }
+    cv_.notify_one();
+}
+
+void PDFImageCache::workerLoop(void* workerCtx) {
+    fz_context* ctx = static_cast<fz_context*>(workerCtx);
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (stop_) break;
+            job = jobs_.front();
+            jobs_.pop_front();
+        }
+
+        Decoded decoded = decode(ctx, job);
+        fz_drop_image(ctx, static_cast<fz_image*>(job.image));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.push_back(std::move(decoded));
+    }
+
+    fz_drop_context(ctx);
+}
+
+PDFImageCache::Decoded PDFImageCache::decode(void* workerCtx, const Job& job) {
+    fz_context* ctx = static_cast<fz_context*>(workerCtx);
+    fz_image* image = static_cast<fz_image*>(job.image);
+
+    Decoded result;
+    result.key = job.key;
+
+    fz_pixmap* pix = nullptr;
+    fz_pixmap* rgb = nullptr;
+    fz_var(pix);
+    fz_var(rgb);
+
+    fz_try(ctx) {
+        // Ask for at most MAX_IMAGE_SIZE so huge scans are subsampled while decoding
+        float s = std::min(1.0f, static_cast<float>(MAX_IMAGE_SIZE) / std::max(image->w, image->h));
+        fz_matrix ctm = fz_scale(image->w * s, image->h * s);
+        pix = fz_get_pixmap_from_image(ctx, image, nullptr, &ctm, nullptr, nullptr);
+
+        if (pix->colorspace) {
+            rgb = pix->colorspace == fz_device_rgb(ctx)
+                ? fz_keep_pixmap(ctx, pix)
+                : fz_convert_pixmap(ctx, pix, fz_device_rgb(ctx), nullptr, nullptr,
+                                    fz_default_color_params, 1);
+
+            int w = fz_pixmap_width(ctx, rgb);
+            int h = fz_pixmap_height(ctx, rgb);
+            int n = fz_pixmap_components(ctx, rgb);
+            bool alpha = fz_pixmap_alpha(ctx, rgb);
+            ptrdiff_t stride = fz_pixmap_stride(ctx, rgb);
+            const unsigned char* src = fz_pixmap_samples(ctx, rgb);
+
+            // Level 0 as RGBA; MuPDF alpha is already premultiplied
+            std::vector<uint8_t> level(static_cast<size_t>(w) * h * 4);
+            for (int y = 0; y < h; y++) {
+                const unsigned char* row = src + y * stride;
+                uint8_t* out = level.data() + static_cast<size_t>(y) * w * 4;
+                for (int x = 0; x < w; x++) {
+                    out[x * 4 + 0] = row[x * n + 0];
+                    out[x * 4 + 1] = row[x * n + 1];
+                    out[x * 4 + 2] = row[x * n + 2];
+                    out[x * 4 + 3] = alpha ? row[x * n + 3] : 255;
+                }
+            }
+
+            result.width = static_cast<uint32_t>(w);
+            result.height = static_cast<uint32_t>(h);
+            result.levels.push_back(std::move(level));
+        }
+    }
+    fz_always(ctx) {
+        fz_drop_pixmap(ctx, rgb);
+        fz_drop_pixmap(ctx, pix);
+    }
+    fz_catch(ctx) {
+        result.levels.clear();
+    }
+
+    // Box-filtered mip chain down to 1x1 (sizes follow WebGPU: floor(n / 2))
+    uint32_t w = result.width, h = result.height;
+    while (!result.levels.empty() && (w > 1 || h > 1)) {
+        uint32_t nw = std::max(1u, w / 2), nh = std::max(1u, h / 2);
+        result.levels.push_back(downsample(result.levels.back(), w, h, nw, nh));
+        w = nw;
+        h = nh;
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+// Upload
+//-----------------------------------------------------------------------------
+
+void PDFImageCache::pump(WebGPUContext& ctx) {
+    std::vector<Decoded> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done.swap(done_);
+    }
+
+    for (auto& decoded : done) {
+        auto it = entries_.find(decoded.key);
+        if (it == entries_.end()) continue;
+        Entry& entry = it->second;
+
+        if (decoded.levels.empty()) {
+            entry.state = State::Failed;
+            continue;
+        }
+        releaseEntryGpu(entry);
+        if (auto res = upload(ctx, entry, decoded); !res) {
+            spdlog::warn("PDFImageCache: {}", res.error().message());
+            entry.state = State::Failed;
+            continue;
+        }
+        entry.state = State::Ready;
+    }
+}
+
+Result<void> PDFImageCache::upload(WebGPUContext& ctx, Entry& entry, const Decoded& px) {
+    WGPUDevice device = ctx.getDevice();
+
+    WGPUTextureDescriptor texDesc = {};
+    texDesc.size = {px.width, px.height, 1};
+    texDesc.format = WGPUTextureFormat_RGBA8Unorm;
+    texDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+    texDesc.dimension = WGPUTextureDimension_2D;
+    texDesc.mipLevelCount = static_cast<uint32_t>(px.levels.size());
+    texDesc.sampleCount = 1;
+    entry.texture = wgpuDeviceCreateTexture(device, &texDesc);
+    if (!entry.texture) return Err<void>("Failed to create image texture");
+
+    uint32_t w = px.width, h = px.height;
+    for (size_t level = 0; level < px.levels.size(); level++) {
+        WGPUTexelCopyTextureInfo dst = {};
+        dst.texture = entry.texture;
+        dst.mipLevel = static_cast<uint32_t>(level);
+        WGPUTexelCopyBufferLayout layout = {};
+        layout.bytesPerRow = w * 4;
+        layout.rowsPerImage = h;
+        WGPUExtent3D extent = {w, h, 1};
+        wgpuQueueWriteTexture(ctx.getQueue(), &dst, px.levels[level].data(),
+                              px.levels[level].size(), &layout, &extent);
+        w = std::max(1u, w / 2);
+        h = std::max(1u, h / 2);
+    }
+
+    entry.view = wgpuTextureCreateView(entry.texture, nullptr);
+    if (!entry.view) return Err<void>("Failed to create image texture view");
+
+    entry.bytes = 0;
+    for (const auto& level : px.levels) entry.bytes += level.size();
+    totalBytes_ += entry.bytes;
+    return Ok();
+}
+
+void PDFImageCache::releaseEntryGpu(Entry& entry) {
+    if (entry.bindGroup) { wgpuBindGroupRelease(entry.bindGroup); entry.bindGroup = nullptr; }
+    if (entry.view) { wgpuTextureViewRelease(entry.view); entry.view = nullptr; }
+    if (entry.texture) { wgpuTextureRelease(entry.texture); entry.texture = nullptr; }
+    totalBytes_ -= std::min(totalBytes_, entry.bytes);
+    entry.bytes = 0;
+}
+
+void PDFImageCache::dropEntry(std::unordered_map<uint64_t, Entry>::iterator it) {
+    Entry& entry = it->second;
+    releaseEntryGpu(entry);
+    sourceBytes_ -= std::min(sourceBytes_, entry.sourceBytes);
+    fz_drop_image(static_cast<fz_context*>(fzCtx_), static_cast<fz_image*>(entry.image));
+    entries_.erase(it);
+}
+
+void PDFImageCache::evict() {
+    // Images no page refers to go first, entirely (a reload that brings
+    // them back within budget still finds them)
+    while (bytes() > IMAGE_CACHE_BUDGET) {
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.refs > 0) continue;
+            if (victim == entries_.end() || it->second.lastUsed < victim->second.lastUsed) victim = it;
+        }
+        if (victim == entries_.end()) break;
+        dropEntry(victim);
+    }
+
+    // Then textures of the least recently drawn images; the kept fz_image
+    // lets a page turn back queue a new decode
+    while (bytes() > IMAGE_CACHE_BUDGET) {
+        Entry* victim = nullptr;
+        for (auto& [key, entry] : entries_) {
+            if (!entry.texture || entry.lastUsed == frame_) continue;
+            if (!victim || entry.lastUsed < victim->lastUsed) victim = &entry;
+        }
+        if (!victim) break;
+        releaseEntryGpu(*victim);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Draw
+//-----------------------------------------------------------------------------
+
+Result<void> PDFImageCache::draw(WebGPUContext& ctx, WGPUTextureView target,
+                                 WGPUTextureFormat format,
+                                 uint32_t screenWidth, uint32_t screenHeight,
+                                 const VectorPathRenderer::Transform& transform,
+                                 const VectorPathRenderer::Scissor& scissor,
+                                 const std::vector<Placement>& placements) {
+    if (placements.empty()) return Ok();
+    if (scissor.x >= screenWidth || scissor.y >= screenHeight || scissor.w == 0 || scissor.h == 0) {
+        return Ok();
+    }
+
+    if (!pipeline_ || format_ != format) {
+        if (auto res = createPipeline(ctx, format); !res) return res;
+    }
+
+    WGPUDevice device = ctx.getDevice();
+
+    // Collect ready images; evicted ones are decoded again for a later frame
+    std::vector<ImageVertex> vertices;
+    std::vector<Entry*> drawn;
+    for (const auto& placement : placements) {
+        auto it = entries_.find(placement.key);
+        if (it == entries_.end() || it->second.state != State::Ready) continue;
+        Entry& entry = it->second;
+
+        if (!entry.texture) {
+            enqueue(it->first, entry);
+            continue;
+        }
+        if (!entry.bindGroup) {
+            WGPUBindGroupEntry bgE[2] = {};
+            bgE[0].binding = 0; bgE[0].sampler = sampler_;
+            bgE[1].binding = 1; bgE[1].textureView = entry.view;
+            WGPUBindGroupDescriptor bgDesc = {};
+            bgDesc.layout = textureBgl_; bgDesc.entryCount = 2; bgDesc.entries = bgE;
+            entry.bindGroup = wgpuDeviceCreateBindGroup(device, &bgDesc);
+            if (!entry.bindGroup) continue;
+        }
+        entry.lastUsed = frame_;
+
+        const auto& c = placement.corners;
+        vertices.push_back({c[0][0], c[0][1], 0, 0});
+        vertices.push_back({c[1][0], c[1][1], 1, 0});
+        vertices.push_back({c[2][0], c[2][1], 1, 1});
+        vertices.push_back({c[0][0], c[0][1], 0, 0});
+        vertices.push_back({c[2][0], c[2][1], 1, 1});
+        vertices.push_back({c[3][0], c[3][1], 0, 1});
+        drawn.push_back(&entry);
+    }
+    evict();
+    if (drawn.empty()) return Ok();
+
+    if (vertices.size() > vertexCapacity_) {
+        if (vertexBuffer_) { wgpuBufferRelease(vertexBuffer_); vertexBuffer_ = nullptr; }
+        vertexCapacity_ = std::max<size_t>({vertices.size(), vertexCapacity_ * 2, 64});
+
+        WGPUBufferDescriptor bufDesc = {};
+        bufDesc.size = vertexCapacity_ * sizeof(ImageVertex);
+        bufDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
+        vertexBuffer_ = wgpuDeviceCreateBuffer(device, &bufDesc);
+        if (!vertexBuffer_) {
+            vertexCapacity_ = 0;
+            return Err<void>("Failed to create image vertex buffer");
+        }
+    }
+
+    size_t bytes = vertices.size() * sizeof(ImageVertex);
+    wgpuQueueWriteBuffer(ctx.getQueue(), vertexBuffer_, 0, vertices.data(), bytes);
+    wgpuQueueWriteBuffer(ctx.getQueue(), uniformBuffer_, 0, &transform, sizeof(transform));
+
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+    if (!encoder) return Err<void>("Failed to create command encoder");
+
+    WGPURenderPassColorAttachment colorAttachment = {};
+    colorAttachment.view = target;
+    colorAttachment.loadOp = WGPULoadOp_Load;
+    colorAttachment.storeOp = WGPUStoreOp_Store;
+    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+    WGPURenderPassDescriptor passDesc = {};
+    passDesc.colorAttachmentCount = 1;
+    passDesc.colorAttachments = &colorAttachment;
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &passDesc);
+    if (!pass) {
+        wgpuCommandEncoderRelease(encoder);
+        return Err<void>("Failed to begin render pass");
+    }
+
+    uint32_t sw = std::min(scissor.w, screenWidth - scissor.x);
+    uint32_t sh = std::min(scissor.h, screenHeight - scissor.y);
+    wgpuRenderPassEncoderSetScissorRect(pass, scissor.x, scissor.y, sw, sh);
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline_);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, uniformBindGroup_, 0, nullptr);
+    wgpuRenderPassEncoderSetVertexBuffer(pass, 0, vertexBuffer_, 0, bytes);
+    for (size_t i = 0; i < drawn.size(); i++) {
+        wgpuRenderPassEncoderSetBindGroup(pass, 1, drawn[i]->bindGroup, 0, nullptr);
+        wgpuRenderPassEncoderDraw(pass, 6, 1, static_cast<uint32_t>(i * 6), 0);
+    }
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+
+    WGPUCommandBufferDescriptor cmdDesc = {};
+    WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdDesc);
+    if (cmdBuffer) {
+        wgpuQueueSubmit(ctx.getQueue(), 1, &cmdBuffer);
+        wgpuCommandBufferRelease(cmdBuffer);
+    }
+    wgpuCommandEncoderRelease(encoder);
+    return Ok();
+}
+
+Result<void> PDFImageCache::createPipeline(WebGPUContext& ctx, WGPUTextureFormat format) {
+    WGPUDevice device = ctx.getDevice();
+
+    if (pipeline_) { wgpuRenderPipelineRelease(pipeline_); pipeline_ = nullptr; }
+
+    if (!sampler_) {
+        WGPUSamplerDescriptor samplerDesc = {};
+        samplerDesc.minFilter = WGPUFilterMode_Linear;
+        samplerDesc.magFilter = WGPUFilterMode_Linear;
+        samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Linear;
+        samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+        samplerDesc.lodMaxClamp = 32.0f;
+        samplerDesc.maxAnisotropy = 1;
+        sampler_ = wgpuDeviceCreateSampler(device, &samplerDesc);
+        if (!sampler_) return Err<void>("Failed to create image sampler");
+    }
+
+    if (!uniformBuffer_) {
+        WGPUBufferDescriptor bufDesc = {};
+        bufDesc.size = sizeof(VectorPathRenderer::Transform);
+        bufDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+        uniformBuffer_ = wgpuDeviceCreateBuffer(device, &bufDesc);
+        if (!uniformBuffer_) return Err<void>("Failed to create image uniform buffer");
+    }
+
+    if (!uniformBgl_) {
+        WGPUBindGroupLayoutEntry entry = {};
+        entry.binding = 0; entry.visibility = WGPUShaderStage_Vertex;
+        entry.buffer.type = WGPUBufferBindingType_Uniform;
+        WGPUBindGroupLayoutDescriptor bglDesc = {};
+        bglDesc.entryCount = 1; bglDesc.entries = &entry;
+        uniformBgl_ = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+        if (!uniformBgl_) return Err<void>("Failed to create bgl");
+
+        WGPUBindGroupEntry bgE = {};
+        bgE.binding = 0; bgE.buffer = uniformBuffer_; bgE.size = sizeof(VectorPathRenderer::Transform);
+        WGPUBindGroupDescriptor bgDesc = {};
+        bgDesc.layout = uniformBgl_; bgDesc.entryCount = 1; bgDesc.entries = &bgE;
+        uniformBindGroup_ = wgpuDeviceCreateBindGroup(device, &bgDesc);
+    }
+
+    if (!textureBgl_) {
+        WGPUBindGroupLayoutEntry entries[2] = {};
+        entries[0].binding = 0; entries[0].visibility = WGPUShaderStage_Fragment;
+        entries[0].sampler.type = WGPUSamplerBindingType_Filtering;
+        entries[1].binding = 1; entries[1].visibility = WGPUShaderStage_Fragment;
+        entries[1].texture.sampleType = WGPUTextureSampleType_Float;
+        entries[1].texture.viewDimension = WGPUTextureViewDimension_2D;
+        WGPUBindGroupLayoutDescriptor bglDesc = {};
+        bglDesc.entryCount = 2; bglDesc.entries = entries;
+        textureBgl_ = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+        if (!textureBgl_) return Err<void>("Failed to create bgl");
+    }
+
+    const char* shaderCode = R"(
+struct Uniforms { scale: vec2<f32>, offset: vec2<f32>, }
+@group(0) @binding(0) var<uniform> u: Uniforms;
+@group(1) @binding(0) var texSampler: sampler;
+@group(1) @binding(1) var tex: texture_2d<f32>;
+struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) uv: vec2<f32>, }
+@vertex fn vs_main(@location(0) pos: vec2<f32>, @location(1) uv: vec2<f32>) -> VertexOutput {
+    var o: VertexOutput;
+    o.position = vec4(pos * u.scale + u.offset, 0., 1.);
+    o.uv = uv;
+    return o;
+}
+@fragment fn fs_main(@location(0) uv: vec2<f32>) -> @location(0) vec4<f32> {
+    return textureSample(tex, texSampler, uv);
+}
+)";
+
+    WGPUShaderSourceWGSL wgslDesc = {};
+    wgslDesc.chain.sType = WGPUSType_ShaderSourceWGSL;
+    wgslDesc.code = WGPU_STR(shaderCode);
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = &wgslDesc.chain;
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
+    if (!shaderModule) return Err<void>("Failed to create image shader module");
+
+    WGPUBindGroupLayout bgls[2] = {uniformBgl_, textureBgl_};
+    WGPUPipelineLayoutDescriptor plDesc = {};
+    plDesc.bindGroupLayoutCount = 2; plDesc.bindGroupLayouts = bgls;
+    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
+
+    WGPUVertexAttribute attributes[2] = {};
+    attributes[0].format = WGPUVertexFormat_Float32x2;
+    attributes[0].offset = offsetof(ImageVertex, x);
+    attributes[0].shaderLocation = 0;
+    attributes[1].format = WGPUVertexFormat_Float32x2;
+    attributes[1].offset = offsetof(ImageVertex, u);
+    attributes[1].shaderLocation = 1;
+
+    WGPUVertexBufferLayout vertexLayout = {};
+    vertexLayout.stepMode = WGPUVertexStepMode_Vertex;
+    vertexLayout.arrayStride = sizeof(ImageVertex);
+    vertexLayout.attributeCount = 2;
+    vertexLayout.attributes = attributes;
+
+    WGPURenderPipelineDescriptor pipelineDesc = {};
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.vertex.module = shaderModule;
+    pipelineDesc.vertex.entryPoint = WGPU_STR("vs_main");
+    pipelineDesc.vertex.bufferCount = 1;
+    pipelineDesc.vertex.buffers = &vertexLayout;
+    WGPUFragmentState fragState = {};
+    fragState.module = shaderModule; fragState.entryPoint = WGPU_STR("fs_main");
+    WGPUColorTargetState colorTarget = {};
+    colorTarget.format = format; colorTarget.writeMask = WGPUColorWriteMask_All;
+    // Premultiplied alpha (MuPDF pixmaps)
+    WGPUBlendState blend = {};
+    blend.color.srcFactor = WGPUBlendFactor_One;
+    blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.color.operation = WGPUBlendOperation_Add;
+    blend.alpha.srcFactor = WGPUBlendFactor_One;
+    blend.alpha.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.alpha.operation = WGPUBlendOperation_Add;
+    colorTarget.blend = &blend;
+    fragState.targetCount = 1; fragState.targets = &colorTarget;
+    pipelineDesc.fragment = &fragState;
+    pipelineDesc.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipelineDesc.multisample.count = 1; pipelineDesc.multisample.mask = ~0u;
+
+    pipeline_ = wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
+
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+
+    if (!pipeline_) return Err<void>("Failed to create image pipeline");
+    format_ = format;
+    return Ok();
+}
+
+void PDFImageCache::disposeGpu() {
+    for (auto& [key, entry] : entries_) releaseEntryGpu(entry);
+    if (pipeline_) { wgpuRenderPipelineRelease(pipeline_); pipeline_ = nullptr; }
+    if (uniformBindGroup_) { wgpuBindGroupRelease(uniformBindGroup_); uniformBindGroup_ = nullptr; }
+    if (uniformBgl_) { wgpuBindGroupLayoutRelease(uniformBgl_); uniformBgl_ = nullptr; }
+    if (textureBgl_) { wgpuBindGroupLayoutRelease(textureBgl_); textureBgl_ = nullptr; }
+    if (uniformBuffer_) { wgpuBufferRelease(uniformBuffer_); uniformBuffer_ = nullptr; }
+    if (vertexBuffer_) { wgpuBufferRelease(vertexBuffer_); vertexBuffer_ = nullptr; }
+    if (sampler_) { wgpuSamplerRelease(sampler_); sampler_ = nullptr; }
+    vertexCapacity_ = 0;
+    format_ = WGPUTextureFormat_Undefined;
+}
+
+} // namespace yetty
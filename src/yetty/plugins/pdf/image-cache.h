@@ -0,0 +1,138 @@
+#pragma once
+
+#include "vector-paths.h"
+#include <yetty/plugin.h>
+#include <webgpu/webgpu.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace yetty {
+
+class WebGPUContext;
+
+//-----------------------------------------------------------------------------
+// PDFImageCache - embedded images decoded off-thread, shared by all layers
+//-----------------------------------------------------------------------------
+// Images are keyed by a hash of their compressed stream, so a logo repeated
+// on every page (or in a rebuilt file) is decoded and uploaded only once.
+// Decoding runs on a worker with a cloned fz_context; finished images are
+// uploaded with a full mip chain so the sampler picks the level for the zoom.
+//
+// Layers hold a reference per placement (request/release). Memory - textures
+// plus the compressed images kept for re-decoding - is held to a byte budget:
+// unreferenced images are dropped first, then textures of images not drawn
+// this frame. A frame is everything drawn for one surface target, whatever
+// the number of layers.
+//-----------------------------------------------------------------------------
+class PDFImageCache {
+public:
+    // Page-space corners (top-left, top-right, bottom-right, bottom-left)
+    struct Placement {
+        uint64_t key;
+        float corners[4][2];
+    };
+
+    // fzCtx must have been created with locks (fz_clone_context requirement)
+    explicit PDFImageCache(void* fzCtx);
+    ~PDFImageCache();
+
+    PDFImageCache(const PDFImageCache&) = delete;
+    PDFImageCache& operator=(const PDFImageCache&) = delete;
+
+    // Main thread: returns the cache key for an fz_image*, queueing a decode if
+    // new. Each call takes a reference that release() gives back.
+    uint64_t request(void* fzImage);
+    void release(const std::vector<Placement>& placements);
+
+    // Main thread, by every layer before drawing: frameToken is the surface
+    // target. A new token, or a layer showing up twice, starts a new frame.
+    void beginFrame(const void* layer, const void* frameToken);
+
+    // Main thread: upload images the worker has finished
+    void pump(WebGPUContext& ctx);
+
+    // Draw placements whose images are ready; pending ones are skipped this frame
+    Result<void> draw(WebGPUContext& ctx, WGPUTextureView target, WGPUTextureFormat format,
+                      uint32_t screenWidth, uint32_t screenHeight,
+                      const VectorPathRenderer::Transform& transform,
+                      const VectorPathRenderer::Scissor& scissor,
+                      const std::vector<Placement>& placements);
+
+    // Release GPU objects (images are decoded again when next drawn)
+    void disposeGpu();
+
+    // Textures plus compressed image data currently held
+    size_t bytes() const { return totalBytes_ + sourceBytes_; }
+
+private:
+    struct Job {
+        uint64_t key;
+        void* image;  // fz_image*, kept until decoded
+    };
+
+    struct Decoded {
+        uint64_t key;
+        uint32_t width = 0, height = 0;
+        std::vector<std::vector<uint8_t>> levels;  // premultiplied RGBA8, level 0 first
+    };
+
+    enum class State : uint8_t { Queued, Ready, Failed };
+
+    struct Entry {
+        State state = State::Queued;
+        void* image = nullptr;  // fz_image*, compressed data kept for re-decoding
+        WGPUTexture texture = nullptr;
+        WGPUTextureView view = nullptr;
+        WGPUBindGroup bindGroup = nullptr;
+        size_t bytes = 0;        // texture memory
+        size_t sourceBytes = 0;  // compressed stream kept with the fz_image
+        uint32_t refs = 0;       // placements in layers' pages
+        uint64_t lastUsed = 0;
+    };
+
+    void workerLoop(void* workerCtx);
+    static Decoded decode(void* workerCtx, const Job& job);
+    void enqueue(uint64_t key, Entry& entry);
+
+    Result<void> createPipeline(WebGPUContext& ctx, WGPUTextureFormat format);
+    Result<void> upload(WebGPUContext& ctx, Entry& entry, const Decoded& pixels);
+    void releaseEntryGpu(Entry& entry);
+    void dropEntry(std::unordered_map<uint64_t, Entry>::iterator it);
+    void evict();
+
+    void* fzCtx_;  // fz_context* (main thread)
+
+    // Worker state
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+    std::vector<Decoded> done_;
+    bool stop_ = false;
+
+    std::unordered_map<uint64_t, Entry> entries_;
+    size_t totalBytes_ = 0;   // textures
+    size_t sourceBytes_ = 0;  // compressed images
+    uint64_t frame_ = 0;
+    const void* frameToken_ = nullptr;
+    std::unordered_set<const void*> frameLayers_;
+
+    // GPU state
+    WGPURenderPipeline pipeline_ = nullptr;
+    WGPUTextureFormat format_ = WGPUTextureFormat_Undefined;
+    WGPUBindGroupLayout uniformBgl_ = nullptr;
+    WGPUBindGroupLayout textureBgl_ = nullptr;
+    WGPUBindGroup uniformBindGroup_ = nullptr;
+    WGPUBuffer uniformBuffer_ = nullptr;
+    WGPUBuffer vertexBuffer_ = nullptr;
+    size_t vertexCapacity_ = 0;
+    WGPUSampler sampler_ = nullptr;
+};
+
+} // namespace yetty
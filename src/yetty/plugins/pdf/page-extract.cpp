@@ -0,0 +1,154 @@
+#include "page-extract.h"
+#include "perf-stages.h"
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <mupdf/fitz.h>
+}
+
+namespace yetty {
+
+Result<void> extractPDFPage(void* fzCtx, void* fzDoc, int pageNum, PDFExtractedPage& pdfPage,
+                            const PDFExtractSink& sink, void* fzCookie) {
+    PerfStages::Scope stage("pdf.extract");
+    fz_context* ctx = static_cast<fz_context*>(fzCtx);
+    fz_cookie* cookie = static_cast<fz_cookie*>(fzCookie);
+
+    fz_page* page = nullptr;
+    fz_stext_page* textPage = nullptr;
+    fz_device* textDev = nullptr;
+    fz_device* pathDev = nullptr;
+    fz_device* teeDev = nullptr;
+    fz_var(page);
+    fz_var(textPage);
+    fz_var(textDev);
+    fz_var(pathDev);
+    fz_var(teeDev);
+
+    pdfPage = PDFExtractedPage{};
+
+    fz_try(ctx) {
+        page = fz_load_page(ctx, static_cast<fz_document*>(fzDoc), pageNum);
+        fz_rect bounds = fz_bound_page(ctx, page);
+
+        pdfPage.width = bounds.x1 - bounds.x0;
+        pdfPage.height = bounds.y1 - bounds.y0;
+
+        // One interpretation of the page feeds both structured text (keeping
+        // image blocks) and the vector capture; the GPU redraws the paths at
+        // any zoom. Run through devices rather than fz_new_stext_page_from_page
+        // so the cookie applies
+        fz_stext_options opts = {0};
+        opts.flags = FZ_STEXT_PRESERVE_IMAGES;
+        textPage = fz_new_stext_page(ctx, bounds);
+        textDev = fz_new_stext_device(ctx, textPage, &opts);
+        pathDev = static_cast<fz_device*>(newVectorCaptureDevice(ctx, &pdfPage.vectors));
+        teeDev = fz_new_tee_device(ctx, textDev, pathDev);
+        fz_run_page(ctx, page, teeDev, fz_identity, cookie);
+        fz_close_device(ctx, teeDev);  // Closes both targets
+        if (cookie && cookie->abort) fz_throw(ctx, FZ_ERROR_ABORT, "page extraction cancelled");
+
+        for (fz_stext_block* block = textPage->first_block; block; block = block->next) {
+            if (block->type == FZ_STEXT_BLOCK_IMAGE) {
+                // Decoded off-thread; the unit square maps to the page through the transform
+                if (!sink.image || !block->u.i.image) continue;
+                PDFImageCache::Placement placement;
+                placement.key = sink.image(block->u.i.image);
+                const fz_point unit[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+                for (int i = 0; i < 4; i++) {
+                    fz_point p = fz_transform_point(unit[i], block->u.i.transform);
+                    placement.corners[i][0] = p.x;
+                    placement.corners[i][1] = p.y;
+                }
+                pdfPage.images.push_back(placement);
+                continue;
+            }
+            if (block->type != FZ_STEXT_BLOCK_TEXT) continue;
+
+            std::u32string paragraph;
+            for (fz_stext_line* line = block->u.t.first_line; line; line = line->next) {
+                // Join lines into one paragraph, undoing end-of-line hyphenation
+                if (!paragraph.empty()) {
+                    if (paragraph.back() == U'-') {
+                        paragraph.pop_back();
+                    } else if (paragraph.back() != U' ') {
+                        paragraph.push_back(U' ');
+                    }
+                }
+                for (fz_stext_char* ch = line->first_char; ch; ch = ch->next) {
+                    if (ch->c != '\n' && ch->c != '\r') {
+                        paragraph.push_back(static_cast<char32_t>(ch->c));
+                    }
+
+                    PDFExtractedChar textChar;
+                    textChar.codepoint = ch->c;
+                    textChar.x = ch->origin.x;
+                    textChar.y = ch->origin.y;
+                    textChar.size = ch->size;
+                    textChar.color = 0xFF000000;  // Default black
+
+                    // Register font and get family name
+                    if (ch->font) {
+                        if (sink.font) textChar.fontFamily = sink.font(ch->font);
+                        textChar.bold = fz_font_is_bold(ctx, ch->font);
+                        textChar.italic = fz_font_is_italic(ctx, ch->font);
+                    }
+
+                    pdfPage.chars.push_back(textChar);
+                }
+            }
+            if (!paragraph.empty()) {
+                pdfPage.paragraphs.push_back(std::move(paragraph));
+            }
+        }
+
+        spdlog::info("PDFLayer: extracted {} characters, {} paths and {} images from page {}",
+                     pdfPage.chars.size(), pdfPage.vectors.paths.size(),
+                     pdfPage.images.size(), pageNum);
+    }
+    fz_always(ctx) {
+        // The tee does not own its targets
+        fz_drop_device(ctx, teeDev);
+        fz_drop_device(ctx, pathDev);
+        fz_drop_device(ctx, textDev);
+        if (textPage) fz_drop_stext_page(ctx, textPage);
+        if (page) fz_drop_page(ctx, page);
+    }
+    fz_catch(ctx) {
+        return Err<void>(std::string("Failed to extract page content: ") + fz_caught_message(ctx));
+    }
+    return Ok();
+}
+
+TextChar toTextChar(const PDFExtractedChar& ch, float scale, float pageHeight,
+                    const std::unordered_set<std::string>* readyFonts) {
+    TextChar textChar;
+    textChar.codepoint = ch.codepoint;
+    // PDF has Y-up (origin at bottom-left), screen has Y-down (origin at top-left)
+    textChar.x = ch.x * scale;
+    textChar.y = (pageHeight - ch.y) * scale;
+    textChar.size = ch.size * scale;
+
+    // ARGB to RGBA; the theme is applied when compositing
+    float r = ((ch.color >> 16) & 0xFF) / 255.0f;
+    float g = ((ch.color >> 8) & 0xFF) / 255.0f;
+    float b = (ch.color & 0xFF) / 255.0f;
+    float a = ((ch.color >> 24) & 0xFF) / 255.0f;
+    textChar.color = glm::vec4(r, g, b, a);
+
+    // Fonts whose atlas is still pending draw with the fallback for now
+    if (!readyFonts || readyFonts->count(ch.fontFamily)) textChar.fontFamily = ch.fontFamily;
+
+    if (ch.bold && ch.italic) {
+        textChar.style = Font::BoldItalic;
+    } else if (ch.bold) {
+        textChar.style = Font::Bold;
+    } else if (ch.italic) {
+        textChar.style = Font::Italic;
+    } else {
+        textChar.style = Font::Regular;
+    }
+    return textChar;
+}
+
+} // namespace yetty
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "vector-paths.h"
+#include "image-cache.h"
+#include <yetty/plugin.h>
+#include <yetty/rich-text.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// PDF page extraction - text, paths and image placements of one page
+//-----------------------------------------------------------------------------
+// Used by PDFLayer on the main thread and on its prefetch worker, and by
+// yetty-plugins-bench, so the benchmarks measure the plugin's own code.
+//-----------------------------------------------------------------------------
+
+struct PDFExtractedChar {
+    uint32_t codepoint;
+    float x, y;              // PDF coordinates
+    float size;              // Font size in PDF points
+    uint32_t color;          // ARGB color
+    std::string fontFamily;  // Registered font family name
+    bool bold = false;
+    bool italic = false;
+};
+
+struct PDFExtractedPage {
+    float width, height;
+    std::vector<PDFExtractedChar> chars;
+    VectorPage vectors;  // Fill/stroke paths in PDF coordinates
+    std::vector<PDFImageCache::Placement> images;
+    std::vector<std::u32string> paragraphs;  // Text blocks in reading order
+};
+
+// Where extraction hands the fonts and images it meets: the layer registers
+// them directly, the prefetch worker collects them for the main thread. Unset
+// members skip the font name or the image placements.
+struct PDFExtractSink {
+    std::function<std::string(void* fzFont)> font;    // returns the family name
+    std::function<uint64_t(void* fzImage)> image;     // returns the placement key
+};
+
+// Extract one page with the calling thread's context (fz_context*) and
+// document (fz_document*). A set cookie (fz_cookie*) abort stops it.
+Result<void> extractPDFPage(void* ctx, void* doc, int pageNum, PDFExtractedPage& out,
+                            const PDFExtractSink& sink, void* cookie = nullptr);
+
+// RichText glyph for an extracted one at the given scale (pixels per point).
+// Families not in readyFonts (when given) draw with the fallback font.
+TextChar toTextChar(const PDFExtractedChar& ch, float scale, float pageHeight,
+                    const std::unordered_set<std::string>* readyFonts = nullptr);
+
+// Incremental RichText build: emits glyphs from cursor on until the deadline,
+// checking the clock every 256 glyphs. Returns true once the page is done.
+template <typename Emit>
+bool buildTextChars(const PDFExtractedPage& page, float scale,
+                    const std::unordered_set<std::string>* readyFonts, size_t& cursor,
+                    std::chrono::steady_clock::time_point deadline, Emit&& emit) {
+    while (cursor < page.chars.size()) {
+        if ((cursor % 256) == 0 && cursor > 0 && std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        const auto& ch = page.chars[cursor++];
+        if (ch.codepoint == '\n' || ch.codepoint == '\r') continue;
+        emit(toTextChar(ch, scale, page.height, readyFonts));
+    }
+    return true;
+}
+
+} // namespace yetty
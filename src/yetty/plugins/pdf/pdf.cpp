@@ -1,9 +1,16 @@
 #include "pdf.h"
+#include "perf-stages.h"
 #include <yetty/yetty.h>
 #include <yetty/webgpu-context.h>
 #include <yetty/font-manager.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
 #include <spdlog/spdlog.h>
 
 // FreeType for font access
@@ -22,6 +29,154 @@ extern "C" {
 
 namespace yetty {
 
+// How often the source file is checked for modification (seconds)
+static constexpr double WATCH_INTERVAL = 0.5;
+
+// Scroll prediction: pages are prefetched when their edge is expected within
+// the horizon (plus twice the measured extraction time)
+static constexpr double PREFETCH_HORIZON = 0.75;
+static constexpr float PREFETCH_MIN_VELOCITY = 50.0f;  // px/s
+static constexpr double SCROLL_VELOCITY_DECAY = 0.25;  // seconds
+
+// A page whose prefetch failed is retried after this, doubling up to the max
+static constexpr double PREFETCH_BACKOFF_MIN = 0.5;  // seconds
+static constexpr double PREFETCH_BACKOFF_MAX = 8.0;
+
+// Layers hidden this long drop everything but their path, page and view state
+static constexpr double COMPACT_AFTER = 2.0;
+
+// A compacted layer whose document cannot be reopened tries again after this
+static constexpr double EXPAND_RETRY = 1.0;  // seconds
+
+// Time per frame for glyph building
+static constexpr std::chrono::microseconds FRAME_WORK_BUDGET{4000};
+
+static uint64_t fnv1a64(const unsigned char* data, size_t len,
+                        uint64_t hash = 0xcbf29ce484222325ull) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t hashStreamObject(fz_context* ctx, pdf_obj* obj, uint64_t hash) {
+    fz_buffer* buf = nullptr;
+    fz_var(buf);
+    fz_try(ctx) {
+        // Undecoded bytes change whenever the decoded ones do, without the decode
+        buf = pdf_load_raw_stream(ctx, obj);
+        unsigned char* data = nullptr;
+        size_t len = fz_buffer_storage(ctx, buf, &data);
+        hash = fnv1a64(data, len, hash);
+    }
+    fz_always(ctx) { fz_drop_buffer(ctx, buf); }
+    fz_catch(ctx) { fz_rethrow(ctx); }
+    return hash;
+}
+
+// Hashes an object and everything it references: dictionaries, arrays and
+// stream contents, following indirect references once each. Needed because a
+// rebuilt file can change a font or XObject stream while the page dictionary
+// still prints the same "12 0 R".
+static uint64_t hashObjectGraph(fz_context* ctx, pdf_obj* obj, std::unordered_set<int>& visited,
+                                uint64_t hash) {
+    auto mix = [&hash](const void* data, size_t len) {
+        hash = fnv1a64(static_cast<const unsigned char*>(data), len, hash);
+    };
+
+    pdf_obj* ref = obj;  // stream loading needs the reference, not the resolved dict
+    if (pdf_is_indirect(ctx, obj)) {
+        int num = pdf_to_num(ctx, obj);
+        mix("R", 1);
+        mix(&num, sizeof(num));
+        if (!visited.insert(num).second) return hash;
+        obj = pdf_resolve_indirect(ctx, obj);
+    }
+
+    if (pdf_is_dict(ctx, obj)) {
+        int n = pdf_dict_len(ctx, obj);
+        for (int i = 0; i < n; i++) {
+            pdf_obj* key = pdf_dict_get_key(ctx, obj, i);
+            // Back-pointers would pull in the whole page tree
+            if (pdf_name_eq(ctx, key, PDF_NAME(Parent))) continue;
+            const char* name = pdf_to_name(ctx, key);
+            mix(name, std::strlen(name) + 1);
+            hash = hashObjectGraph(ctx, pdf_dict_get_val(ctx, obj, i), visited, hash);
+        }
+        if (pdf_is_stream(ctx, ref)) hash = hashStreamObject(ctx, ref, hash);
+    } else if (pdf_is_array(ctx, obj)) {
+        int n = pdf_array_len(ctx, obj);
+        mix("[", 1);
+        for (int i = 0; i < n; i++) {
+            hash = hashObjectGraph(ctx, pdf_array_get(ctx, obj, i), visited, hash);
+        }
+    } else if (pdf_is_name(ctx, obj)) {
+        const char* name = pdf_to_name(ctx, obj);
+        mix("/", 1);
+        mix(name, std::strlen(name));
+    } else if (pdf_is_string(ctx, obj)) {
+        mix("(", 1);
+        mix(pdf_to_str_buf(ctx, obj), pdf_to_str_len(ctx, obj));
+    } else if (pdf_is_int(ctx, obj)) {
+        int64_t v = pdf_to_int64(ctx, obj);
+        mix(&v, sizeof(v));
+    } else if (pdf_is_real(ctx, obj)) {
+        float v = pdf_to_real(ctx, obj);
+        mix(&v, sizeof(v));
+    } else if (pdf_is_bool(ctx, obj)) {
+        mix(pdf_to_bool(ctx, obj) ? "t" : "f", 1);
+    } else {
+        mix("n", 1);
+    }
+    return hash;
+}
+
+// MuPDF locking, required to clone the context for the image decode worker
+static std::mutex s_fzMutexes[FZ_LOCK_MAX];
+
+static void fzLock(void*, int lock) { s_fzMutexes[lock].lock(); }
+static void fzUnlock(void*, int lock) { s_fzMutexes[lock].unlock(); }
+
+static fz_locks_context s_fzLocks = {nullptr, fzLock, fzUnlock};
+
+// MuPDF heap accounting for the memory report: documents, object caches and
+// the store all allocate through here. Each block starts with its size.
+static std::atomic<size_t> s_fzHeapBytes{0};
+static constexpr size_t FZ_BLOCK_HEADER = alignof(std::max_align_t);
+
+static void* fzMalloc(void*, size_t size) {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + FZ_BLOCK_HEADER));
+    if (!block) return nullptr;
+    std::memcpy(block, &size, sizeof(size));
+    s_fzHeapBytes.fetch_add(size, std::memory_order_relaxed);
+    return block + FZ_BLOCK_HEADER;
+}
+
+static void fzFree(void*, void* ptr) {
+    if (!ptr) return;
+    auto* block = static_cast<unsigned char*>(ptr) - FZ_BLOCK_HEADER;
+    size_t size = 0;
+    std::memcpy(&size, block, sizeof(size));
+    s_fzHeapBytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+static void* fzRealloc(void* opaque, void* ptr, size_t size) {
+    if (!ptr) return fzMalloc(opaque, size);
+    auto* block = static_cast<unsigned char*>(ptr) - FZ_BLOCK_HEADER;
+    size_t oldSize = 0;
+    std::memcpy(&oldSize, block, sizeof(oldSize));
+    auto* grown = static_cast<unsigned char*>(std::realloc(block, size + FZ_BLOCK_HEADER));
+    if (!grown) return nullptr;
+    std::memcpy(grown, &size, sizeof(size));
+    s_fzHeapBytes.fetch_add(size, std::memory_order_relaxed);
+    s_fzHeapBytes.fetch_sub(oldSize, std::memory_order_relaxed);
+    return grown + FZ_BLOCK_HEADER;
+}
+
+static fz_alloc_context s_fzAlloc = {nullptr, fzMalloc, fzRealloc, fzFree};
+
 //-----------------------------------------------------------------------------
 // PDFPlugin
 //-----------------------------------------------------------------------------
@@ -43,7 +198,7 @@ Result<void> PDFPlugin::init() noexcept {
     }
 
     // Create MuPDF context
-    fz_context* mctx = fz_new_context(nullptr, nullptr, FZ_STORE_UNLIMITED);
+    fz_context* mctx = fz_new_context(&s_fzAlloc, &s_fzLocks, FZ_STORE_UNLIMITED);
     if (!mctx) {
         return Err<void>("Failed to create MuPDF context");
     }
@@ -57,12 +212,17 @@ Result<void> PDFPlugin::init() noexcept {
         return Err<void>("Failed to register MuPDF document handlers");
     }
 
+    imageCache_ = std::make_unique<PDFImageCache>(fzCtx_);
+
     _initialized = true;
     spdlog::info("PDFPlugin initialized (using RichText for rendering)");
     return Ok();
 }
 
 Result<void> PDFPlugin::dispose() {
+    // Stops the decode worker, which holds a clone of the context
+    imageCache_.reset();
+
     if (fzCtx_) {
         fz_drop_context(static_cast<fz_context*>(fzCtx_));
         fzCtx_ = nullptr;
@@ -75,6 +235,10 @@ Result<void> PDFPlugin::dispose() {
     return Ok();
 }
 
+size_t PDFPlugin::mupdfHeapBytes() {
+    return s_fzHeapBytes.load(std::memory_order_relaxed);
+}
+
 FontManager* PDFPlugin::getFontManager() {
     return engine_ ? engine_->fontManager().get() : nullptr;
 }
@@ -109,20 +273,73 @@ Result<void> PDFLayer::init(const std::string& payload) {
 }
 
 Result<void> PDFLayer::dispose() {
+    // The worker reads path_ and clones of the context; stop it first
+    stopPrefetchWorker();
+    stopAtlasWorker();
     if (doc_) {
         fz_drop_document(MCTX, MDOC);
         doc_ = nullptr;
     }
 
-    if (richText_) {
-        richText_->dispose();
-        richText_.reset();
+    for (auto* slot : {&richText_, &richTextBack_}) {
+        if (*slot) {
+            (*slot)->dispose();
+            slot->reset();
+        }
     }
-
+    building_ = false;
+    frontHasContent_ = false;
+
+    vectorRenderer_.setPage(nullptr);
+    vectorRenderer_.dispose();
+    colorTransform_.dispose();
+    cancelPrefetch();
+    for (auto& page : pages_) releaseImages(page);
     pages_.clear();
+
+    // Back to a freshly constructed layer, so init() can load another document
+    pageCount_ = 0;
+    currentPage_ = 0;
+    zoom_ = 1.0f;
+    path_.clear();
+    lastWriteTime_ = {};
+    lastFileSize_ = 0;
+    changePending_ = false;
+    watchTimer_ = 0.0;
+    currentPageHash_ = 0;
+
+    compact_ = false;
+    hiddenSeconds_ = 0.0;
+    expandRetryAt_ = {};
+
+    scroll_ = ScrollPredictor{};
+    prefetchFailedPage_ = -1;
+    prefetchBackoff_ = 0.0;
+    prefetchRetryAt_ = {};
+    extractSeconds_ = 0.0;
+    scrollToEnd_ = false;
+
     fontNameMap_.clear();
+    pendingFonts_.clear();
+    fontsByHash_.clear();
+    readyFonts_.clear();
+    fontsRefined_ = false;
+
+    frontScale_ = 0.0f;
+    frontChars_ = 0;
+    backChars_ = 0;
+    buildCursor_ = 0;
+    buildScale_ = 0.0f;
+    buildHeight_ = 0.0f;
+    documentHeight_ = 0.0f;
+    scrollOffset_ = 0.0f;
+    reflow_ = false;
+    reflowCache_.clear();
+
     initialized_ = false;
     failed_ = false;
+    lastViewWidth_ = 0.0f;
+    lastViewHeight_ = 0.0f;
     return Ok();
 }
 
@@ -137,6 +354,7 @@ Result<void> PDFLayer::loadPDF(const std::string& path) {
 
     fz_try(MCTX) { doc_ = fz_open_document(MCTX, path.c_str()); }
     fz_catch(MCTX) { return Err<void>("Failed to open PDF: " + path); }
+    docGeneration_++;
 
     pageCount_ = fz_count_pages(MCTX, MDOC);
     if (pageCount_ <= 0) {
@@ -145,6 +363,13 @@ Result<void> PDFLayer::loadPDF(const std::string& path) {
 
     spdlog::info("PDFLayer: loaded {} with {} pages", path, pageCount_);
 
+    // Remember file state for live reload
+    path_ = path;
+    std::error_code ec;
+    lastWriteTime_ = std::filesystem::last_write_time(path, ec);
+    lastFileSize_ = std::filesystem::file_size(path, ec);
+    changePending_ = false;
+
     // Extract first page content
     return extractPageContent(0);
 }
@@ -181,37 +406,121 @@ std::string PDFLayer::registerFont(void* fzFont) {
         return "";
     }
 
+    // Same font bytes seen before (e.g. in a previous build of this file) - reuse its atlas
+    uint64_t fontHash = fnv1a64(fontData, fontDataLen);
+    if (auto known = fontsByHash_.find(fontHash); known != fontsByHash_.end()) {
+        fontNameMap_[fzFont] = known->second;
+        return known->second;
+    }
+
     // Store the font name and data for later atlas generation
     fontNameMap_[fzFont] = fontName;
+    fontsByHash_[fontHash] = fontName;
     PendingFont pf;
     pf.data.assign(fontData, fontData + fontDataLen);
     pf.name = fontName;
-    pendingFonts_[fzFont] = std::move(pf);
+    pf.hash = fontHash;
+    pendingFonts_[fontHash] = std::move(pf);
 
     spdlog::debug("PDFLayer: collected font '{}' ({} bytes)", fontName, fontDataLen);
     return fontName;
 }
 
-Result<void> PDFLayer::generateFontAtlases() {
-    auto fontMgr = plugin_->getFontManager();
-    if (!fontMgr) {
-        return Err<void>("No FontManager available");
+void PDFLayer::queueFontAtlases() {
+    if (pendingFonts_.empty()) return;
+
+    if (!startAtlasWorker()) {
+        // No FontManager: everything renders with the fallback
+        for (const auto& [hash, pending] : pendingFonts_) fontsByHash_[hash] = "";
+        pendingFonts_.clear();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(atlasMutex_);
+        for (auto& [hash, pending] : pendingFonts_) atlasJobs_.push_back(std::move(pending));
+    }
+    atlasInFlight_ += pendingFonts_.size();
+    pendingFonts_.clear();
+    atlasCv_.notify_one();
+}
+
+void PDFLayer::pollFontAtlases() {
+    std::vector<AtlasResult> done;
+    {
+        std::lock_guard<std::mutex> lock(atlasMutex_);
+        done.swap(atlasDone_);
     }
 
-    for (auto& [fzFont, pendingFont] : pendingFonts_) {
-        spdlog::info("PDFLayer: generating atlas for font '{}'", pendingFont.name);
-        auto result = fontMgr->getFont(pendingFont.data.data(), pendingFont.data.size(),
-                                        pendingFont.name, 32.0f);
-        if (!result || !*result) {
-            spdlog::warn("PDFLayer: failed to generate atlas for font '{}': {}", pendingFont.name,
-                         result ? "null font" : result.error().message());
+    for (const auto& result : done) {
+        atlasInFlight_ -= std::min(atlasInFlight_, size_t(1));
+        if (result.ok) {
+            readyFonts_.insert(result.name);
+            fontsRefined_ = true;
+        } else {
+            spdlog::warn("PDFLayer: failed to generate atlas for font '{}': {}", result.name,
+                         result.error);
             // Mark as failed - will use fallback
-            fontNameMap_[fzFont] = "";
+            fontsByHash_[result.hash] = "";
         }
     }
+}
 
-    pendingFonts_.clear();
-    return Ok();
+bool PDFLayer::startAtlasWorker() {
+    if (atlasThread_.joinable()) return true;
+
+    FontManager* fontMgr = plugin_->getFontManager();
+    if (!fontMgr) return false;
+
+    atlasStop_ = false;
+    atlasThread_ = std::thread(&PDFLayer::atlasLoop, this, fontMgr);
+    return true;
+}
+
+void PDFLayer::stopAtlasWorker() {
+    if (!atlasThread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(atlasMutex_);
+        atlasStop_ = true;
+    }
+    atlasCv_.notify_one();
+    // MSDF generation cannot be interrupted; at most the running font finishes
+    atlasThread_.join();
+
+    pollFontAtlases();
+
+    // Fonts that never got an atlas are forgotten so the next extraction queues them again
+    for (const auto& pending : atlasJobs_) fontsByHash_.erase(pending.hash);
+    atlasJobs_.clear();
+    atlasInFlight_ = 0;
+}
+
+void PDFLayer::atlasLoop(FontManager* fontMgr) {
+    for (;;) {
+        PendingFont font;
+        {
+            std::unique_lock<std::mutex> lock(atlasMutex_);
+            atlasCv_.wait(lock, [this] { return atlasStop_ || !atlasJobs_.empty(); });
+            if (atlasStop_) break;
+            font = std::move(atlasJobs_.front());
+            atlasJobs_.pop_front();
+        }
+
+        AtlasResult result;
+        result.hash = font.hash;
+        result.name = font.name;
+        {
+            // Layers keep showing their last frame while this is held
+            std::lock_guard<std::mutex> fontLock(plugin_->fontMutex());
+            spdlog::info("PDFLayer: generating atlas for font '{}'", font.name);
+            auto atlas = fontMgr->getFont(font.data.data(), font.data.size(), font.name, 32.0f);
+            result.ok = atlas && *atlas;
+            if (!result.ok) result.error = atlas ? "null font" : atlas.error().message();
+        }
+
+        std::lock_guard<std::mutex> lock(atlasMutex_);
+        atlasDone_.push_back(std::move(result));
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -223,137 +532,765 @@ Result<void> PDFLayer::extractPageContent(int pageNum) {
         return Err<void>("Invalid page number");
     }
 
+    // Use the prefetched page if the scroll predictor already extracted it
+    ExtractedPage pdfPage;
+    uint64_t hash = 0;
+    if (prefetch_.page == pageNum && prefetch_.ready) {
+        pdfPage = std::move(prefetch_.data);
+        hash = prefetch_.hash;
+        spdlog::debug("PDFLayer: page {} served from prefetch", pageNum);
+    } else {
+        hash = hashPage(pageNum);
+        if (auto res = extractPage(pageNum, pdfPage); !res) {
+            return res;
+        }
+    }
+    cancelPrefetch();
+
     currentPage_ = pageNum;
+    currentPageHash_ = hash;
+    vectorRenderer_.setPage(nullptr);
+    for (auto& page : pages_) releaseImages(page);
     pages_.clear();
+    pages_.push_back(std::move(pdfPage));
+    vectorRenderer_.setPage(&pages_[0].vectors);
 
-    fz_page* page = nullptr;
-    fz_stext_page* textPage = nullptr;
+    // Force re-layout
+    reflowCache_.clear();
+    lastViewWidth_ = 0;
+    lastViewHeight_ = 0;
+    if (richText_) {
+        richText_->clear();
+        frontChars_ = 0;
+        frontHasContent_ = false;
+    }
 
-    fz_try(MCTX) {
-        page = fz_load_page(MCTX, MDOC, pageNum);
-        fz_rect bounds = fz_bound_page(MCTX, page);
-
-        ExtractedPage pdfPage;
-        pdfPage.width = bounds.x1 - bounds.x0;
-        pdfPage.height = bounds.y1 - bounds.y0;
-
-        // Extract text using structured text
-        fz_stext_options opts = {0};
-        textPage = fz_new_stext_page_from_page(MCTX, page, &opts);
-
-        for (fz_stext_block* block = textPage->first_block; block; block = block->next) {
-            if (block->type != FZ_STEXT_BLOCK_TEXT) continue;
-
-            for (fz_stext_line* line = block->u.t.first_line; line; line = line->next) {
-                for (fz_stext_char* ch = line->first_char; ch; ch = ch->next) {
-                    ExtractedChar textChar;
-                    textChar.codepoint = ch->c;
-                    textChar.x = ch->origin.x;
-                    textChar.y = ch->origin.y;
-                    textChar.size = ch->size;
-                    textChar.color = 0xFF000000;  // Default black
-
-                    // Register font and get family name
-                    if (ch->font) {
-                        textChar.fontFamily = registerFont(ch->font);
-                        textChar.bold = fz_font_is_bold(MCTX, ch->font);
-                        textChar.italic = fz_font_is_italic(MCTX, ch->font);
-                    }
+    return Ok();
+}
+
+Result<void> PDFLayer::extractPage(int pageNum, ExtractedPage& pdfPage) {
+    auto started = std::chrono::steady_clock::now();
+
+    ExtractSink sink;
+    sink.font = [this](void* fzFont) { return registerFont(fzFont); };
+    sink.image = [this](void* fzImage) -> uint64_t {
+        auto* cache = plugin_->imageCache();
+        return cache ? cache->request(fzImage) : 0;
+    };
+    if (auto res = extractPDFPage(mupdfCtx_, doc_, pageNum, pdfPage, sink); !res) {
+        releaseImages(pdfPage);
+        return res;
+    }
+
+    // Running average of the extraction cost sizes the prefetch horizon
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    extractSeconds_ = extractSeconds_ > 0.0 ? extractSeconds_ * 0.7 + elapsed * 0.3 : elapsed;
+    return Ok();
+}
+
+//-----------------------------------------------------------------------------
+// Scroll Prediction / Prefetch
+//-----------------------------------------------------------------------------
+
+void PDFLayer::ScrollPredictor::onScroll(float deltaPx) {
+    auto now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(now - lastEvent).count();
+    lastEvent = now;
+
+    // A burst after a pause, or a reversal, starts a fresh estimate
+    dt = std::clamp(dt, 1.0 / 120.0, 0.25);
+    float instant = static_cast<float>(deltaPx / dt);
+    if (velocity == 0.0f || (instant > 0.0f) != (velocity > 0.0f)) {
+        velocity = instant;
+    } else {
+        velocity = velocity * 0.4f + instant * 0.6f;
+    }
+}
+
+void PDFLayer::ScrollPredictor::decay(double dt) {
+    double idle = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastEvent).count();
+    if (idle < 0.05) return;
+    velocity *= static_cast<float>(std::exp(-dt / SCROLL_VELOCITY_DECAY));
+    if (std::fabs(velocity) < PREFETCH_MIN_VELOCITY) velocity = 0.0f;
+}
+
+void PDFLayer::turnPage(int pageNum, bool toEnd) {
+    if (pageNum < 0 || pageNum >= pageCount_ || pageNum == turnPage_) return;
+
+    // Turned back before the pending page arrived
+    if (pageNum == currentPage_) {
+        cancelPrefetch();
+        scrollOffset_ = 0;
+        scrollToEnd_ = toEnd;
+        return;
+    }
+
+    // Already extracted ahead, or no worker to hand it to
+    if ((prefetch_.page == pageNum && prefetch_.ready) || !startPrefetchWorker()) {
+        showPage(pageNum, toEnd);
+        return;
+    }
+
+    // The speculative job, if it is for another page, gives way
+    if (prefetch_.page != pageNum) submitPrefetch(pageNum);
+    turnPage_ = pageNum;
+    turnToEnd_ = toEnd;
+    spdlog::debug("PDFLayer: page {} not prefetched, extracting on the worker", pageNum);
+}
+
+void PDFLayer::showPage(int pageNum, bool toEnd) {
+    if (auto res = extractPageContent(pageNum); !res) {
+        spdlog::warn("PDFLayer: cannot show page {}: {}", pageNum + 1, res.error().message());
+        return;
+    }
+    scrollOffset_ = 0;
+    scrollToEnd_ = toEnd;
+}
+
+void PDFLayer::schedulePrefetch(float viewHeight) {
+    // The page turned to is being extracted; nothing may replace that job
+    if (turnPage_ >= 0) return;
+
+    float v = scroll_.velocity;
+
+    // Work for the page behind us is useless once the direction flips
+    if (prefetch_.page >= 0 && ((prefetch_.page > currentPage_) != (v > 0.0f)) && v != 0.0f) {
+        spdlog::debug("PDFLayer: scroll reversed, dropping prefetch of page {}", prefetch_.page);
+        cancelPrefetch();
+    }
+    if (std::fabs(v) < PREFETCH_MIN_VELOCITY || reflow_) return;
+
+    int target = currentPage_ + (v > 0.0f ? 1 : -1);
+    if (target < 0 || target >= pageCount_ || target == prefetch_.page) return;
+    if (target == prefetchFailedPage_ && std::chrono::steady_clock::now() < prefetchRetryAt_) return;
+
+    // Expected time until the page edge scrolls into view
+    float maxScroll = std::max(0.0f, documentHeight_ - viewHeight);
+    float distance = v > 0.0f ? maxScroll - scrollOffset_ : scrollOffset_;
+    double eta = std::max(0.0f, distance) / std::fabs(v);
+    if (eta > PREFETCH_HORIZON + 2.0 * extractSeconds_) return;
+
+    if (!startPrefetchWorker()) return;
+    submitPrefetch(target);
+    spdlog::debug("PDFLayer: prefetching page {} (eta {:.2f}s at {:.0f}px/s)", target, eta, v);
+}
+
+void PDFLayer::submitPrefetch(int pageNum) {
+    cancelPrefetch();
+
+    PrefetchJob job;
+    job.serial = ++prefetchSerial_;
+    job.page = pageNum;
+    job.path = path_;
+    job.docGeneration = docGeneration_;
+    job.knownFonts = fontsByHash_;
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        prefetchJobs_.clear();
+        prefetchJobs_.push_back(std::move(job));
+    }
+    prefetchCv_.notify_one();
+
+    prefetch_.page = pageNum;
+    prefetch_.serial = prefetchSerial_;
+}
+
+void PDFLayer::pollPrefetch() {
+    std::vector<PrefetchResult> done;
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        done.swap(prefetchDone_);
+    }
 
-                    pdfPage.chars.push_back(textChar);
+    for (auto& result : done) {
+        // Results of cancelled jobs, including ones that finished anyway
+        if (result.serial != prefetch_.serial || prefetch_.page < 0) {
+            dropPrefetchResult(result);
+            continue;
+        }
+
+        extractSeconds_ = extractSeconds_ > 0.0 ? extractSeconds_ * 0.7 + result.seconds * 0.3
+                                                : result.seconds;
+        if (!result.ok) {
+            int page = prefetch_.page;
+            prefetchBackoff_ = page == prefetchFailedPage_
+                ? std::min(prefetchBackoff_ * 2.0, PREFETCH_BACKOFF_MAX)
+                : PREFETCH_BACKOFF_MIN;
+            prefetchFailedPage_ = page;
+            prefetchRetryAt_ = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(prefetchBackoff_));
+            spdlog::debug("PDFLayer: prefetch of page {} failed, retrying in {:.1f}s: {}", page,
+                          prefetchBackoff_, result.error);
+            if (page == turnPage_) {
+                spdlog::warn("PDFLayer: cannot show page {}: {}", page + 1, result.error);
+            }
+            dropPrefetchResult(result);
+            cancelPrefetch();
+            continue;
+        }
+
+        if (prefetch_.page == prefetchFailedPage_) prefetchFailedPage_ = -1;
+        adoptPrefetch(result);
+        spdlog::debug("PDFLayer: prefetched page {} in {:.1f}ms", prefetch_.page, result.seconds * 1000.0);
+
+        if (prefetch_.page == turnPage_) {
+            int page = turnPage_;
+            turnPage_ = -1;
+            showPage(page, turnToEnd_);
+        }
+    }
+}
+
+void PDFLayer::adoptPrefetch(PrefetchResult& result) {
+    fz_context* ctx = MCTX;
+
+    // The worker saw these fonts for the first time; queue their atlases unless
+    // an extraction on this thread got there meanwhile
+    for (auto& font : result.fonts) {
+        if (fontsByHash_.count(font.hash)) continue;
+        fontsByHash_[font.hash] = font.name;
+        uint64_t hash = font.hash;
+        pendingFonts_[hash] = std::move(font);
+    }
+
+    // Placements carry indices into the worker's image list until the cache
+    // hands out keys; the cache keeps its own reference
+    auto* cache = plugin_->imageCache();
+    std::vector<PDFImageCache::Placement> placements;
+    placements.reserve(result.data.images.size());
+    for (auto placement : result.data.images) {
+        if (!cache || placement.key >= result.images.size()) continue;
+        placement.key = cache->request(result.images[placement.key]);
+        placements.push_back(placement);
+    }
+    result.data.images = std::move(placements);
+    for (void* image : result.images) fz_drop_image(ctx, static_cast<fz_image*>(image));
+    result.images.clear();
+
+    prefetch_.ready = true;
+    prefetch_.hash = result.hash;
+    prefetch_.data = std::move(result.data);
+}
+
+void PDFLayer::dropPrefetchResult(PrefetchResult& result) {
+    for (void* image : result.images) fz_drop_image(MCTX, static_cast<fz_image*>(image));
+    result.images.clear();
+}
+
+void PDFLayer::cancelPrefetch() {
+    // Queued work is dropped; running work is stopped through the cookie and
+    // its result ignored by serial
+    if (prefetchThread_.joinable() && prefetch_.page >= 0 && !prefetch_.ready) {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        prefetchJobs_.clear();
+        static_cast<fz_cookie*>(prefetchCookie_)->abort = 1;
+    }
+    releaseImages(prefetch_.data);
+    turnPage_ = -1;
+    prefetch_.page = -1;
+    prefetch_.serial = 0;
+    prefetch_.ready = false;
+    prefetch_.hash = 0;
+    prefetch_.data = ExtractedPage{};
+}
+
+bool PDFLayer::startPrefetchWorker() {
+    if (prefetchThread_.joinable()) return true;
+    if (prefetchUnavailable_) return false;
+
+    fz_context* workerCtx = fz_clone_context(MCTX);
+    if (!workerCtx) {
+        spdlog::warn("PDFLayer: cannot clone MuPDF context, prefetch disabled");
+        prefetchUnavailable_ = true;
+        return false;
+    }
+    prefetchCookie_ = new fz_cookie{};
+    prefetchStop_ = false;
+    prefetchThread_ = std::thread(&PDFLayer::prefetchLoop, this, workerCtx);
+    return true;
+}
+
+void PDFLayer::stopPrefetchWorker() {
+    if (!prefetchThread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        prefetchStop_ = true;
+        prefetchJobs_.clear();
+        static_cast<fz_cookie*>(prefetchCookie_)->abort = 1;
+    }
+    prefetchCv_.notify_one();
+    prefetchThread_.join();
+
+    for (auto& result : prefetchDone_) dropPrefetchResult(result);
+    prefetchDone_.clear();
+    delete static_cast<fz_cookie*>(prefetchCookie_);
+    prefetchCookie_ = nullptr;
+}
+
+void PDFLayer::prefetchLoop(void* workerCtx) {
+    fz_context* ctx = static_cast<fz_context*>(workerCtx);
+    fz_cookie* cookie = static_cast<fz_cookie*>(prefetchCookie_);
+    fz_document* doc = nullptr;
+    uint64_t docGeneration = 0;
+
+    for (;;) {
+        PrefetchJob job;
+        {
+            std::unique_lock<std::mutex> lock(prefetchMutex_);
+            prefetchCv_.wait(lock, [this] { return prefetchStop_ || !prefetchJobs_.empty(); });
+            if (prefetchStop_) break;
+            job = std::move(prefetchJobs_.back());
+            prefetchJobs_.clear();
+            *cookie = fz_cookie{};
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        PrefetchResult result;
+        result.serial = job.serial;
+
+        // Documents are not shared between threads; this one follows the
+        // layer's through reloads
+        if (!doc || docGeneration != job.docGeneration) {
+            fz_drop_document(ctx, doc);
+            doc = nullptr;
+            fz_try(ctx) { doc = fz_open_document(ctx, job.path.c_str()); }
+            fz_catch(ctx) { doc = nullptr; }
+            docGeneration = job.docGeneration;
+        }
+
+        if (!doc) {
+            result.error = "cannot open " + job.path;
+        } else {
+            result.hash = hashPage(ctx, doc, job.page);
+
+            std::unordered_map<void*, std::string> names;  // fz_font* -> family, this job
+            ExtractSink sink;
+            sink.font = [&](void* fzFont) -> std::string {
+                if (auto it = names.find(fzFont); it != names.end()) return it->second;
+                fz_font* font = static_cast<fz_font*>(fzFont);
+                std::string& family = names[fzFont];
+                if (!font->buffer) return family;
+
+                unsigned char* data = nullptr;
+                size_t len = fz_buffer_storage(ctx, font->buffer, &data);
+                if (!data || len == 0) return family;
+                uint64_t hash = fnv1a64(data, len);
+                if (auto known = job.knownFonts.find(hash); known != job.knownFonts.end()) {
+                    family = known->second;
+                    return family;
                 }
+                family = fz_font_name(ctx, font);
+                job.knownFonts[hash] = family;
+                PendingFont pf;
+                pf.data.assign(data, data + len);
+                pf.name = family;
+                pf.hash = hash;
+                result.fonts.push_back(std::move(pf));
+                return family;
+            };
+            sink.image = [&](void* fzImage) -> uint64_t {
+                result.images.push_back(fz_keep_image(ctx, static_cast<fz_image*>(fzImage)));
+                return result.images.size() - 1;
+            };
+
+            if (auto res = extractPDFPage(ctx, doc, job.page, result.data, sink, cookie); res) {
+                result.ok = true;
+            } else {
+                result.error = res.error().message();
             }
         }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        if (!result.ok || cookie->abort) {
+            // Cancelled or failed: nothing in it is worth handing over
+            for (void* image : result.images) fz_drop_image(ctx, static_cast<fz_image*>(image));
+            result.images.clear();
+            result.data = ExtractedPage{};
+            result.fonts.clear();
+            if (cookie->abort) result.ok = false;
+        }
 
-        pages_.push_back(std::move(pdfPage));
-        spdlog::info("PDFLayer: extracted {} characters from page {}",
-                     pages_[0].chars.size(), pageNum);
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        prefetchDone_.push_back(std::move(result));
+    }
 
-        // Generate font atlases AFTER extraction but still inside fz_try
-        // This matches pdf-old's approach
-        if (auto res = generateFontAtlases(); !res) {
-            spdlog::warn("PDFLayer: font atlas generation failed: {}", res.error().message());
+    fz_drop_document(ctx, doc);
+    fz_drop_context(ctx);
+}
+
+void PDFLayer::releaseImages(ExtractedPage& page) {
+    // Placements hold references into the shared cache
+    if (auto* cache = plugin_->imageCache(); cache && !page.images.empty()) {
+        cache->release(page.images);
+    }
+    page.images.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Live Reload
+//-----------------------------------------------------------------------------
+
+uint64_t PDFLayer::hashPage(void* fzCtx, void* fzDoc, int pageNum) {
+    fz_context* ctx = static_cast<fz_context*>(fzCtx);
+
+    // Only PDF documents expose their content streams
+    pdf_document* pdoc = pdf_specifics(ctx, static_cast<fz_document*>(fzDoc));
+    if (!pdoc) return 0;
+
+    uint64_t hash = fnv1a64(nullptr, 0);
+    fz_try(ctx) {
+        pdf_obj* pageObj = pdf_lookup_page_obj(ctx, pdoc, pageNum);
+
+        // Content streams, everything the resources reference (fonts, XObjects
+        // and their own resources, patterns, shadings), annotations and the
+        // boxes that affect layout. Shared objects are hashed once.
+        std::unordered_set<int> visited;
+        hash = hashObjectGraph(ctx, pdf_dict_get(ctx, pageObj, PDF_NAME(Contents)), visited, hash);
+        hash = hashObjectGraph(ctx, pdf_dict_get_inheritable(ctx, pageObj, PDF_NAME(Resources)),
+                               visited, hash);
+        hash = hashObjectGraph(ctx, pdf_dict_get(ctx, pageObj, PDF_NAME(Annots)), visited, hash);
+        hash = hashObjectGraph(ctx, pdf_dict_get_inheritable(ctx, pageObj, PDF_NAME(MediaBox)),
+                               visited, hash);
+        hash = hashObjectGraph(ctx, pdf_dict_get_inheritable(ctx, pageObj, PDF_NAME(CropBox)),
+                               visited, hash);
+        hash = hashObjectGraph(ctx, pdf_dict_get_inheritable(ctx, pageObj, PDF_NAME(Rotate)),
+                               visited, hash);
+    }
+    fz_catch(ctx) { hash = 0; }
+
+    return hash;
+}
+
+void PDFLayer::pollFileChange(double deltaTime) {
+    if (path_.empty()) return;
+
+    watchTimer_ += deltaTime;
+    if (watchTimer_ < WATCH_INTERVAL) return;
+    watchTimer_ = 0.0;
+
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(path_, ec);
+    if (ec) return;  // File is being replaced
+    auto size = std::filesystem::file_size(path_, ec);
+    if (ec) return;
+
+    if (writeTime != lastWriteTime_ || size != lastFileSize_) {
+        // Wait for one quiet interval so we don't read a half-written file
+        lastWriteTime_ = writeTime;
+        lastFileSize_ = size;
+        changePending_ = true;
+        return;
+    }
+
+    if (changePending_) {
+        changePending_ = false;
+        if (auto res = reloadPDF(); !res) {
+            spdlog::warn("PDFLayer: reload failed: {}", res.error().message());
         }
     }
-    fz_always(MCTX) {
-        if (textPage) fz_drop_stext_page(MCTX, textPage);
-        if (page) fz_drop_page(MCTX, page);
+}
+
+Result<void> PDFLayer::reloadPDF() {
+    fz_document* newDoc = nullptr;
+    int newCount = 0;
+    fz_var(newDoc);
+
+    fz_try(MCTX) {
+        newDoc = fz_open_document(MCTX, path_.c_str());
+        newCount = fz_count_pages(MCTX, newDoc);
+    }
+    fz_catch(MCTX) {
+        fz_drop_document(MCTX, newDoc);
+        return Err<void>("Failed to reopen PDF: " + path_);
+    }
+    if (newCount <= 0) {
+        fz_drop_document(MCTX, newDoc);
+        return Err<void>("Reloaded PDF has no pages");
     }
-    fz_catch(MCTX) { return Err<void>("Failed to extract page content"); }
 
-    // Force re-layout
-    lastViewWidth_ = 0;
-    lastViewHeight_ = 0;
-    if (richText_) {
-        richText_->clear();
+    // Keep the old document until the new one opened cleanly
+    fz_drop_document(MCTX, MDOC);
+    doc_ = newDoc;
+    docGeneration_++;
+    pageCount_ = newCount;
+
+    // fz_font pointers belonged to the old document; fontsByHash_ keeps the atlases
+    fontNameMap_.clear();
+    cancelPrefetch();
+
+    // Page, scroll and zoom are preserved; only a changed page is re-extracted
+    int page = std::min(currentPage_, pageCount_ - 1);
+    uint64_t hash = hashPage(page);
+    if (page == currentPage_ && hash != 0 && hash == currentPageHash_ && !pages_.empty()) {
+        spdlog::info("PDFLayer: {} rebuilt, page {} unchanged", path_, page + 1);
+        return Ok();
     }
 
-    return Ok();
+    spdlog::info("PDFLayer: {} rebuilt, re-extracting page {}", path_, page + 1);
+    return extractPageContent(page);
 }
 
 //-----------------------------------------------------------------------------
 // Build RichText Content
 //-----------------------------------------------------------------------------
 
-void PDFLayer::buildRichTextContent(float viewWidth) {
-    if (!richText_ || pages_.empty()) return;
+void PDFLayer::beginRichTextBuild(float viewWidth) {
+    if (!richTextBack_ || pages_.empty()) return;
 
-    richText_->clear();
+    richTextBack_->clear();
+    backChars_ = 0;
 
+    // Calculate scale to fit view width
     const auto& page = pages_[0];
-    float pdfWidth = page.width;
-    float pdfHeight = page.height;
+    buildScale_ = viewWidth / page.width * zoom_;
+    buildHeight_ = page.height * buildScale_;
+    buildCursor_ = 0;
+    building_ = true;
 
-    // Calculate scale to fit view width
-    float scale = viewWidth / pdfWidth * zoom_;
-    documentHeight_ = pdfHeight * scale;
+    // Nothing on screen yet: let the partial build show while it grows
+    if (!frontHasContent_) documentHeight_ = buildHeight_;
+}
 
-    for (const auto& ch : page.chars) {
-        if (ch.codepoint == '\n' || ch.codepoint == '\r') continue;
-
-        // Convert PDF coordinates to screen coordinates
-        // PDF has Y-up (origin at bottom-left), screen has Y-down (origin at top-left)
-        float screenX = ch.x * scale;
-        float screenY = (pdfHeight - ch.y) * scale;  // Flip Y axis
-        float fontSize = ch.size * scale;
-
-        // Color conversion (ARGB to RGBA)
-        float r = ((ch.color >> 16) & 0xFF) / 255.0f;
-        float g = ((ch.color >> 8) & 0xFF) / 255.0f;
-        float b = (ch.color & 0xFF) / 255.0f;
-        float a = ((ch.color >> 24) & 0xFF) / 255.0f;
-
-        // Default to white text for dark theme
-        if (r < 0.1f && g < 0.1f && b < 0.1f) {
-            r = g = b = 0.9f;
-            a = 1.0f;
-        }
-
-        // Create TextChar for RichText
-        TextChar textChar;
-        textChar.codepoint = ch.codepoint;
-        textChar.x = screenX;
-        textChar.y = screenY;
-        textChar.size = fontSize;
-        textChar.color = glm::vec4(r, g, b, a);
-        textChar.fontFamily = ch.fontFamily;
-
-        // Determine style
-        if (ch.bold && ch.italic) {
-            textChar.style = Font::BoldItalic;
-        } else if (ch.bold) {
-            textChar.style = Font::Bold;
-        } else if (ch.italic) {
-            textChar.style = Font::Italic;
-        } else {
+bool PDFLayer::continueRichTextBuild(std::chrono::steady_clock::time_point deadline) {
+    if (!building_ || pages_.empty()) return false;
+    PerfStages::Scope stage("pdf.richtext");
+
+    const auto& page = pages_[0];
+    bool done = buildTextChars(page, buildScale_, &readyFonts_, buildCursor_, deadline,
+                               [this](const TextChar& textChar) {
+                                   richTextBack_->addChar(textChar);
+                                   backChars_++;
+                               });
+    if (!done) {
+        // Nothing usable on screen (fresh page): the partial build is shown
+        if (!frontHasContent_) richTextBack_->setNeedsLayout();
+        return false;
+    }
+
+    documentHeight_ = buildHeight_;
+    swapRichText();
+    spdlog::debug("PDFLayer: built RichText content with {} chars", page.chars.size());
+    return true;
+}
+
+void PDFLayer::swapRichText() {
+    // Rebuilds of a page on screen are laid out once, when complete
+    richTextBack_->setNeedsLayout();
+    std::swap(richText_, richTextBack_);
+    richTextBack_->clear();
+    frontChars_ = backChars_;
+    backChars_ = 0;
+    frontHasContent_ = true;
+    frontScale_ = buildScale_;
+    building_ = false;
+}
+
+//-----------------------------------------------------------------------------
+// Reflow Mode
+//-----------------------------------------------------------------------------
+
+const std::vector<std::u32string>& PDFLayer::reflowLines(int columns) {
+    auto it = reflowCache_.find(columns);
+    if (it != reflowCache_.end()) return it->second;
+
+    std::vector<std::u32string> lines;
+    if (!pages_.empty()) {
+        for (const auto& paragraph : pages_[0].paragraphs) {
+            // Greedy word wrap; words longer than a line are hard-broken
+            std::u32string line;
+            size_t pos = 0;
+            while (pos < paragraph.size()) {
+                size_t end = paragraph.find(U' ', pos);
+                if (end == std::u32string::npos) end = paragraph.size();
+                std::u32string word = paragraph.substr(pos, end - pos);
+                pos = end + 1;
+                if (word.empty()) continue;
+
+                if (!line.empty() && line.size() + 1 + word.size() > static_cast<size_t>(columns)) {
+                    lines.push_back(std::move(line));
+                    line.clear();
+                }
+                while (word.size() > static_cast<size_t>(columns)) {
+                    if (!line.empty()) {
+                        lines.push_back(std::move(line));
+                        line.clear();
+                    }
+                    lines.push_back(word.substr(0, columns));
+                    word.erase(0, columns);
+                }
+                if (!line.empty()) line.push_back(U' ');
+                line += word;
+            }
+            if (!line.empty()) lines.push_back(std::move(line));
+            lines.emplace_back();  // Blank line between paragraphs
+        }
+    }
+
+    return reflowCache_.emplace(columns, std::move(lines)).first->second;
+}
+
+void PDFLayer::buildReflowContent(float cellWidth, float cellHeight) {
+    if (!richTextBack_ || pages_.empty() || cellWidth <= 0 || cellHeight <= 0) return;
+
+    richTextBack_->clear();
+    backChars_ = 0;
+
+    int columns = std::max(1, static_cast<int>(_width_cells));
+    const auto& lines = reflowLines(columns);
+
+    // One glyph per cell, baseline near the bottom of the cell like terminal text
+    float fontSize = cellHeight * 0.8f;
+    for (size_t row = 0; row < lines.size(); row++) {
+        float baseline = (row + 1) * cellHeight - cellHeight * 0.2f;
+        for (size_t col = 0; col < lines[row].size(); col++) {
+            if (lines[row][col] == U' ') continue;
+
+            TextChar textChar;
+            textChar.codepoint = lines[row][col];
+            textChar.x = col * cellWidth;
+            textChar.y = baseline;
+            textChar.size = fontSize;
+            textChar.color = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
             textChar.style = Font::Regular;
+            richTextBack_->addChar(textChar);
+            backChars_++;
         }
+    }
 
-        richText_->addChar(textChar);
+    documentHeight_ = lines.size() * cellHeight;
+    swapRichText();
+    spdlog::debug("PDFLayer: reflowed page into {} lines of {} columns", lines.size(), columns);
+}
+
+//-----------------------------------------------------------------------------
+// Memory Accounting / Compact Mode
+//-----------------------------------------------------------------------------
+
+size_t PDFLayer::pageBytes(const ExtractedPage& page, size_t& text, size_t& vectors,
+                          size_t& images) {
+    size_t before = text + vectors + images;
+    text += page.chars.capacity() * sizeof(page.chars[0]);
+    for (const auto& ch : page.chars) {
+        text += ch.fontFamily.capacity() > 15 ? ch.fontFamily.capacity() : 0;  // Beyond SSO
     }
+    for (const auto& p : page.paragraphs) text += p.capacity() * sizeof(char32_t);
+    vectors += page.vectors.vertices.capacity() * sizeof(VectorPage::Vertex) +
+               page.vectors.paths.capacity() * sizeof(VectorPage::Path);
+    images += page.images.capacity() * sizeof(PDFImageCache::Placement);
+    return text + vectors + images - before;
+}
 
-    richText_->setNeedsLayout();
-    spdlog::debug("PDFLayer: built RichText content with {} chars", page.chars.size());
+PDFLayer::MemoryReport PDFLayer::memoryReport() const {
+    MemoryReport r;
+    for (const auto& page : pages_) pageBytes(page, r.text, r.vectors, r.images);
+    for (const auto& [cols, lines] : reflowCache_) {
+        for (const auto& line : lines) r.text += line.capacity() * sizeof(char32_t);
+    }
+
+    size_t scratch = 0;
+    r.prefetch = pageBytes(prefetch_.data, scratch, scratch, scratch);
+
+    for (const auto& [hash, pending] : pendingFonts_) {
+        r.fonts += pending.data.capacity() + pending.name.capacity();
+    }
+    for (const auto& [font, name] : fontNameMap_) r.fonts += sizeof(font) + name.capacity();
+    for (const auto& [hash, name] : fontsByHash_) r.fonts += sizeof(hash) + name.capacity();
+
+    // Glyph records in both RichText instances; their per-glyph GPU data
+    // scales the same way
+    r.richText = (frontChars_ + backChars_) * sizeof(TextChar);
+
+    r.gpu = vectorRenderer_.gpuBytes() + colorTransform_.gpuBytes();
+    r.mupdf = PDFPlugin::mupdfHeapBytes();
+    return r;
+}
+
+void PDFLayer::logMemoryReport(const char* what) const {
+    auto r = memoryReport();
+    spdlog::info("PDFLayer: {} {}: text {} B, rich text {} B, vectors {} B, images {} B, "
+                 "fonts {} B, prefetch {} B, gpu {} B, total {} B (MuPDF heap, all documents: {} B)",
+                 what, path_, r.text, r.richText, r.vectors, r.images, r.fonts, r.prefetch, r.gpu,
+                 r.total(), r.mupdf);
+}
+
+void PDFLayer::noteHidden(double deltaTime) {
+    if (compact_ || path_.empty()) return;
+    hiddenSeconds_ += deltaTime;
+    if (hiddenSeconds_ >= COMPACT_AFTER) compact();
+}
+
+void PDFLayer::compact() {
+    logMemoryReport("compacting");
+
+    stopPrefetchWorker();
+    stopAtlasWorker();
+    cancelPrefetch();
+    vectorRenderer_.setPage(nullptr);
+    vectorRenderer_.dispose();
+    colorTransform_.dispose();
+    for (auto* slot : {&richText_, &richTextBack_}) {
+        if (*slot) {
+            (*slot)->dispose();
+            slot->reset();
+        }
+    }
+    building_ = false;
+    frontHasContent_ = false;
+    frontChars_ = 0;
+    backChars_ = 0;
+
+    for (auto& page : pages_) releaseImages(page);
+    std::vector<ExtractedPage>().swap(pages_);
+    reflowCache_.clear();
+
+    // Fonts without an atlas are forgotten so the next extraction queues them again
+    for (const auto& [hash, pending] : pendingFonts_) fontsByHash_.erase(hash);
+    pendingFonts_.clear();
+    fontNameMap_.clear();
+
+    // The document (xref, object cache) is reopened from path_ when visible again
+    if (doc_) {
+        fz_drop_document(MCTX, MDOC);
+        doc_ = nullptr;
+    }
+
+    compact_ = true;
+    logMemoryReport("compacted");
+}
+
+Result<void> PDFLayer::expand() {
+    fz_try(MCTX) { doc_ = fz_open_document(MCTX, path_.c_str()); }
+    fz_catch(MCTX) {
+        doc_ = nullptr;
+        return Err<void>("Failed to reopen PDF: " + path_);
+    }
+    docGeneration_++;
+
+    // Anything short of a restored page leaves the layer compact, to retry later
+    auto stayCompact = [this](Result<void> res) {
+        fz_drop_document(MCTX, MDOC);
+        doc_ = nullptr;
+        return res;
+    };
+
+    pageCount_ = fz_count_pages(MCTX, MDOC);
+    if (pageCount_ <= 0) {
+        return stayCompact(Err<void>("PDF has no pages"));
+    }
+
+    // The file may have changed while hidden; take the current state as baseline
+    std::error_code ec;
+    lastWriteTime_ = std::filesystem::last_write_time(path_, ec);
+    lastFileSize_ = std::filesystem::file_size(path_, ec);
+    changePending_ = false;
+
+    spdlog::debug("PDFLayer: restoring {} at page {}", path_, currentPage_ + 1);
+    if (auto res = extractPageContent(std::clamp(currentPage_, 0, pageCount_ - 1)); !res) {
+        return stayCompact(std::move(res));
+    }
+    compact_ = false;
+    return Ok();
 }
 
 //-----------------------------------------------------------------------------
@@ -362,11 +1299,15 @@ void PDFLayer::buildRichTextContent(float viewWidth) {
 
 Result<void> PDFLayer::render(WebGPUContext& ctx) {
     if (failed_) return Err<void>("PDFLayer already failed");
-    if (!_visible) return Ok();
 
     // Get render context set by owner
     const auto& rc = _render_context;
 
+    if (!_visible) {
+        noteHidden(rc.deltaTime);
+        return Ok();
+    }
+
     // Calculate pixel position from cell position
     float pixelX = _x * rc.cellWidth;
     float pixelY = _y * rc.cellHeight;
@@ -382,10 +1323,38 @@ Result<void> PDFLayer::render(WebGPUContext& ctx) {
     if (rc.termRows > 0) {
         float screenPixelHeight = rc.termRows * rc.cellHeight;
         if (pixelY + pixelH <= 0 || pixelY >= screenPixelHeight) {
+            noteHidden(rc.deltaTime);
             return Ok();
         }
     }
 
+    // Back in view: reopen the document and re-extract the current page
+    hiddenSeconds_ = 0.0;
+    if (compact_) {
+        // A file that is briefly missing (being rebuilt, network share) must
+        // not disable the layer for good
+        auto now = std::chrono::steady_clock::now();
+        if (now < expandRetryAt_) return Ok();
+        if (auto res = expand(); !res) {
+            expandRetryAt_ = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double>(EXPAND_RETRY));
+            return Err<void>("Failed to restore compacted PDF layer", res);
+        }
+    }
+
+    // While a worker generates an atlas it holds the font lock. Rather than
+    // wait, show the last frame's content again, at its zoom and scroll
+    uint32_t layerW = static_cast<uint32_t>(std::ceil(pixelW));
+    uint32_t layerH = static_cast<uint32_t>(std::ceil(pixelH));
+    std::unique_lock<std::mutex> fontLock(plugin_->fontMutex(), std::try_to_lock);
+    if (!fontLock.owns_lock()) {
+        if (frontHasContent_ && colorTransform_.holds(layerW, layerH)) {
+            return colorTransform_.composite(ctx, rc.targetView, rc.screenWidth, rc.screenHeight,
+                                             pixelX, pixelY);
+        }
+        fontLock.lock();
+    }
+
     // Create RichText if needed
     if (!richText_) {
         auto fontMgr = plugin_->getFontManager();
@@ -394,17 +1363,21 @@ Result<void> PDFLayer::render(WebGPUContext& ctx) {
             return Err<void>("No FontManager available for PDF rendering");
         }
 
-        auto result = RichText::create(&ctx, rc.targetFormat, fontMgr);
-        if (!result) {
-            failed_ = true;
-            return Err<void>("Failed to create RichText", result);
+        // Two instances: pages are built progressively into the back one and
+        // swapped in when complete, so a rebuild never blanks the view
+        for (auto* slot : {&richText_, &richTextBack_}) {
+            auto result = RichText::create(&ctx, rc.targetFormat, fontMgr);
+            if (!result) {
+                failed_ = true;
+                return Err<void>("Failed to create RichText", result);
+            }
+            *slot = *result;
+            (*slot)->setDefaultFontFamily("monospace");
         }
-        richText_ = *result;
 
         // Pre-load a fallback font NOW (before rendering) to avoid MSDF generation during render loop
         // This is blocking but happens only once during initialization
         spdlog::info("PDFLayer: pre-loading fallback font...");
-        richText_->setDefaultFontFamily("monospace");
 
         // Force the font to actually load now by requesting it from FontManager
         auto preloadResult = fontMgr->getFont("monospace", Font::Regular);
@@ -421,19 +1394,111 @@ Result<void> PDFLayer::render(WebGPUContext& ctx) {
         initialized_ = true;
     }
 
+    // Pick up rebuilt files (e.g. LaTeX live preview)
+    pollFileChange(rc.deltaTime);
+
+    // Heavy pages are refined over several frames: font atlases are generated
+    // on a worker, glyph building has a fixed per-frame budget, and fallback
+    // glyphs show meanwhile
+    auto deadline = std::chrono::steady_clock::now() + FRAME_WORK_BUDGET;
+    if (!pendingFonts_.empty() || atlasInFlight_ > 0) {
+        queueFontAtlases();
+        pollFontAtlases();
+        // Rebuild once with the real fonts after the last atlas is done
+        if (atlasInFlight_ == 0 && fontsRefined_) {
+            fontsRefined_ = false;
+            lastViewWidth_ = 0;
+        }
+    }
+
+    // A page turned to may have arrived; its build starts this frame
+    pollPrefetch();
+
     // Re-layout if view size changed
     if (lastViewWidth_ != pixelW || lastViewHeight_ != pixelH) {
-        buildRichTextContent(pixelW);
+        if (reflow_) {
+            buildReflowContent(rc.cellWidth, rc.cellHeight);
+        } else {
+            beginRichTextBuild(pixelW);
+        }
         lastViewWidth_ = pixelW;
         lastViewHeight_ = pixelH;
     }
 
+    continueRichTextBuild(deadline);
+    if (!building_) {
+        // A reloaded page may be shorter than before
+        float maxScroll = std::max(0.0f, documentHeight_ - pixelH);
+        if (scrollToEnd_) {
+            scrollOffset_ = maxScroll;
+            scrollToEnd_ = false;
+        }
+        scrollOffset_ = std::clamp(scrollOffset_, 0.0f, maxScroll);
+    }
+
+    // Prepare the neighbouring page before it scrolls into view
+    scroll_.decay(rc.deltaTime);
+    schedulePrefetch(pixelH);
+
+    // Content is drawn in document colours into a layer-sized offscreen target,
+    // then composited through the theme's colour transform
+    auto offscreen = colorTransform_.begin(ctx, rc.targetFormat, layerW, layerH);
+    if (!offscreen) {
+        return Err<void>("Failed to prepare PDF layer target", offscreen);
+    }
+    WGPUTextureView target = *offscreen;
+
+    // Images and vector graphics go underneath the text. Same page->layer mapping
+    // as beginRichTextBuild, expressed as a uniform so zoom/scroll never re-tessellate
+    auto* imageCache = plugin_->imageCache();
+    if (imageCache) {
+        imageCache->beginFrame(this, rc.targetView);
+        imageCache->pump(ctx);
+    }
+
+    bool hasGraphics = !pages_.empty() &&
+                       (!pages_[0].vectors.paths.empty() || !pages_[0].images.empty());
+    if (!reflow_ && hasGraphics) {
+        // Graphics stay at the scale of the text on screen until a rebuild at
+        // a new zoom or width is swapped in
+        const auto& page = pages_[0];
+        float scale = frontHasContent_ ? frontScale_ : buildScale_;
+
+        VectorPathRenderer::Transform transform;
+        transform.scale[0] = 2.0f * scale / layerW;
+        transform.scale[1] = 2.0f * scale / layerH;
+        transform.offset[0] = -1.0f;
+        transform.offset[1] = 1.0f - 2.0f * (page.height * scale - scrollOffset_) / layerH;
+
+        VectorPathRenderer::Scissor scissor{0, 0, layerW, layerH};
+
+        if (imageCache && !page.images.empty()) {
+            if (auto res = imageCache->draw(ctx, target, rc.targetFormat, layerW, layerH,
+                                            transform, scissor, page.images); !res) {
+                spdlog::warn("PDFLayer: image rendering failed: {}", res.error().message());
+            }
+        }
+
+        if (auto res = vectorRenderer_.render(ctx, target, rc.targetFormat, layerW, layerH,
+                                              transform, scissor); !res) {
+            spdlog::warn("PDFLayer: vector path rendering failed: {}", res.error().message());
+        }
+    }
+
+    // A fresh page shows its partial build while it grows; a rebuild of the
+    // page on screen keeps the old one until the new one is complete
+    auto& shown = frontHasContent_ ? richText_ : richTextBack_;
+
     // Apply scroll offset to RichText
-    richText_->setScrollOffset(scrollOffset_);
+    shown->setScrollOffset(scrollOffset_);
 
     // Render
-    return richText_->render(ctx, rc.targetView, rc.screenWidth, rc.screenHeight,
-                              pixelX, pixelY, pixelW, pixelH);
+    if (auto res = shown->render(ctx, target, layerW, layerH, 0.0f, 0.0f, pixelW, pixelH); !res) {
+        return res;
+    }
+
+    return colorTransform_.composite(ctx, rc.targetView, rc.screenWidth, rc.screenHeight,
+                                     pixelX, pixelY);
 }
 
 bool PDFLayer::renderToPass(WGPURenderPassEncoder pass, WebGPUContext& ctx) {
@@ -464,10 +1529,23 @@ bool PDFLayer::onMouseScroll(float xoffset, float yoffset, int mods) {
 
     // Regular scroll
     float scrollAmount = yoffset * 40.0f;
-    scrollOffset_ -= scrollAmount;
+    scroll_.onScroll(-scrollAmount);
+    float maxScroll = std::max(0.0f, documentHeight_ - static_cast<float>(_pixel_height));
+
+    // Scrolling past an edge continues onto the neighbouring page; further
+    // wheel ticks wait until that page is shown
+    if (turnPage_ >= 0) return true;
+    if (scrollAmount < 0 && scrollOffset_ >= maxScroll && currentPage_ < pageCount_ - 1) {
+        turnPage(currentPage_ + 1, false);
+        return true;
+    }
+    if (scrollAmount > 0 && scrollOffset_ <= 0 && currentPage_ > 0) {
+        turnPage(currentPage_ - 1, true);
+        return true;
+    }
 
     // Clamp scroll
-    float maxScroll = std::max(0.0f, documentHeight_ - static_cast<float>(_pixel_height));
+    scrollOffset_ -= scrollAmount;
     scrollOffset_ = std::clamp(scrollOffset_, 0.0f, maxScroll);
 
     return true;
@@ -483,21 +1561,57 @@ bool PDFLayer::onKey(int key, int scancode, int action, int mods) {
 
     if (action != 1) return false;  // GLFW_PRESS
 
-    // Page Up/Down for navigation
+    // Page Up/Down for navigation; repeated presses count from a page still
+    // being extracted
+    int page = turnPage_ >= 0 ? turnPage_ : currentPage_;
     if (key == 266) {  // GLFW_KEY_PAGE_UP
-        if (currentPage_ > 0) {
-            (void)extractPageContent(currentPage_ - 1);
-            scrollOffset_ = 0;
+        if (page > 0) {
+            turnPage(page - 1, false);
             return true;
         }
     } else if (key == 267) {  // GLFW_KEY_PAGE_DOWN
-        if (currentPage_ < pageCount_ - 1) {
-            (void)extractPageContent(currentPage_ + 1);
-            scrollOffset_ = 0;
+        if (page < pageCount_ - 1) {
+            turnPage(page + 1, false);
             return true;
         }
     }
 
+    // Toggle reflow mode (plain text wrapped to the cell grid)
+    if (key == 82) {  // GLFW_KEY_R
+        reflow_ = !reflow_;
+        scrollOffset_ = 0;
+        lastViewWidth_ = 0;
+        spdlog::debug("PDFLayer: reflow mode {}", reflow_ ? "on" : "off");
+        return true;
+    }
+
+    // Log where this document's memory goes
+    if (key == 77) {  // GLFW_KEY_M
+        logMemoryReport("memory");
+        return true;
+    }
+
+    // Cycle colour theme: dark -> document -> sepia (no re-layout needed)
+    if (key == 84) {  // GLFW_KEY_T
+        PDFColorTransform::Theme theme;
+        switch (colorTransform_.theme().mode) {
+        case PDFColorTransform::Mode::Invert:
+            theme.mode = PDFColorTransform::Mode::None;
+            theme.contrast = 1.0f;
+            break;
+        case PDFColorTransform::Mode::None:
+            theme.mode = PDFColorTransform::Mode::Palette;
+            theme.contrast = 1.0f;
+            theme.foreground[0] = 0.26f; theme.foreground[1] = 0.2f; theme.foreground[2] = 0.13f;
+            theme.background[0] = 0.96f; theme.background[1] = 0.91f; theme.background[2] = 0.8f;
+            break;
+        case PDFColorTransform::Mode::Palette:
+            break;  // Default theme is dark
+        }
+        colorTransform_.setTheme(theme);
+        return true;
+    }
+
     // Zoom with +/-
     if (key == 61 || key == 334) {  // = or numpad +
         zoom_ *= 1.1f;
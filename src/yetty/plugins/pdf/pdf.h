@@ -2,11 +2,23 @@
 
 #include <yetty/plugin.h>
 #include <yetty/rich-text.h>
+#include "vector-paths.h"
+#include "image-cache.h"
+#include "page-extract.h"
+#include "color-transform.h"
 #include <webgpu/webgpu.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace yetty {
 
@@ -30,11 +42,23 @@ public:
 
     FontManager* getFontManager();
 
+    // Bytes MuPDF currently holds across every document and worker context
+    static size_t mupdfHeapBytes();
+
+    // Embedded images, shared across layers and pages
+    PDFImageCache* imageCache() { return imageCache_.get(); }
+
+    // Held around FontManager use: atlas workers generate under it, layers
+    // build and draw text under it
+    std::mutex& fontMutex() { return fontMutex_; }
+
 private:
     explicit PDFPlugin(YettyPtr engine) noexcept : Plugin(std::move(engine)) {}
     Result<void> init() noexcept override;
 
     void* fzCtx_ = nullptr;  // fz_context*
+    std::unique_ptr<PDFImageCache> imageCache_;
+    std::mutex fontMutex_;
 };
 
 //-----------------------------------------------------------------------------
@@ -60,14 +84,46 @@ public:
     bool onKey(int key, int scancode, int action, int mods) override;
     bool wantsKeyboard() const override { return true; }
 
+    // Approximate bytes held by this layer, by category
+    struct MemoryReport {
+        size_t text = 0;      // Glyphs, paragraphs, reflow cache
+        size_t richText = 0;  // Glyph records in the front and back RichText
+        size_t vectors = 0;   // Tessellated path vertices
+        size_t images = 0;    // Image placements (pixels live in the shared cache)
+        size_t fonts = 0;     // Font byte copies awaiting atlases, name maps
+        size_t prefetch = 0;  // Page extracted ahead of scrolling
+        size_t gpu = 0;       // Layer-owned buffers and textures
+        size_t mupdf = 0;     // MuPDF heap (documents, object cache, store), shared by all layers
+        size_t total() const { return text + richText + vectors + images + fonts + prefetch + gpu; }
+    };
+    MemoryReport memoryReport() const;
+
 private:
     Result<void> loadPDF(const std::string& path);
     Result<void> extractPageContent(int pageNum);
-    void buildRichTextContent(float viewWidth);
+    // Progressive RichText build into the back buffer, bounded per frame
+    void beginRichTextBuild(float viewWidth);
+    bool continueRichTextBuild(std::chrono::steady_clock::time_point deadline);  // true when swapped in
+    void swapRichText();
 
-    // Font registration with FontManager
+    // Reflow mode - reading-order paragraphs wrapped to the layer's cell grid
+    void buildReflowContent(float cellWidth, float cellHeight);
+    const std::vector<std::u32string>& reflowLines(int columns);
+
+    // Live reload - poll the file and re-extract only when the page changed
+    void pollFileChange(double deltaTime);
+    Result<void> reloadPDF();
+    uint64_t hashPage(int pageNum) { return hashPage(mupdfCtx_, doc_, pageNum); }
+    static uint64_t hashPage(void* ctx, void* doc, int pageNum);
+
+    // Font registration with FontManager; atlases are generated on a worker
+    // and picked up once per frame
     std::string registerFont(void* fzFont);
-    Result<void> generateFontAtlases();
+    void queueFontAtlases();
+    void pollFontAtlases();
+    bool startAtlasWorker();
+    void stopAtlasWorker();
+    void atlasLoop(FontManager* fontMgr);
 
     PDFPlugin* plugin_ = nullptr;
     void* mupdfCtx_ = nullptr;  // fz_context*
@@ -76,37 +132,167 @@ private:
     int currentPage_ = 0;
     float zoom_ = 1.0f;
 
-    // Extracted page data
-    struct ExtractedChar {
-        uint32_t codepoint;
-        float x, y;              // PDF coordinates
-        float size;              // Font size in PDF points
-        uint32_t color;          // ARGB color
-        std::string fontFamily;  // Registered font family name
-        bool bold = false;
-        bool italic = false;
+    // File watching state
+    std::string path_;
+    std::filesystem::file_time_type lastWriteTime_{};
+    uintmax_t lastFileSize_ = 0;
+    bool changePending_ = false;
+    double watchTimer_ = 0.0;
+    uint64_t currentPageHash_ = 0;  // 0 = unknown (non-PDF document)
+
+    // Extracted page data, see page-extract.h
+    using ExtractedChar = PDFExtractedChar;
+    using ExtractedPage = PDFExtractedPage;
+    using ExtractSink = PDFExtractSink;
+
+    std::vector<ExtractedPage> pages_;
+
+    // Compact mode - hidden layers release everything but path and view state
+    void noteHidden(double deltaTime);
+    void compact();
+    Result<void> expand();
+    void logMemoryReport(const char* what) const;
+    static size_t pageBytes(const ExtractedPage& page, size_t& text, size_t& vectors, size_t& images);
+    bool compact_ = false;
+    double hiddenSeconds_ = 0.0;
+    std::chrono::steady_clock::time_point expandRetryAt_{};
+
+    // Extract one page (text, paths, images, fonts) without making it current;
+    // the prefetch worker calls extractPDFPage() directly
+    Result<void> extractPage(int pageNum, ExtractedPage& out);
+
+    // Scroll velocity tracking; positive = towards the end of the document
+    struct ScrollPredictor {
+        float velocity = 0.0f;  // px/s
+        std::chrono::steady_clock::time_point lastEvent{};
+        void onScroll(float deltaPx);
+        void decay(double dt);
     };
 
-    struct ExtractedPage {
-        float width, height;
-        std::vector<ExtractedChar> chars;
+    // Neighbouring page extracted ahead of time; cancelled on direction change
+    struct Prefetch {
+        int page = -1;
+        uint64_t serial = 0;  // Job whose result we are waiting for
+        bool ready = false;   // data holds the extracted page
+        uint64_t hash = 0;
+        ExtractedPage data;
     };
 
-    std::vector<ExtractedPage> pages_;
+    // Font met by extraction whose atlas does not exist yet
+    struct PendingFont {
+        std::vector<unsigned char> data;
+        std::string name;
+        uint64_t hash = 0;
+    };
+
+    // Prefetch extraction runs on a worker with a cloned context and its own
+    // copy of the document, so scrolling never waits on MuPDF
+    struct PrefetchJob {
+        uint64_t serial = 0;
+        int page = -1;
+        std::string path;
+        uint64_t docGeneration = 0;
+        std::unordered_map<uint64_t, std::string> knownFonts;  // Snapshot of fontsByHash_
+    };
+
+    struct PrefetchResult {
+        uint64_t serial = 0;
+        bool ok = false;
+        std::string error;
+        uint64_t hash = 0;
+        double seconds = 0.0;
+        ExtractedPage data;             // Placement keys index images
+        std::vector<void*> images;      // fz_image*, kept
+        std::vector<PendingFont> fonts; // Fonts not in knownFonts
+    };
+
+    // Page turns never extract on the render thread: a page the prefetch
+    // missed is extracted by the worker ahead of speculative work, and the
+    // current page stays on screen until it arrives
+    void turnPage(int pageNum, bool toEnd);
+    void showPage(int pageNum, bool toEnd);
+
+    void schedulePrefetch(float viewHeight);
+    void submitPrefetch(int pageNum);  // Replaces any queued or running job
+    void pollPrefetch();
+    void cancelPrefetch();
+    void releaseImages(ExtractedPage& page);
+    void adoptPrefetch(PrefetchResult& result);
+    void dropPrefetchResult(PrefetchResult& result);
+    bool startPrefetchWorker();
+    void stopPrefetchWorker();
+    void prefetchLoop(void* workerCtx);
+
+    ScrollPredictor scroll_;
+    Prefetch prefetch_;
+    uint64_t prefetchSerial_ = 0;
+    uint64_t docGeneration_ = 0;  // Bumped whenever doc_ is (re)opened
+    int turnPage_ = -1;           // Page turned to, waiting for the worker
+    bool turnToEnd_ = false;      // Entered from below; show its end
+
+    std::thread prefetchThread_;
+    std::mutex prefetchMutex_;
+    std::condition_variable prefetchCv_;
+    std::vector<PrefetchJob> prefetchJobs_;      // At most one: the latest request
+    std::vector<PrefetchResult> prefetchDone_;
+    void* prefetchCookie_ = nullptr;             // fz_cookie* of the running job
+    bool prefetchStop_ = false;
+    bool prefetchUnavailable_ = false;           // Context could not be cloned
+
+    // Failed pages are retried with a growing delay instead of every frame
+    int prefetchFailedPage_ = -1;
+    double prefetchBackoff_ = 0.0;
+    std::chrono::steady_clock::time_point prefetchRetryAt_{};
+
+    double extractSeconds_ = 0.0;  // Running average of extractPage() cost
+    bool scrollToEnd_ = false;     // Entered a page from below; scroll to its end after layout
     std::unordered_map<void*, std::string> fontNameMap_;  // fz_font* -> family name
 
     // Store font data instead of FT_Face to avoid MuPDF lock callback issues
-    struct PendingFont {
-        std::vector<unsigned char> data;
+    std::unordered_map<uint64_t, PendingFont> pendingFonts_;  // font data hash -> data for deferred atlas generation
+
+    // Font data hash -> family name; survives reloads so rebuilt documents reuse atlases
+    std::unordered_map<uint64_t, std::string> fontsByHash_;
+
+    // Families whose atlas has been generated; others render with the fallback
+    std::unordered_set<std::string> readyFonts_;
+    bool fontsRefined_ = false;  // An atlas finished since the last build
+
+    struct AtlasResult {
+        uint64_t hash = 0;
         std::string name;
+        bool ok = false;
+        std::string error;
     };
-    std::unordered_map<void*, PendingFont> pendingFonts_;  // fz_font* -> font data for deferred atlas generation
 
-    // RichText for rendering
+    std::thread atlasThread_;
+    std::mutex atlasMutex_;
+    std::condition_variable atlasCv_;
+    std::deque<PendingFont> atlasJobs_;
+    std::vector<AtlasResult> atlasDone_;
+    size_t atlasInFlight_ = 0;  // Queued or generating
+    bool atlasStop_ = false;
+
+    // RichText for rendering: front is displayed, back is being built
     RichText::Ptr richText_;
+    RichText::Ptr richTextBack_;
+    bool frontHasContent_ = false;
+    float frontScale_ = 0.0f;  // Scale the front was built at; graphics follow it
+    size_t frontChars_ = 0;    // Glyphs added to each instance, for the memory report
+    size_t backChars_ = 0;
+    bool building_ = false;
+    size_t buildCursor_ = 0;
+    float buildScale_ = 0.0f;
+    float buildHeight_ = 0.0f;
+    VectorPathRenderer vectorRenderer_;
+    PDFColorTransform colorTransform_;  // Theme applied on the GPU at composite time
     float documentHeight_ = 0.0f;
     float scrollOffset_ = 0.0f;
 
+    // Reflow mode state; wrapped lines are cached per column count
+    bool reflow_ = false;
+    std::unordered_map<int, std::vector<std::u32string>> reflowCache_;
+
     bool initialized_ = false;
     bool failed_ = false;
     float lastViewWidth_ = 0.0f;
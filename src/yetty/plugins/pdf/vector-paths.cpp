@@ -0,0 +1,539 @@
+#include "vector-paths.h"
+#include <yetty/webgpu-context.h>
+#include <yetty/wgpu-compat.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+extern "C" {
+#include <mupdf/fitz.h>
+}
+
+namespace yetty {
+
+// Maximum deviation of a flattened curve from the true curve, in PDF points.
+// Small enough that diagrams stay smooth at the maximum 10x zoom.
+static constexpr float FLATTEN_TOLERANCE = 0.05f;
+static constexpr int MAX_CURVE_SEGMENTS = 64;
+
+// Hairlines (width 0) are drawn this wide, in PDF points
+static constexpr float MIN_STROKE_WIDTH = 0.5f;
+
+//-----------------------------------------------------------------------------
+// Path capture device
+//-----------------------------------------------------------------------------
+
+namespace {
+
+struct Contour {
+    std::vector<fz_point> points;  // page space
+    bool closed = false;
+};
+
+struct PathFlattener {
+    fz_matrix ctm;
+    std::vector<Contour> contours;
+
+    void moveTo(fz_point p) {
+        contours.emplace_back();
+        contours.back().points.push_back(fz_transform_point(p, ctm));
+    }
+
+    // A segment after closepath starts again from the closed contour's origin
+    void ensureOpen(fz_point fallback) {
+        if (!contours.empty() && !contours.back().closed) return;
+        fz_point start = contours.empty() ? fz_transform_point(fallback, ctm)
+                                          : contours.back().points.front();
+        contours.emplace_back();
+        contours.back().points.push_back(start);
+    }
+
+    void lineTo(fz_point p) {
+        ensureOpen(p);
+        contours.back().points.push_back(fz_transform_point(p, ctm));
+    }
+
+    void curveTo(fz_point c1, fz_point c2, fz_point end) {
+        ensureOpen(c1);
+        auto& pts = contours.back().points;
+
+        fz_point p0 = pts.back();
+        fz_point p1 = fz_transform_point(c1, ctm);
+        fz_point p2 = fz_transform_point(c2, ctm);
+        fz_point p3 = fz_transform_point(end, ctm);
+
+        // Segment count from the largest second difference of the control polygon
+        float ddx = std::max(std::fabs(p0.x - 2 * p1.x + p2.x), std::fabs(p1.x - 2 * p2.x + p3.x));
+        float ddy = std::max(std::fabs(p0.y - 2 * p1.y + p2.y), std::fabs(p1.y - 2 * p2.y + p3.y));
+        float dd = std::sqrt(ddx * ddx + ddy * ddy);
+        int n = static_cast<int>(std::ceil(std::sqrt(0.75f * dd / FLATTEN_TOLERANCE)));
+        n = std::clamp(n, 1, MAX_CURVE_SEGMENTS);
+
+        for (int i = 1; i <= n; i++) {
+            float t = static_cast<float>(i) / n;
+            float u = 1.0f - t;
+            float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+            pts.push_back({a * p0.x + b * p1.x + c * p2.x + d * p3.x,
+                           a * p0.y + b * p1.y + c * p2.y + d * p3.y});
+        }
+    }
+
+    void closePath() {
+        if (!contours.empty()) contours.back().closed = true;
+    }
+};
+
+void walkMoveTo(fz_context*, void* arg, float x, float y) {
+    static_cast<PathFlattener*>(arg)->moveTo({x, y});
+}
+
+void walkLineTo(fz_context*, void* arg, float x, float y) {
+    static_cast<PathFlattener*>(arg)->lineTo({x, y});
+}
+
+void walkCurveTo(fz_context*, void* arg, float x1, float y1, float x2, float y2, float x3, float y3) {
+    static_cast<PathFlattener*>(arg)->curveTo({x1, y1}, {x2, y2}, {x3, y3});
+}
+
+void walkClosePath(fz_context*, void* arg) {
+    static_cast<PathFlattener*>(arg)->closePath();
+}
+
+std::vector<Contour> flattenPath(fz_context* ctx, const fz_path* path, fz_matrix ctm) {
+    fz_path_walker walker = {};
+    walker.moveto = walkMoveTo;
+    walker.lineto = walkLineTo;
+    walker.curveto = walkCurveTo;
+    walker.closepath = walkClosePath;
+
+    PathFlattener flattener;
+    flattener.ctm = ctm;
+    fz_walk_path(ctx, path, &walker, &flattener);
+    return std::move(flattener.contours);
+}
+
+uint32_t packColor(fz_context* ctx, fz_colorspace* cs, const float* color, float alpha,
+                   fz_color_params params) {
+    float rgb[3] = {0, 0, 0};
+    if (cs) {
+        fz_convert_color(ctx, cs, color, fz_device_rgb(ctx), rgb, nullptr, params);
+    }
+
+    auto byte = [](float v) {
+        return static_cast<uint32_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+    };
+    return byte(rgb[0]) | (byte(rgb[1]) << 8) | (byte(rgb[2]) << 16) | (byte(alpha) << 24);
+}
+
+struct CaptureDevice {
+    fz_device super;
+    VectorPage* page;
+};
+
+void captureFillPath(fz_context* ctx, fz_device* dev, const fz_path* path, int evenOdd,
+                     fz_matrix ctm, fz_colorspace* cs, const float* color, float alpha,
+                     fz_color_params params) {
+    if (alpha <= 0.0f) return;
+    VectorPage& page = *reinterpret_cast<CaptureDevice*>(dev)->page;
+    uint32_t rgba = packColor(ctx, cs, color, alpha, params);
+
+    auto contours = flattenPath(ctx, path, ctm);
+
+    // One fan per contour; overlapping triangles resolve the winding in the stencil
+    uint32_t first = static_cast<uint32_t>(page.vertices.size());
+    float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    for (const auto& contour : contours) {
+        const auto& pts = contour.points;
+        if (pts.size() < 3) continue;
+        for (size_t i = 1; i + 1 < pts.size(); i++) {
+            page.vertices.push_back({pts[0].x, pts[0].y, rgba});
+            page.vertices.push_back({pts[i].x, pts[i].y, rgba});
+            page.vertices.push_back({pts[i + 1].x, pts[i + 1].y, rgba});
+        }
+        for (const auto& p : pts) {
+            x0 = std::min(x0, p.x); y0 = std::min(y0, p.y);
+            x1 = std::max(x1, p.x); y1 = std::max(y1, p.y);
+        }
+    }
+
+    uint32_t count = static_cast<uint32_t>(page.vertices.size()) - first;
+    if (count == 0) return;
+
+    uint32_t coverFirst = static_cast<uint32_t>(page.vertices.size());
+    page.vertices.push_back({x0, y0, rgba});
+    page.vertices.push_back({x1, y0, rgba});
+    page.vertices.push_back({x1, y1, rgba});
+    page.vertices.push_back({x0, y0, rgba});
+    page.vertices.push_back({x1, y1, rgba});
+    page.vertices.push_back({x0, y1, rgba});
+
+    page.paths.push_back({evenOdd ? VectorPage::Kind::FillEvenOdd : VectorPage::Kind::FillNonZero,
+                          first, count, coverFirst});
+}
+
+void captureStrokePath(fz_context* ctx, fz_device* dev, const fz_path* path,
+                       const fz_stroke_state* stroke, fz_matrix ctm, fz_colorspace* cs,
+                       const float* color, float alpha, fz_color_params params) {
+    if (alpha <= 0.0f) return;
+    VectorPage& page = *reinterpret_cast<CaptureDevice*>(dev)->page;
+    uint32_t rgba = packColor(ctx, cs, color, alpha, params);
+
+    auto contours = flattenPath(ctx, path, ctm);
+    float width = std::max(stroke->linewidth * fz_matrix_expansion(ctm), MIN_STROKE_WIDTH);
+    float half = width * 0.5f;
+
+    // Each segment becomes a quad; interior ends are extended by half the width
+    // so consecutive segments overlap instead of leaving notches at the joins
+    uint32_t first = static_cast<uint32_t>(page.vertices.size());
+    for (auto& contour : contours) {
+        auto& pts = contour.points;
+        if (contour.closed && pts.size() > 2) pts.push_back(pts.front());
+        if (pts.size() < 2) continue;
+
+        for (size_t i = 0; i + 1 < pts.size(); i++) {
+            fz_point a = pts[i], b = pts[i + 1];
+            float dx = b.x - a.x, dy = b.y - a.y;
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len <= 0.0f) continue;
+            dx /= len;
+            dy /= len;
+
+            bool extendStart = i > 0 || contour.closed || stroke->start_cap != FZ_LINECAP_BUTT;
+            bool extendEnd = i + 2 < pts.size() || contour.closed || stroke->end_cap != FZ_LINECAP_BUTT;
+            if (extendStart) { a.x -= dx * half; a.y -= dy * half; }
+            if (extendEnd) { b.x += dx * half; b.y += dy * half; }
+
+            float nx = -dy * half, ny = dx * half;
+            VectorPage::Vertex q0{a.x + nx, a.y + ny, rgba};
+            VectorPage::Vertex q1{b.x + nx, b.y + ny, rgba};
+            VectorPage::Vertex q2{b.x - nx, b.y - ny, rgba};
+            VectorPage::Vertex q3{a.x - nx, a.y - ny, rgba};
+            page.vertices.insert(page.vertices.end(), {q0, q1, q2, q0, q2, q3});
+        }
+    }
+
+    uint32_t count = static_cast<uint32_t>(page.vertices.size()) - first;
+    if (count == 0) return;
+    page.paths.push_back({VectorPage::Kind::Stroke, first, count, 0});
+}
+
+} // namespace
+
+void* newVectorCaptureDevice(void* fzCtx, VectorPage* page) {
+    fz_context* ctx = static_cast<fz_context*>(fzCtx);
+    auto* dev = static_cast<CaptureDevice*>(fz_new_device_of_size(ctx, sizeof(CaptureDevice)));
+    dev->super.fill_path = captureFillPath;
+    dev->super.stroke_path = captureStrokePath;
+    dev->page = page;
+    return dev;
+}
+
+//-----------------------------------------------------------------------------
+// VectorPathRenderer
+//-----------------------------------------------------------------------------
+
+VectorPathRenderer::~VectorPathRenderer() { dispose(); }
+
+void VectorPathRenderer::setPage(const VectorPage* page) {
+    page_ = page;
+    dirty_ = true;
+}
+
+Result<void> VectorPathRenderer::render(WebGPUContext& ctx, WGPUTextureView target,
+                                        WGPUTextureFormat format,
+                                        uint32_t screenWidth, uint32_t screenHeight,
+                                        const Transform& transform, const Scissor& scissor) {
+    if (!page_ || page_->paths.empty()) return Ok();
+    if (scissor.x >= screenWidth || scissor.y >= screenHeight || scissor.w == 0 || scissor.h == 0) {
+        return Ok();
+    }
+
+    if (!stencilNonZero_ || format_ != format) {
+        if (auto res = createPipelines(ctx, format); !res) return res;
+    }
+    if (auto res = ensureStencil(ctx, screenWidth, screenHeight); !res) return res;
+
+    WGPUDevice device = ctx.getDevice();
+
+    // Geometry is uploaded once per page; zoom and scroll only touch the uniform
+    if (dirty_) {
+        size_t count = page_->vertices.size();
+        if (count > vertexCapacity_) {
+            if (vertexBuffer_) { wgpuBufferRelease(vertexBuffer_); vertexBuffer_ = nullptr; }
+            vertexCapacity_ = std::max(count, vertexCapacity_ * 2);
+
+            WGPUBufferDescriptor bufDesc = {};
+            bufDesc.size = vertexCapacity_ * sizeof(VectorPage::Vertex);
+            bufDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
+            vertexBuffer_ = wgpuDeviceCreateBuffer(device, &bufDesc);
+            if (!vertexBuffer_) {
+                vertexCapacity_ = 0;
+                return Err<void>("Failed to create vector path vertex buffer");
+            }
+        }
+        wgpuQueueWriteBuffer(ctx.getQueue(), vertexBuffer_, 0, page_->vertices.data(),
+                             count * sizeof(VectorPage::Vertex));
+        dirty_ = false;
+    }
+
+    wgpuQueueWriteBuffer(ctx.getQueue(), uniformBuffer_, 0, &transform, sizeof(Transform));
+
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+    if (!encoder) return Err<void>("Failed to create command encoder");
+
+    WGPURenderPassColorAttachment colorAttachment = {};
+    colorAttachment.view = target;
+    colorAttachment.loadOp = WGPULoadOp_Load;
+    colorAttachment.storeOp = WGPUStoreOp_Store;
+    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+    WGPURenderPassDepthStencilAttachment stencilAttachment = {};
+    stencilAttachment.view = stencilView_;
+    stencilAttachment.depthLoadOp = WGPULoadOp_Undefined;
+    stencilAttachment.depthStoreOp = WGPUStoreOp_Undefined;
+    stencilAttachment.stencilLoadOp = WGPULoadOp_Clear;
+    stencilAttachment.stencilStoreOp = WGPUStoreOp_Discard;
+    stencilAttachment.stencilClearValue = 0;
+
+    WGPURenderPassDescriptor passDesc = {};
+    passDesc.colorAttachmentCount = 1;
+    passDesc.colorAttachments = &colorAttachment;
+    passDesc.depthStencilAttachment = &stencilAttachment;
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &passDesc);
+    if (!pass) {
+        wgpuCommandEncoderRelease(encoder);
+        return Err<void>("Failed to begin render pass");
+    }
+
+    uint32_t sw = std::min(scissor.w, screenWidth - scissor.x);
+    uint32_t sh = std::min(scissor.h, screenHeight - scissor.y);
+    wgpuRenderPassEncoderSetScissorRect(pass, scissor.x, scissor.y, sw, sh);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, bindGroup_, 0, nullptr);
+    wgpuRenderPassEncoderSetVertexBuffer(pass, 0, vertexBuffer_, 0,
+                                         page_->vertices.size() * sizeof(VectorPage::Vertex));
+
+    // Stencil-then-cover for fills: the fan marks covered pixels, the cover
+    // quad paints them and resets the stencil for the next path
+    WGPURenderPipeline current = nullptr;
+    auto use = [&](WGPURenderPipeline pipeline) {
+        if (pipeline != current) {
+            wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+            current = pipeline;
+        }
+    };
+
+    for (const auto& path : page_->paths) {
+        switch (path.kind) {
+        case VectorPage::Kind::FillNonZero:
+        case VectorPage::Kind::FillEvenOdd:
+            use(path.kind == VectorPage::Kind::FillNonZero ? stencilNonZero_ : stencilEvenOdd_);
+            wgpuRenderPassEncoderDraw(pass, path.count, 1, path.first, 0);
+            use(cover_);
+            wgpuRenderPassEncoderDraw(pass, 6, 1, path.coverFirst, 0);
+            break;
+        case VectorPage::Kind::Stroke:
+            use(stroke_);
+            wgpuRenderPassEncoderDraw(pass, path.count, 1, path.first, 0);
+            break;
+        }
+    }
+
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+
+    WGPUCommandBufferDescriptor cmdDesc = {};
+    WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdDesc);
+    if (cmdBuffer) {
+        wgpuQueueSubmit(ctx.getQueue(), 1, &cmdBuffer);
+        wgpuCommandBufferRelease(cmdBuffer);
+    }
+    wgpuCommandEncoderRelease(encoder);
+    return Ok();
+}
+
+Result<void> VectorPathRenderer::ensureStencil(WebGPUContext& ctx, uint32_t width, uint32_t height) {
+    if (stencil_ && stencilWidth_ == width && stencilHeight_ == height) return Ok();
+
+    if (stencilView_) { wgpuTextureViewRelease(stencilView_); stencilView_ = nullptr; }
+    if (stencil_) { wgpuTextureRelease(stencil_); stencil_ = nullptr; }
+
+    WGPUTextureDescriptor texDesc = {};
+    texDesc.size = {width, height, 1};
+    texDesc.format = WGPUTextureFormat_Stencil8;
+    texDesc.usage = WGPUTextureUsage_RenderAttachment;
+    texDesc.dimension = WGPUTextureDimension_2D;
+    texDesc.mipLevelCount = 1;
+    texDesc.sampleCount = 1;
+    stencil_ = wgpuDeviceCreateTexture(ctx.getDevice(), &texDesc);
+    if (!stencil_) return Err<void>("Failed to create vector path stencil texture");
+
+    stencilView_ = wgpuTextureCreateView(stencil_, nullptr);
+    if (!stencilView_) return Err<void>("Failed to create vector path stencil view");
+
+    stencilWidth_ = width;
+    stencilHeight_ = height;
+    return Ok();
+}
+
+static WGPURenderPipeline createPathPipeline(WGPUDevice device, WGPUShaderModule shaderModule,
+                                             WGPUPipelineLayout layout, WGPUTextureFormat format,
+                                             bool writeColor, WGPUStencilFaceState front,
+                                             WGPUStencilFaceState back) {
+    WGPUVertexAttribute attributes[2] = {};
+    attributes[0].format = WGPUVertexFormat_Float32x2;
+    attributes[0].offset = offsetof(VectorPage::Vertex, x);
+    attributes[0].shaderLocation = 0;
+    attributes[1].format = WGPUVertexFormat_Unorm8x4;
+    attributes[1].offset = offsetof(VectorPage::Vertex, color);
+    attributes[1].shaderLocation = 1;
+
+    WGPUVertexBufferLayout vertexLayout = {};
+    vertexLayout.stepMode = WGPUVertexStepMode_Vertex;
+    vertexLayout.arrayStride = sizeof(VectorPage::Vertex);
+    vertexLayout.attributeCount = 2;
+    vertexLayout.attributes = attributes;
+
+    WGPUDepthStencilState depthStencil = {};
+    depthStencil.format = WGPUTextureFormat_Stencil8;
+    depthStencil.depthWriteEnabled = WGPUOptionalBool_False;
+    depthStencil.depthCompare = WGPUCompareFunction_Always;
+    depthStencil.stencilFront = front;
+    depthStencil.stencilBack = back;
+    depthStencil.stencilReadMask = 0xFF;
+    depthStencil.stencilWriteMask = 0xFF;
+
+    WGPURenderPipelineDescriptor pipelineDesc = {};
+    pipelineDesc.layout = layout;
+    pipelineDesc.vertex.module = shaderModule;
+    pipelineDesc.vertex.entryPoint = WGPU_STR("vs_main");
+    pipelineDesc.vertex.bufferCount = 1;
+    pipelineDesc.vertex.buffers = &vertexLayout;
+    WGPUFragmentState fragState = {};
+    fragState.module = shaderModule; fragState.entryPoint = WGPU_STR("fs_main");
+    WGPUColorTargetState colorTarget = {};
+    colorTarget.format = format;
+    colorTarget.writeMask = writeColor ? WGPUColorWriteMask_All : WGPUColorWriteMask_None;
+    WGPUBlendState blend = {};
+    blend.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.color.operation = WGPUBlendOperation_Add;
+    blend.alpha.srcFactor = WGPUBlendFactor_One;
+    blend.alpha.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.alpha.operation = WGPUBlendOperation_Add;
+    colorTarget.blend = &blend;
+    fragState.targetCount = 1; fragState.targets = &colorTarget;
+    pipelineDesc.fragment = &fragState;
+    pipelineDesc.depthStencil = &depthStencil;
+    pipelineDesc.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipelineDesc.primitive.cullMode = WGPUCullMode_None;
+    pipelineDesc.multisample.count = 1; pipelineDesc.multisample.mask = ~0u;
+
+    return wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
+}
+
+Result<void> VectorPathRenderer::createPipelines(WebGPUContext& ctx, WGPUTextureFormat format) {
+    WGPUDevice device = ctx.getDevice();
+
+    for (auto* p : {&stencilNonZero_, &stencilEvenOdd_, &cover_, &stroke_}) {
+        if (*p) { wgpuRenderPipelineRelease(*p); *p = nullptr; }
+    }
+    if (bindGroup_) { wgpuBindGroupRelease(bindGroup_); bindGroup_ = nullptr; }
+
+    if (!uniformBuffer_) {
+        WGPUBufferDescriptor bufDesc = {};
+        bufDesc.size = sizeof(Transform);
+        bufDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+        uniformBuffer_ = wgpuDeviceCreateBuffer(device, &bufDesc);
+        if (!uniformBuffer_) return Err<void>("Failed to create vector path uniform buffer");
+    }
+
+    const char* shaderCode = R"(
+struct Uniforms { scale: vec2<f32>, offset: vec2<f32>, }
+@group(0) @binding(0) var<uniform> u: Uniforms;
+struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) color: vec4<f32>, }
+@vertex fn vs_main(@location(0) pos: vec2<f32>, @location(1) color: vec4<f32>) -> VertexOutput {
+    var o: VertexOutput;
+    o.position = vec4(pos * u.scale + u.offset, 0., 1.);
+    o.color = color;
+    return o;
+}
+@fragment fn fs_main(@location(0) color: vec4<f32>) -> @location(0) vec4<f32> {
+    return color;
+}
+)";
+
+    WGPUShaderSourceWGSL wgslDesc = {};
+    wgslDesc.chain.sType = WGPUSType_ShaderSourceWGSL;
+    wgslDesc.code = WGPU_STR(shaderCode);
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = &wgslDesc.chain;
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
+    if (!shaderModule) return Err<void>("Failed to create vector path shader module");
+
+    WGPUBindGroupLayoutEntry entry = {};
+    entry.binding = 0; entry.visibility = WGPUShaderStage_Vertex;
+    entry.buffer.type = WGPUBufferBindingType_Uniform;
+    WGPUBindGroupLayoutDescriptor bglDesc = {};
+    bglDesc.entryCount = 1; bglDesc.entries = &entry;
+    WGPUBindGroupLayout bgl = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+    if (!bgl) { wgpuShaderModuleRelease(shaderModule); return Err<void>("Failed to create bgl"); }
+
+    WGPUPipelineLayoutDescriptor plDesc = {};
+    plDesc.bindGroupLayoutCount = 1; plDesc.bindGroupLayouts = &bgl;
+    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
+
+    WGPUBindGroupEntry bgE = {};
+    bgE.binding = 0; bgE.buffer = uniformBuffer_; bgE.size = sizeof(Transform);
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.layout = bgl; bgDesc.entryCount = 1; bgDesc.entries = &bgE;
+    bindGroup_ = wgpuDeviceCreateBindGroup(device, &bgDesc);
+
+    // Nonzero winding: front faces increment, back faces decrement
+    WGPUStencilFaceState incr = {WGPUCompareFunction_Always, WGPUStencilOperation_Keep,
+                                 WGPUStencilOperation_Keep, WGPUStencilOperation_IncrementWrap};
+    WGPUStencilFaceState decr = {WGPUCompareFunction_Always, WGPUStencilOperation_Keep,
+                                 WGPUStencilOperation_Keep, WGPUStencilOperation_DecrementWrap};
+    // Even-odd: every covering triangle flips the bits
+    WGPUStencilFaceState invert = {WGPUCompareFunction_Always, WGPUStencilOperation_Keep,
+                                   WGPUStencilOperation_Keep, WGPUStencilOperation_Invert};
+    // Cover: paint where the stencil is non-zero and clear it behind us
+    WGPUStencilFaceState cover = {WGPUCompareFunction_NotEqual, WGPUStencilOperation_Keep,
+                                  WGPUStencilOperation_Keep, WGPUStencilOperation_Zero};
+    // Strokes are already tessellated and ignore the stencil
+    WGPUStencilFaceState keep = {WGPUCompareFunction_Always, WGPUStencilOperation_Keep,
+                                 WGPUStencilOperation_Keep, WGPUStencilOperation_Keep};
+
+    stencilNonZero_ = createPathPipeline(device, shaderModule, pipelineLayout, format, false, incr, decr);
+    stencilEvenOdd_ = createPathPipeline(device, shaderModule, pipelineLayout, format, false, invert, invert);
+    cover_ = createPathPipeline(device, shaderModule, pipelineLayout, format, true, cover, cover);
+    stroke_ = createPathPipeline(device, shaderModule, pipelineLayout, format, true, keep, keep);
+
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+    wgpuBindGroupLayoutRelease(bgl);
+
+    if (!bindGroup_ || !stencilNonZero_ || !stencilEvenOdd_ || !cover_ || !stroke_) {
+        return Err<void>("Failed to create vector path pipelines");
+    }
+    format_ = format;
+    return Ok();
+}
+
+void VectorPathRenderer::dispose() {
+    for (auto* p : {&stencilNonZero_, &stencilEvenOdd_, &cover_, &stroke_}) {
+        if (*p) { wgpuRenderPipelineRelease(*p); *p = nullptr; }
+    }
+    if (bindGroup_) { wgpuBindGroupRelease(bindGroup_); bindGroup_ = nullptr; }
+    if (uniformBuffer_) { wgpuBufferRelease(uniformBuffer_); uniformBuffer_ = nullptr; }
+    if (vertexBuffer_) { wgpuBufferRelease(vertexBuffer_); vertexBuffer_ = nullptr; }
+    if (stencilView_) { wgpuTextureViewRelease(stencilView_); stencilView_ = nullptr; }
+    if (stencil_) { wgpuTextureRelease(stencil_); stencil_ = nullptr; }
+    vertexCapacity_ = 0;
+    stencilWidth_ = stencilHeight_ = 0;
+    format_ = WGPUTextureFormat_Undefined;
+    dirty_ = page_ != nullptr;
+}
+
+} // namespace yetty
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <yetty/plugin.h>
+#include <webgpu/webgpu.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace yetty {
+
+class WebGPUContext;
+
+//-----------------------------------------------------------------------------
+// VectorPage - fill/stroke paths of one page, tessellated once in page space
+//-----------------------------------------------------------------------------
+// Fills are stored as triangle fans (one per contour) for stencil-then-cover,
+// followed by a 6-vertex cover quad. Strokes are expanded to triangles.
+//-----------------------------------------------------------------------------
+struct VectorPage {
+    struct Vertex {
+        float x, y;      // page space
+        uint32_t color;  // RGBA8, R in the low byte
+    };
+
+    enum class Kind : uint8_t { FillNonZero, FillEvenOdd, Stroke };
+
+    struct Path {
+        Kind kind;
+        uint32_t first;       // fan triangles (fills) or stroke triangles
+        uint32_t count;
+        uint32_t coverFirst;  // cover quad (fills only)
+    };
+
+    std::vector<Vertex> vertices;
+    std::vector<Path> paths;
+
+    void clear() {
+        vertices.clear();
+        paths.clear();
+    }
+};
+
+// Create an fz_device that appends fill/stroke paths to page.
+// Returns fz_device*; the caller closes and drops it.
+void* newVectorCaptureDevice(void* fzCtx, VectorPage* page);
+
+//-----------------------------------------------------------------------------
+// VectorPathRenderer - draws a VectorPage with a page->NDC transform uniform
+//-----------------------------------------------------------------------------
+class VectorPathRenderer {
+public:
+    // ndc = page * scale + offset
+    struct Transform {
+        float scale[2];
+        float offset[2];
+    };
+
+    struct Scissor {
+        uint32_t x, y, w, h;
+    };
+
+    ~VectorPathRenderer();
+
+    // Page data must stay alive until the next setPage() call
+    void setPage(const VectorPage* page);
+
+    Result<void> render(WebGPUContext& ctx, WGPUTextureView target, WGPUTextureFormat format,
+                        uint32_t screenWidth, uint32_t screenHeight,
+                        const Transform& transform, const Scissor& scissor);
+
+    void dispose();
+
+    size_t gpuBytes() const {
+        return vertexCapacity_ * sizeof(VectorPage::Vertex) +
+               static_cast<size_t>(stencilWidth_) * stencilHeight_;
+    }
+
+private:
+    Result<void> createPipelines(WebGPUContext& ctx, WGPUTextureFormat format);
+    Result<void> ensureStencil(WebGPUContext& ctx, uint32_t width, uint32_t height);
+
+    const VectorPage* page_ = nullptr;
+    bool dirty_ = false;
+
+    WGPUBuffer vertexBuffer_ = nullptr;
+    size_t vertexCapacity_ = 0;
+    WGPUBuffer uniformBuffer_ = nullptr;
+    WGPUBindGroup bindGroup_ = nullptr;
+
+    WGPURenderPipeline stencilNonZero_ = nullptr;
+    WGPURenderPipeline stencilEvenOdd_ = nullptr;
+    WGPURenderPipeline cover_ = nullptr;
+    WGPURenderPipeline stroke_ = nullptr;
+    WGPUTextureFormat format_ = WGPUTextureFormat_Undefined;
+
+    WGPUTexture stencil_ = nullptr;
+    WGPUTextureView stencilView_ = nullptr;
+    uint32_t stencilWidth_ = 0;
+    uint32_t stencilHeight_ = 0;
+};
+
+} // namespace yetty
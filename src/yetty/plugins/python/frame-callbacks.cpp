@@ -0,0 +1,226 @@
+#include "frame-callbacks.h"
+#include <spdlog/spdlog.h>
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace yetty {
+
+// A callback raising this many frames in a row is disabled
+static constexpr uint32_t MAX_CONSECUTIVE_ERRORS = 10;
+
+static const char* const KIND_NAMES[FrameCallbacks::KIND_COUNT] = {
+    "frame", "resize", "input", "idle",
+};
+
+FrameCallbacks& FrameCallbacks::instance() {
+    static FrameCallbacks callbacks;
+    return callbacks;
+}
+
+bool FrameCallbacks::kindFromName(const char* name, Kind& kind) {
+    for (size_t i = 0; i < KIND_COUNT; ++i) {
+        if (std::strcmp(KIND_NAMES[i], name) == 0) {
+            kind = static_cast<Kind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameCallbacks::add(Kind kind, PyObject* callable) {
+    Py_INCREF(callable);
+    Entry entry;
+    entry.callable = callable;
+    entry.owner = _active_owner;
+    _entries[static_cast<size_t>(kind)].push_back(entry);
+}
+
+bool FrameCallbacks::remove(Kind kind, PyObject* callable) {
+    for (auto& entry : _entries[static_cast<size_t>(kind)]) {
+        if (!entry.removed && entry.callable == callable) {
+            entry.removed = true;
+            if (_depth == 0) compact(kind);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameCallbacks::removeOwner(const void* owner) {
+    for (size_t k = 0; k < KIND_COUNT; ++k) {
+        for (auto& entry : _entries[k]) {
+            if (entry.owner == owner) entry.removed = true;
+        }
+        if (_depth == 0) compact(static_cast<Kind>(k));
+    }
+}
+
+bool FrameCallbacks::has(Kind kind, const void* owner) const {
+    for (const auto& entry : _entries[static_cast<size_t>(kind)]) {
+        if (!entry.removed && (!entry.owner || entry.owner == owner)) return true;
+    }
+    return false;
+}
+
+void FrameCallbacks::compact(Kind kind) {
+    auto& entries = _entries[static_cast<size_t>(kind)];
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].removed) {
+            Py_DECREF(entries[i].callable);
+        } else {
+            entries[out++] = entries[i];
+        }
+    }
+    entries.resize(out);
+}
+
+void FrameCallbacks::invoke(Kind kind, const void* owner, PyObject* const* args, size_t nargs) {
+    auto& entries = _entries[static_cast<size_t>(kind)];
+    if (entries.empty()) return;
+
+    ++_depth;
+    bool anyRemoved = false;
+    // Index loop: a callback may register another one and reallocate
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].removed) {
+            anyRemoved = true;
+            continue;
+        }
+        if (!entries[i].owner) {
+            entries[i].owner = owner;
+        } else if (entries[i].owner != owner) {
+            continue;
+        }
+        PyObject* callable = entries[i].callable;
+
+        auto start = std::chrono::steady_clock::now();
+        PyObject* result = PyObject_Vectorcall(
+            callable, args, nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+        uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+
+        Entry& entry = entries[i];
+        entry.calls++;
+        entry.totalNs += ns;
+        if (ns > entry.maxNs) entry.maxNs = ns;
+
+        if (result) {
+            Py_DECREF(result);
+            entry.consecutiveErrors = 0;
+            continue;
+        }
+
+        PyErr_Print();
+        PyErr_Clear();
+        entry.errors++;
+        if (++entry.consecutiveErrors >= MAX_CONSECUTIVE_ERRORS) {
+            spdlog::warn("FrameCallbacks: disabling {} callback after {} consecutive errors",
+                         KIND_NAMES[static_cast<size_t>(kind)], entry.consecutiveErrors);
+            entry.removed = true;
+            anyRemoved = true;
+        }
+    }
+    --_depth;
+
+    if (anyRemoved && _depth == 0) compact(kind);
+}
+
+// Python floats are immutable, but one nothing else references cannot be
+// observed changing; a callback that kept the last one gets a fresh object
+static PyObject* reuseFloat(PyObject*& cached, double value) {
+    if (cached && Py_REFCNT(cached) == 1) {
+        reinterpret_cast<PyFloatObject*>(cached)->ob_fval = value;
+        return cached;
+    }
+    Py_XDECREF(cached);
+    cached = PyFloat_FromDouble(value);
+    return cached;
+}
+
+void FrameCallbacks::frame(const void* owner, double time, double dt) {
+    if (!has(Kind::Frame, owner)) return;
+    if (!reuseFloat(_time, time) || !reuseFloat(_dt, dt)) {
+        PyErr_Clear();
+        return;
+    }
+    PyObject* args[3] = {nullptr, _time, _dt};
+    invoke(Kind::Frame, owner, args + 1, 2);
+}
+
+void FrameCallbacks::resize(const void* owner, uint32_t width, uint32_t height) {
+    if (!_width || width != _last_width || height != _last_height) {
+        Py_XDECREF(_width);
+        Py_XDECREF(_height);
+        _width = PyLong_FromUnsignedLong(width);
+        _height = PyLong_FromUnsignedLong(height);
+        _last_width = width;
+        _last_height = height;
+    }
+    PyObject* args[3] = {nullptr, _width, _height};
+    invoke(Kind::Resize, owner, args + 1, 2);
+}
+
+void FrameCallbacks::input(const void* owner, PyObject* batch) {
+    PyObject* args[2] = {nullptr, batch};
+    invoke(Kind::Input, owner, args + 1, 1);
+}
+
+void FrameCallbacks::idle(const void* owner) {
+    PyObject* args[1] = {nullptr};
+    invoke(Kind::Idle, owner, args + 1, 0);
+}
+
+PyObject* FrameCallbacks::stats() const {
+    PyObject* dict = PyDict_New();
+    if (!dict) return nullptr;
+
+    for (size_t k = 0; k < KIND_COUNT; ++k) {
+        PyObject* list = PyList_New(0);
+        for (const auto& entry : _entries[k]) {
+            if (entry.removed) continue;
+            PyObject* name = PyObject_GetAttrString(entry.callable, "__qualname__");
+            if (!name) {
+                PyErr_Clear();
+                name = PyObject_Repr(entry.callable);
+            }
+            PyObject* item = Py_BuildValue("{s:N,s:K,s:K,s:d,s:d}",
+                "name", name,
+                "calls", (unsigned long long)entry.calls,
+                "errors", (unsigned long long)entry.errors,
+                "total_us", entry.totalNs / 1000.0,
+                "max_us", entry.maxNs / 1000.0);
+            if (item) {
+                PyList_Append(list, item);
+                Py_DECREF(item);
+            }
+        }
+        PyDict_SetItemString(dict, KIND_NAMES[k], list);
+        Py_DECREF(list);
+    }
+    return dict;
+}
+
+void FrameCallbacks::clear() {
+    for (size_t k = 0; k < KIND_COUNT; ++k) {
+        for (auto& entry : _entries[k]) {
+            Py_DECREF(entry.callable);
+        }
+        _entries[k].clear();
+    }
+    _active_owner = nullptr;
+    Py_XDECREF(_time);
+    Py_XDECREF(_dt);
+    _time = nullptr;
+    _dt = nullptr;
+    Py_XDECREF(_width);
+    Py_XDECREF(_height);
+    _width = nullptr;
+    _height = nullptr;
+}
+
+} // namespace yetty
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Forward declare PyObject to avoid including Python.h
+struct _object;
+typedef _object PyObject;
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// FrameCallbacks - Python callables invoked by PythonLayer every frame
+//-----------------------------------------------------------------------------
+// Scripts register callables through yetty_wgpu.register_callback(kind, fn).
+// Each invocation is a single vectorcall with the arguments on the stack, so
+// a layer with nothing registered costs no interpreter work at all. Every
+// callback's call count and time are tracked; one that keeps raising is
+// disabled rather than spamming a traceback each frame.
+//
+// Callbacks belong to the layer whose code registered them (the active owner)
+// and are only invoked by that layer, once per frame of that layer; with
+// several layers open, none sees another's frames, sizes or input. Callbacks
+// registered outside any layer are claimed by the first layer that invokes
+// them.
+//
+// All methods require the GIL.
+//-----------------------------------------------------------------------------
+class FrameCallbacks {
+public:
+    enum class Kind : uint8_t {
+        Frame = 0,   // fn(time, dt)       every rendered frame
+        Resize = 1,  // fn(width, height)  when the layer's pixel size changes
+        Input = 2,   // fn(batch)          packed input events, see yetty_input
+        Idle = 3,    // fn()               frames without new input
+    };
+    static constexpr size_t KIND_COUNT = 4;
+
+    static FrameCallbacks& instance();
+    static bool kindFromName(const char* name, Kind& kind);
+
+    // Owner of callbacks registered from now on (the layer running Python)
+    void setActiveOwner(const void* owner) { _active_owner = owner; }
+    const void* activeOwner() const { return _active_owner; }
+
+    void add(Kind kind, PyObject* callable);
+    bool remove(Kind kind, PyObject* callable);
+    void removeOwner(const void* owner);
+    bool empty(Kind kind) const { return _entries[static_cast<size_t>(kind)].empty(); }
+    // True when invoke() would call something for this owner
+    bool has(Kind kind, const void* owner) const;
+
+    void frame(const void* owner, double time, double dt);
+    void resize(const void* owner, uint32_t width, uint32_t height);
+    void input(const void* owner, PyObject* batch);
+    void idle(const void* owner);
+
+    // New reference: {kind: [{name, calls, errors, total_us, max_us}, ...]}
+    PyObject* stats() const;
+
+    void clear();
+
+private:
+    struct Entry {
+        PyObject* callable = nullptr;  // Owned reference
+        const void* owner = nullptr;
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        uint32_t consecutiveErrors = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        bool removed = false;
+    };
+
+    // args[-1] must be writable (PY_VECTORCALL_ARGUMENTS_OFFSET)
+    void invoke(Kind kind, const void* owner, PyObject* const* args, size_t nargs);
+    void compact(Kind kind);
+
+    std::vector<Entry> _entries[KIND_COUNT];
+    int _depth = 0;  // > 0 while invoking; removal is deferred
+    const void* _active_owner = nullptr;
+
+    // Frame arguments are rewritten in place while only we hold them
+    PyObject* _time = nullptr;
+    PyObject* _dt = nullptr;
+
+    // Resize arguments are reused while the size is unchanged
+    PyObject* _width = nullptr;
+    PyObject* _height = nullptr;
+    uint32_t _last_width = 0;
+    uint32_t _last_height = 0;
+};
+
+} // namespace yetty
@@ -0,0 +1,95 @@
+#include "frame-pacer.h"
+#include <spdlog/spdlog.h>
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace yetty {
+
+// Period estimate limits; a deltaTime outside is a stall, not a refresh rate
+static constexpr double MIN_PERIOD = 1.0 / 360.0;
+static constexpr double MAX_PERIOD = 1.0 / 10.0;
+
+// Exponential moving average weights
+static constexpr double PERIOD_SMOOTHING = 0.1;
+static constexpr double WORK_SMOOTHING = 0.2;
+
+static FramePacer* s_active = nullptr;
+
+FramePacer* FramePacer::active() {
+    return s_active;
+}
+
+void FramePacer::setActive(FramePacer* pacer) {
+    s_active = pacer;
+}
+
+double FramePacer::now() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FramePacer::beginFrame(double dt) {
+    _frame_start = now();
+    _frames++;
+    if (dt >= MIN_PERIOD && dt <= MAX_PERIOD) {
+        _period += (dt - _period) * PERIOD_SMOOTHING;
+    }
+}
+
+bool FramePacer::admitWork() {
+    if (!_pacing || _work_estimate <= 0.0) return true;
+    if (_work_estimate <= remaining()) return true;
+
+    _skipped_frames++;
+    // Decay the estimate so one slow frame does not skip frames forever
+    _work_estimate *= 1.0 - WORK_SMOOTHING;
+    spdlog::debug("FramePacer: skipped frame {}, estimate {:.2f} ms > remaining {:.2f} ms",
+                  _frames, _work_estimate * 1000.0, remaining() * 1000.0);
+    return false;
+}
+
+void FramePacer::beginWork() {
+    _work_start = now();
+}
+
+void FramePacer::endWork() {
+    double end = now();
+    _last_work = end - _work_start;
+    _work_estimate = _work_estimate <= 0.0
+        ? _last_work
+        : _work_estimate + (_last_work - _work_estimate) * WORK_SMOOTHING;
+    if (end > deadline()) {
+        _late_frames++;
+        spdlog::debug("FramePacer: frame {} late by {:.2f} ms",
+                      _frames, (end - deadline()) * 1000.0);
+    }
+}
+
+void FramePacer::setPacing(bool enabled, double budgetFraction) {
+    _pacing = enabled;
+    _budget_fraction = std::clamp(budgetFraction, 0.05, 1.0);
+}
+
+double FramePacer::remaining() const {
+    return std::max(0.0, deadline() - now());
+}
+
+PyObject* FramePacer::info() const {
+    return Py_BuildValue("{s:K,s:d,s:d,s:d,s:O,s:d,s:d,s:d,s:K,s:K}",
+        "frame", (unsigned long long)_frames,
+        "period", _period,
+        "deadline", deadline(),
+        "remaining", remaining(),
+        "pacing", _pacing ? Py_True : Py_False,
+        "budget", _budget_fraction,
+        "work_ms", _work_estimate * 1000.0,
+        "last_work_ms", _last_work * 1000.0,
+        "late_frames", (unsigned long long)_late_frames,
+        "skipped_frames", (unsigned long long)_skipped_frames);
+}
+
+} // namespace yetty
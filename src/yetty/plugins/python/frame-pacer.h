@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+// Forward declare PyObject to avoid including Python.h
+struct _object;
+typedef _object PyObject;
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// FramePacer - frame deadline and budget for a PythonLayer's Python work
+//-----------------------------------------------------------------------------
+// The host does not expose its vsync timestamps, so the frame period is
+// estimated from the render deltaTime and the deadline is taken as the frame
+// start plus the period. Python reads the deadline and remaining budget
+// through yetty_wgpu.frame_info() / remaining_budget().
+//
+// With pacing enabled the layer only calls render_frame when its estimated
+// cost fits in the remaining budget. Otherwise the frame is skipped and the
+// previous image is shown again, rather than stalling the compositor. Work
+// that still ends past the deadline is counted as a late frame.
+//-----------------------------------------------------------------------------
+class FramePacer {
+public:
+    // Pacer of the layer currently running Python, nullptr outside any layer
+    static FramePacer* active();
+    static void setActive(FramePacer* pacer);
+
+    // Seconds on the steady clock (same clock as time.monotonic() on Linux)
+    static double now();
+
+    void beginFrame(double dt);
+
+    // Paced mode: whether render_frame is expected to finish in the budget.
+    // A false result counts the frame as skipped.
+    bool admitWork();
+    void beginWork();
+    void endWork();
+
+    void setPacing(bool enabled, double budgetFraction);
+    bool pacing() const { return _pacing; }
+
+    double period() const { return _period; }
+    double deadline() const { return _frame_start + _period * _budget_fraction; }
+    double remaining() const;
+
+    // New reference: {frame, period, deadline, remaining, pacing, budget,
+    //                 work_ms, last_work_ms, late_frames, skipped_frames}
+    PyObject* info() const;
+
+private:
+    bool _pacing = false;
+    double _budget_fraction = 0.75;  // Share of the period Python may use
+
+    double _period = 1.0 / 60.0;
+    double _frame_start = 0.0;
+    double _work_start = 0.0;
+    double _work_estimate = 0.0;     // EMA of render_frame time
+    double _last_work = 0.0;
+
+    uint64_t _frames = 0;
+    uint64_t _late_frames = 0;
+    uint64_t _skipped_frames = 0;
+};
+
+} // namespace yetty
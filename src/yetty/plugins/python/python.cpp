@@ -1,4 +1,6 @@
 #include "python.h"
+#include "frame-callbacks.h"
+#include "perf-stages.h"
 #include "yetty_wgpu.h"
 #include <yetty/yetty.h>
 #include <yetty/webgpu-context.h>
@@ -11,6 +13,8 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 
 namespace fs = std::filesystem;
@@ -45,6 +49,12 @@ static bool setupPythonPackages() {
         return true;
     }
 
+    // Headless users (benchmarks, CI) only need the interpreter itself
+    if (std::getenv("YETTY_PYTHON_NO_INSTALL")) {
+        spdlog::info("YETTY_PYTHON_NO_INSTALL set - not installing Python packages");
+        return true;
+    }
+
     // Create the directory
     spdlog::info("Installing pygfx and fastplotlib to {}...", pkgPath);
     fs::create_directories(pkgPath);
@@ -109,6 +119,10 @@ Result<void> PythonPlugin::initPython() {
     setenv("YETTY_WGPU_LIB_PATH", wgpuLibPath.c_str(), 1);
     spdlog::info("Set YETTY_WGPU_LIB_PATH={}", wgpuLibPath);
 
+    // yetty_pool starts its worker processes from the embedded interpreter binary
+    std::string pythonExe = std::string(CMAKE_BINARY_DIR) + "/python/install/bin/python3";
+    setenv("YETTY_PYTHON_EXECUTABLE", pythonExe.c_str(), 1);
+
     // Register yetty_wgpu as a built-in module BEFORE Py_Initialize
     if (PyImport_AppendInittab("yetty_wgpu", PyInit_yetty_wgpu) == -1) {
         return Err<void>("Failed to register yetty_wgpu module");
@@ -167,15 +181,126 @@ Result<void> PythonPlugin::initPython() {
         PyRun_SimpleString(code.c_str());
     }
 
+    initMemoryTracking();
+
     return Ok();
 }
 
+// Call module.method(arg) if a script imported the module; arg is stolen and
+// may be null for no argument. Nothing is imported just to make the call.
+static void callLoadedModule(const char* module, const char* method, PyObject* arg) {
+    PyObject* name = PyUnicode_FromString(module);
+    PyObject* mod = PyImport_GetModule(name);
+    Py_DECREF(name);
+    if (!mod) {
+        if (PyErr_Occurred()) PyErr_Clear();
+        Py_XDECREF(arg);
+        return;
+    }
+    PyObject* methodName = PyUnicode_FromString(method);
+    PyObject* result = arg ? PyObject_CallMethodOneArg(mod, methodName, arg)
+                           : PyObject_CallMethodNoArgs(mod, methodName);
+    Py_DECREF(methodName);
+    Py_XDECREF(arg);
+    if (!result) {
+        PyErr_Print();
+        PyErr_Clear();
+    }
+    Py_XDECREF(result);
+    Py_DECREF(mod);
+}
+
+//-----------------------------------------------------------------------------
+// Memory accounting
+//-----------------------------------------------------------------------------
+// tracemalloc is used rather than PyMem allocator hooks because it also sees
+// numpy array data, which numpy allocates outside the PyMem domains. Limits
+// come from YETTY_PYTHON_SOFT_LIMIT_MB / YETTY_PYTHON_HARD_LIMIT_MB and are
+// off by default; tracing (and its allocation overhead) only starts when a
+// limit is set or a layer asks for %memory.
+
+static constexpr size_t DEFAULT_SOFT_LIMIT_MB = 0;
+static constexpr size_t DEFAULT_HARD_LIMIT_MB = 0;
+
+static size_t limitFromEnv(const char* name, size_t defaultMb) {
+    const char* value = std::getenv(name);
+    size_t mb = defaultMb;
+    if (value && value[0] != '\0') {
+        mb = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+    }
+    return mb * 1024 * 1024;
+}
+
+void PythonPlugin::initMemoryTracking() {
+    _soft_memory_limit = limitFromEnv("YETTY_PYTHON_SOFT_LIMIT_MB", DEFAULT_SOFT_LIMIT_MB);
+    _hard_memory_limit = limitFromEnv("YETTY_PYTHON_HARD_LIMIT_MB", DEFAULT_HARD_LIMIT_MB);
+    if (_soft_memory_limit == 0 && _hard_memory_limit == 0) {
+        return;
+    }
+    if (startMemoryTracking()) {
+        spdlog::info("PythonPlugin: memory limits soft {} MB, hard {} MB",
+                     _soft_memory_limit >> 20, _hard_memory_limit >> 20);
+    } else {
+        spdlog::warn("PythonPlugin: failed to start tracemalloc, memory limits disabled");
+    }
+}
+
+bool PythonPlugin::startMemoryTracking() {
+    if (_get_traced_memory) return true;
+    if (!_py_initialized) return false;
+
+    PyObject* tracemalloc = PyImport_ImportModule("tracemalloc");
+    if (!tracemalloc) {
+        PyErr_Clear();
+        return false;
+    }
+    // One frame per trace keeps the bookkeeping small; only totals are used
+    PyObject* started = PyObject_CallMethod(tracemalloc, "start", "i", 1);
+    Py_XDECREF(started);
+    if (started) {
+        _get_traced_memory = PyObject_GetAttrString(tracemalloc, "get_traced_memory");
+    }
+    Py_DECREF(tracemalloc);
+    if (!_get_traced_memory) {
+        PyErr_Clear();
+        return false;
+    }
+    return true;
+}
+
+int64_t PythonPlugin::tracedBytes() {
+    if (!_get_traced_memory) return -1;
+    PyObject* result = PyObject_CallNoArgs(_get_traced_memory);
+    if (!result) {
+        PyErr_Clear();
+        return -1;
+    }
+    int64_t current = -1;
+    if (PyTuple_Check(result) && PyTuple_GET_SIZE(result) >= 1) {
+        current = PyLong_AsLongLong(PyTuple_GET_ITEM(result, 0));
+        if (PyErr_Occurred()) {
+            PyErr_Clear();
+            current = -1;
+        }
+    }
+    Py_DECREF(result);
+    return current;
+}
+
 Result<void> PythonPlugin::dispose() {
     // Dispose layers first
     if (auto res = Plugin::dispose(); !res) {
         return Err<void>("Failed to dispose PythonPlugin base", res);
     }
 
+    // Drop callbacks registered by scripts while the interpreter is still alive
+    if (_py_initialized) {
+        callLoadedModule("yetty_pool", "shutdown", nullptr);
+        FrameCallbacks::instance().clear();
+        Py_XDECREF(_get_traced_memory);
+        _get_traced_memory = nullptr;
+    }
+
     // Cleanup yetty_wgpu resources
     yetty_wgpu_cleanup();
 
@@ -285,10 +410,69 @@ Result<void> PythonPlugin::runFile(const std::string& path) {
     return Ok();
 }
 
+Result<std::string> PythonPlugin::callFunction(const std::string& module,
+                                               const std::string& func,
+                                               const std::vector<std::string>& args) {
+    if (!_py_initialized) {
+        return Err<std::string>("Python not initialized");
+    }
+
+    PyObject* mod = PyImport_ImportModule(module.c_str());
+    if (!mod) {
+        PyErr_Print();
+        PyErr_Clear();
+        return Err<std::string>("Failed to import " + module);
+    }
+    PyObject* callable = PyObject_GetAttrString(mod, func.c_str());
+    Py_DECREF(mod);
+    if (!callable) {
+        PyErr_Clear();
+        return Err<std::string>(module + "." + func + " not found");
+    }
+
+    PyObject* tuple = PyTuple_New(static_cast<Py_ssize_t>(args.size()));
+    for (size_t i = 0; i < args.size(); ++i) {
+        PyTuple_SET_ITEM(tuple, i, PyUnicode_FromStringAndSize(args[i].data(), args[i].size()));
+    }
+    PyObject* result = PyObject_CallObject(callable, tuple);
+    Py_DECREF(tuple);
+    Py_DECREF(callable);
+
+    if (!result) {
+        PyErr_Print();
+        PyErr_Clear();
+        return Err<std::string>(module + "." + func + " raised an exception");
+    }
+
+    std::string output;
+    PyObject* str = PyObject_Str(result);
+    if (str) {
+        const char* utf8 = PyUnicode_AsUTF8(str);
+        if (utf8) output = utf8;
+        Py_DECREF(str);
+    }
+    Py_DECREF(result);
+    return Ok(output);
+}
+
 //-----------------------------------------------------------------------------
 // PythonLayer
 //-----------------------------------------------------------------------------
 
+// Scripts using "# %%" markers are run as reactive cells
+static bool hasCellMarkers(const std::string& source) {
+    size_t pos = 0;
+    while (pos < source.size()) {
+        if (source.compare(pos, 4, "# %%") == 0 || source.compare(pos, 3, "#%%") == 0) {
+            return true;
+        }
+        pos = source.find('\n', pos);
+        if (pos == std::string::npos) break;
+        ++pos;
+    }
+    return false;
+}
+
 PythonLayer::PythonLayer(PythonPlugin* plugin)
     : _plugin(plugin) {}
 
@@ -299,14 +483,27 @@ PythonLayer::~PythonLayer() {
 Result<void> PythonLayer::init(const std::string& payload) {
     _payload = payload;
 
+    beginPython();
+
     // Payload can be a Python script path or inline code
     if (!payload.empty()) {
         // Check if it's a file path
         std::ifstream test(payload);
         if (test.good()) {
             _script_path = payload;
+            std::stringstream source;
+            source << test.rdbuf();
             test.close();
 
+            if (hasCellMarkers(source.str())) {
+                if (auto res = loadCells(source.str()); !res) {
+                    _output = "Error: " + res.error().message();
+                }
+                endPython();
+                _initialized = true;
+                return Ok();
+            }
+
             // Execute the script
             auto result = _plugin->runFile(_script_path);
             if (!result) {
@@ -326,6 +523,7 @@ Result<void> PythonLayer::init(const std::string& payload) {
         }
     }
 
+    endPython();
     _initialized = true;
     return Ok();
 }
@@ -346,8 +544,25 @@ Result<void> PythonLayer::dispose() {
     }
     _blit_initialized = false;
 
+    _input_events.clear();
+
     // Cleanup pygfx resources (only if Python is still initialized)
     if (_plugin && _plugin->isInitialized()) {
+        FrameCallbacks::instance().removeOwner(this);
+
+        // Drop this layer's cell graph; layers that never used cells skip the import
+        if (_cells_mode) {
+            (void)_plugin->callFunction("yetty_cells", "reset", {cellsKey()});
+            _cells_mode = false;
+        }
+
+        // Forget this layer's input handlers and cancel its process-pool work;
+        // other layers keep theirs
+        callLoadedModule("yetty_input", "forget_layer",
+                         PyLong_FromUnsignedLongLong(reinterpret_cast<uintptr_t>(this)));
+        callLoadedModule("yetty_pool", "cancel_layer",
+                         PyLong_FromUnsignedLongLong(reinterpret_cast<uintptr_t>(this)));
+
         if (_render_frame_func) {
             Py_DECREF(_render_frame_func);
             _render_frame_func = nullptr;
@@ -378,6 +593,7 @@ Result<void> PythonLayer::dispose() {
 Result<void> PythonLayer::render(WebGPUContext& ctx) {
     if (_failed) return Err<void>("PythonLayer already failed");
     if (!_visible) return Ok();
+    if (_memory_stopped) return Ok();
 
     // Initialize pygfx on first render if not already done
     if (!_wgpu_handles_set) {
@@ -394,21 +610,69 @@ Result<void> PythonLayer::render(WebGPUContext& ctx) {
         spdlog::info("PythonLayer: WebGPU handles set for yetty_wgpu");
     }
 
-    // Try to get render_frame function if not already cached
-    if (!_render_frame_func) {
-        _pygfx_module = PyImport_ImportModule("yetty_pygfx");
+    const auto& rc = _render_context;
+    _pacer.beginFrame(rc.deltaTime);
+    beginPython();
+
+    // Per-frame callbacks registered through yetty_wgpu.register_callback()
+    auto& callbacks = FrameCallbacks::instance();
+    bool hadInput = !_input_events.empty();
+    deliverInput();
+
+    uint32_t pixelW = static_cast<uint32_t>(_width_cells * rc.cellWidth);
+    uint32_t pixelH = static_cast<uint32_t>(_height_cells * rc.cellHeight);
+    if (pixelW > 0 && pixelH > 0 && (pixelW != _pixel_width_seen || pixelH != _pixel_height_seen)) {
+        _pixel_width_seen = pixelW;
+        _pixel_height_seen = pixelH;
+        callbacks.resize(this, pixelW, pixelH);
+    }
+
+    _frame_time += rc.deltaTime;
+    {
+        PerfStages::Scope stage("python.callbacks");
+        callbacks.frame(this, _frame_time, rc.deltaTime);
+    }
+
+    // Try to get render_frame function if not already cached. A failed import
+    // is retried with exponential backoff instead of on every frame.
+    double now = std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (!_render_frame_func && now >= _pygfx_retry_at) {
+        if (!_pygfx_module) {
+            _pygfx_module = PyImport_ImportModule("yetty_pygfx");
+        }
         if (_pygfx_module) {
             _render_frame_func = PyObject_GetAttrString(_pygfx_module, "render_frame");
-            if (_render_frame_func) {
-                _pygfx_initialized = true;
-                spdlog::info("PythonLayer: yetty_pygfx.render_frame cached");
-            }
+        }
+        if (_render_frame_func) {
+            _pygfx_initialized = true;
+            _pygfx_backoff = 0.0;
+            spdlog::info("PythonLayer: yetty_pygfx.render_frame cached");
+        } else {
+            PyErr_Clear();
+            _pygfx_backoff = std::min(PYGFX_RETRY_MAX, std::max(PYGFX_RETRY_MIN, _pygfx_backoff * 2.0));
+            _pygfx_retry_at = now + _pygfx_backoff;
+            spdlog::debug("PythonLayer: yetty_pygfx unavailable, retrying in {:.0f}s", _pygfx_backoff);
         }
     }
 
     // If pygfx is initialized, render it
-    if (_pygfx_initialized && _render_frame_func) {
-        bool pygfx_ok = renderPygfx();
+    bool pygfxReady = _pygfx_initialized && _render_frame_func;
+    bool pygfx_ok = false;
+    if (pygfxReady && _pacer.admitWork()) {
+        _pacer.beginWork();
+        PerfStages::Scope stage("python.render_frame");
+        pygfx_ok = renderPygfx();
+        _pacer.endWork();
+    }
+
+    // Idle callbacks get what is left; with pacing on, only if budget remains
+    if (!hadInput && (!_pacer.pacing() || _pacer.remaining() > 0.0)) {
+        callbacks.idle(this);
+    }
+    endPython();
+
+    if (pygfxReady && !_memory_stopped) {
         bool blit_ok = blitRenderTexture(ctx);
         // Log first successful frame
         static bool logged = false;
@@ -499,15 +763,15 @@ bool PythonLayer::renderPygfx() {
         return false;
     }
 
-    // Call render_frame()
-    PyObject* result = PyObject_CallObject(_render_frame_func, nullptr);
+    // Call render_frame() - vectorcall, no argument tuple
+    PyObject* result = PyObject_CallNoArgs(_render_frame_func);
     if (!result) {
         PyErr_Print();
         PyErr_Clear();
         return false;
     }
 
-    bool success = PyObject_IsTrue(result);
+    bool success = result == Py_True || (result != Py_False && PyObject_IsTrue(result) > 0);
     Py_DECREF(result);
 
     return success;
@@ -752,15 +1016,228 @@ bool PythonLayer::blitRenderTexture(WebGPUContext& ctx) {
     return true;
 }
 
+Result<void> PythonLayer::loadCells(const std::string& source) {
+    _cells_mode = true;
+    auto result = _plugin->callFunction("yetty_cells", "load_script", {cellsKey(), source});
+    if (!result) {
+        return Err<void>("Failed to run cells", result);
+    }
+    _output += *result;
+    return Ok();
+}
+
+// %cell NAME CODE  - define/replace a cell, re-running it and its dependents
+// %reload          - re-read the script, re-running only changed cells
+// %cells           - list cells with their state and dependencies
+// %memory          - memory charged to this layer and the limits
+std::string PythonLayer::runCommand(const std::string& command) {
+    Result<std::string> result = Err<std::string>("Unknown command: " + command);
+
+    if (command == "%memory") {
+        // Tracing starts on first use; usage before that is not attributed
+        std::string note;
+        if (_plugin->tracedBytes() < 0) {
+            if (!_plugin->startMemoryTracking()) {
+                return "Memory tracking is unavailable\n";
+            }
+            note = "Memory tracking started; layers are charged from now on\n";
+        }
+        auto limit = [](size_t bytes) {
+            return bytes ? std::to_string(bytes >> 20) + " MB" : std::string("off");
+        };
+        return note + "layer " + std::to_string(_memory_bytes >> 20) + " MB, interpreter " +
+               std::to_string(std::max<int64_t>(0, _plugin->tracedBytes()) >> 20) +
+               " MB, soft limit " + limit(_plugin->softMemoryLimit()) + ", hard limit " +
+               limit(_plugin->hardMemoryLimit()) + (_memory_stopped ? " (stopped)" : "") + "\n";
+    }
+    if (_memory_stopped) {
+        return "Layer stopped: memory limit exceeded\n";
+    }
+
+    if (command.rfind("%cell ", 0) == 0) {
+        std::string rest = command.substr(6);
+        size_t split = rest.find(' ');
+        if (split == std::string::npos) {
+            return "Usage: %cell NAME CODE\n";
+        }
+        _cells_mode = true;
+        result = _plugin->callFunction("yetty_cells", "set_cell",
+                                       {cellsKey(), rest.substr(0, split), rest.substr(split + 1)});
+    } else if (command == "%reload") {
+        std::ifstream file(_script_path);
+        if (_script_path.empty() || !file.is_open()) {
+            return "No script to reload\n";
+        }
+        std::stringstream source;
+        source << file.rdbuf();
+        _cells_mode = true;
+        result = _plugin->callFunction("yetty_cells", "load_script", {cellsKey(), source.str()});
+    } else if (command == "%cells") {
+        if (!_cells_mode) {
+            return "no cells\n";
+        }
+        result = _plugin->callFunction("yetty_cells", "describe", {cellsKey()});
+    }
+
+    if (!result) {
+        return "Error: " + result.error().message() + "\n";
+    }
+    return *result;
+}
+
+//-----------------------------------------------------------------------------
+// Execution scope and memory limits
+//-----------------------------------------------------------------------------
+
+// REPL output kept per layer; older lines are dropped
+static constexpr size_t MAX_OUTPUT_BYTES = 64 * 1024;
+
+void PythonLayer::beginPython() {
+    FrameCallbacks::instance().setActiveOwner(this);
+    FramePacer::setActive(&_pacer);
+    _slice_start = _plugin ? _plugin->tracedBytes() : -1;
+}
+
+void PythonLayer::endPython() {
+    if (_slice_start >= 0) {
+        int64_t now = _plugin->tracedBytes();
+        if (now >= 0) {
+            _memory_bytes = std::max<int64_t>(0, _memory_bytes + (now - _slice_start));
+        }
+        _slice_start = -1;
+        checkMemoryLimits();
+    }
+    FrameCallbacks::instance().setActiveOwner(nullptr);
+    FramePacer::setActive(nullptr);
+    trimOutput();
+}
+
+void PythonLayer::checkMemoryLimits() {
+    if (_memory_stopped) return;
+    auto soft = static_cast<int64_t>(_plugin->softMemoryLimit());
+    auto hard = static_cast<int64_t>(_plugin->hardMemoryLimit());
+
+    if (soft > 0 && _memory_bytes > soft && !_memory_warned) {
+        // Reclaim cycles first; what the collector frees was this layer's
+        int64_t before = _plugin->tracedBytes();
+        PyGC_Collect();
+        int64_t after = _plugin->tracedBytes();
+        if (before >= 0 && after >= 0) {
+            _memory_bytes = std::max<int64_t>(0, _memory_bytes + (after - before));
+        }
+        if (_memory_bytes > soft) {
+            _memory_warned = true;
+            spdlog::warn("PythonLayer: {} MB over the soft memory limit of {} MB",
+                         _memory_bytes >> 20, soft >> 20);
+            _output += "Warning: layer uses " + std::to_string(_memory_bytes >> 20) +
+                       " MB (soft limit " + std::to_string(soft >> 20) + " MB)\n";
+        }
+    } else if (_memory_warned && _memory_bytes < soft - soft / 10) {
+        _memory_warned = false;
+    }
+
+    if (hard > 0 && _memory_bytes > hard) {
+        _memory_stopped = true;
+        FrameCallbacks::instance().removeOwner(this);
+        spdlog::error("PythonLayer: stopped, {} MB exceeds the hard memory limit of {} MB",
+                      _memory_bytes >> 20, hard >> 20);
+        _output += "Stopped: layer uses " + std::to_string(_memory_bytes >> 20) +
+                   " MB (hard limit " + std::to_string(hard >> 20) + " MB)\n";
+    }
+}
+
+void PythonLayer::trimOutput() {
+    if (_output.size() <= MAX_OUTPUT_BYTES) return;
+    size_t cut = _output.size() - MAX_OUTPUT_BYTES;
+    size_t newline = _output.find('\n', cut);
+    _output.erase(0, newline == std::string::npos ? cut : newline + 1);
+}
+
+//-----------------------------------------------------------------------------
+// Input batching
+//-----------------------------------------------------------------------------
+// Events are queued here and handed to yetty_input once per frame as a single
+// bytes object, so a burst of input costs one interpreter call. Consecutive
+// mouse moves collapse into one; the queue is bounded if Python never reads.
+
+static constexpr size_t MAX_QUEUED_INPUT = 4096;
+
+void PythonLayer::queueInput(const InputEvent& event) {
+    if (event.type == InputEvent::MouseMove && !_input_events.empty() &&
+        _input_events.back().type == InputEvent::MouseMove) {
+        _input_events.back() = event;
+        return;
+    }
+    if (_input_events.size() >= MAX_QUEUED_INPUT) {
+        _input_events.erase(_input_events.begin(),
+                            _input_events.begin() + MAX_QUEUED_INPUT / 2);
+    }
+    _input_events.push_back(event);
+}
+
+void PythonLayer::deliverInput() {
+    if (_input_events.empty()) return;
+
+    // yetty_input registers an input callback for each layer that uses it
+    auto& callbacks = FrameCallbacks::instance();
+    if (!callbacks.has(FrameCallbacks::Kind::Input, this)) {
+        _input_events.clear();
+        return;
+    }
+
+    PyObject* batch = PyBytes_FromStringAndSize(
+        reinterpret_cast<const char*>(_input_events.data()),
+        static_cast<Py_ssize_t>(_input_events.size() * sizeof(InputEvent)));
+    _input_events.clear();
+    if (!batch) {
+        PyErr_Clear();
+        return;
+    }
+
+    callbacks.input(this, batch);
+    Py_DECREF(batch);
+}
+
+bool PythonLayer::onMouseMove(float x, float y) {
+    _mouse_x = x;
+    _mouse_y = y;
+    queueInput({InputEvent::MouseMove, 0, 0, 0, x, y});
+    return true;
+}
+
+bool PythonLayer::onMouseButton(int button, bool pressed) {
+    queueInput({InputEvent::MouseButton, button, pressed ? 1 : 0, 0, _mouse_x, _mouse_y});
+    return true;
+}
+
+bool PythonLayer::onMouseScroll(float xoffset, float yoffset, int mods) {
+    queueInput({InputEvent::Scroll, 0, 0, mods, xoffset, yoffset});
+    return true;
+}
+
 bool PythonLayer::onKey(int key, int scancode, int action, int mods) {
     (void)scancode;
-    (void)mods;
+
+    queueInput({InputEvent::Key, key, action, mods, _mouse_x, _mouse_y});
 
     if (action != 1) return false; // GLFW_PRESS only
 
     // Enter key - execute input buffer
     if (key == 257) { // GLFW_KEY_ENTER
+        if (!_input_buffer.empty() && _input_buffer[0] == '%') {
+            beginPython();
+            _output += ">>> " + _input_buffer + "\n" + runCommand(_input_buffer);
+            _input_buffer.clear();
+            endPython();
+            return true;
+        }
+        if (!_input_buffer.empty() && _memory_stopped) {
+            _output += ">>> " + _input_buffer + "\nLayer stopped: memory limit exceeded\n";
+            _input_buffer.clear();
+            return true;
+        }
         if (!_input_buffer.empty()) {
+            beginPython();
             auto result = _plugin->execute(_input_buffer);
             if (result) {
                 _output += ">>> " + _input_buffer + "\n" + *result;
@@ -768,14 +1245,19 @@ bool PythonLayer::onKey(int key, int scancode, int action, int mods) {
                 _output += ">>> " + _input_buffer + "\nError: " + result.error().message() + "\n";
             }
             _input_buffer.clear();
+            endPython();
             return true;
         }
     }
 
-    // Backspace - remove last character
+    // Backspace - remove last character (a whole UTF-8 sequence)
     if (key == 259) { // GLFW_KEY_BACKSPACE
         if (!_input_buffer.empty()) {
-            _input_buffer.pop_back();
+            while (!_input_buffer.empty() &&
+                   (static_cast<unsigned char>(_input_buffer.back()) & 0xC0) == 0x80) {
+                _input_buffer.pop_back();
+            }
+            if (!_input_buffer.empty()) _input_buffer.pop_back();
             return true;
         }
     }
@@ -784,11 +1266,29 @@ bool PythonLayer::onKey(int key, int scancode, int action, int mods) {
 }
 
 bool PythonLayer::onChar(unsigned int codepoint) {
-    if (codepoint < 128) {
+    if (codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return false;
+    }
+
+    queueInput({InputEvent::Char, static_cast<int32_t>(codepoint), 0, 0, _mouse_x, _mouse_y});
+
+    // UTF-8 encode into the REPL line
+    if (codepoint < 0x80) {
         _input_buffer += static_cast<char>(codepoint);
-        return true;
+    } else if (codepoint < 0x800) {
+        _input_buffer += static_cast<char>(0xC0 | (codepoint >> 6));
+        _input_buffer += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        _input_buffer += static_cast<char>(0xE0 | (codepoint >> 12));
+        _input_buffer += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        _input_buffer += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        _input_buffer += static_cast<char>(0xF0 | (codepoint >> 18));
+        _input_buffer += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        _input_buffer += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        _input_buffer += static_cast<char>(0x80 | (codepoint & 0x3F));
     }
-    return false;
+    return true;
 }
 
 } // namespace yetty
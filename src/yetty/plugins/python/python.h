@@ -1,9 +1,12 @@
 #pragma once
 
 #include <yetty/plugin.h>
+#include "frame-pacer.h"
 #include <webgpu/webgpu.h>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Forward declare Python types to avoid including Python.h in header
 struct _object;
@@ -34,17 +37,34 @@ public:
     // Run a Python file
     Result<void> runFile(const std::string& path);
 
+    // Call module.func(*args) with string arguments, returning str(result)
+    Result<std::string> callFunction(const std::string& module, const std::string& func,
+                                     const std::vector<std::string>& args);
+
     // Check if Python is initialized
     bool isInitialized() const { return _py_initialized; }
 
+    // Bytes currently traced by tracemalloc, -1 while tracking is off.
+    // Layers attribute the change across their own Python work to themselves.
+    int64_t tracedBytes();
+    // Start tracemalloc if it is not running; false if it cannot be started
+    bool startMemoryTracking();
+    size_t softMemoryLimit() const { return _soft_memory_limit; }
+    size_t hardMemoryLimit() const { return _hard_memory_limit; }
+
 private:
     explicit PythonPlugin(YettyPtr engine) noexcept : Plugin(std::move(engine)) {}
     Result<void> init() noexcept override;
     Result<void> initPython();
+    void initMemoryTracking();
 
     bool _py_initialized = false;
     PyObject* _main_module = nullptr;
     PyObject* _main_dict = nullptr;
+
+    size_t _soft_memory_limit = 0;
+    size_t _hard_memory_limit = 0;
+    PyObject* _get_traced_memory = nullptr;  // tracemalloc.get_traced_memory
 };
 
 //-----------------------------------------------------------------------------
@@ -66,10 +86,14 @@ public:
     Result<void> render(WebGPUContext& ctx) override;
     bool renderToPass(WGPURenderPassEncoder pass, WebGPUContext& ctx) override;
 
-    // Input handling for REPL-like interaction
+    // Input handling: REPL editing, plus a per-frame batch for yetty_input
     bool onKey(int key, int scancode, int action, int mods) override;
     bool onChar(unsigned int codepoint) override;
+    bool onMouseMove(float x, float y) override;
+    bool onMouseButton(int button, bool pressed) override;
+    bool onMouseScroll(float xoffset, float yoffset, int mods) override;
     bool wantsKeyboard() const override { return true; }
+    bool wantsMouse() const override { return true; }
 
     // pygfx integration
     bool initPygfx(WebGPUContext& ctx, uint32_t width, uint32_t height);
@@ -78,6 +102,36 @@ public:
     bool isPygfxInitialized() const { return _pygfx_initialized; }
 
 private:
+    // Notebook cells (yetty_cells): "# %%" scripts and %-commands in the REPL
+    Result<void> loadCells(const std::string& source);
+    std::string runCommand(const std::string& command);
+    // Key of this layer's cell graph in yetty_cells
+    std::string cellsKey() const { return std::to_string(reinterpret_cast<uintptr_t>(this)); }
+
+    // Python work for this layer runs between beginPython() and endPython():
+    // callbacks registered meanwhile belong to it, and the tracemalloc delta
+    // is charged to it. Over the soft limit a GC runs and a warning is shown;
+    // over the hard limit the layer stops running Python.
+    void beginPython();
+    void endPython();
+    void checkMemoryLimits();
+    void trimOutput();
+
+    // Packed record handed to yetty_input; layout must match EVENT_FORMAT
+    struct InputEvent {
+        enum Type : uint32_t { Key = 1, Char = 2, MouseMove = 3, MouseButton = 4, Scroll = 5 };
+        uint32_t type;
+        int32_t code;
+        int32_t action;
+        int32_t mods;
+        float x;
+        float y;
+    };
+    static_assert(sizeof(InputEvent) == 24, "InputEvent must stay packed");
+
+    void queueInput(const InputEvent& event);
+    void deliverInput();
+
     PythonPlugin* _plugin = nullptr;
     std::string _name = "python";
     std::string _script_path;
@@ -86,15 +140,37 @@ private:
     bool _initialized = false;
     bool _failed = false;
     bool _running = false;
+    bool _cells_mode = false;  // This layer has a cell graph in yetty_cells
+
+    // Memory attributed to this layer's Python work
+    int64_t _memory_bytes = 0;
+    int64_t _slice_start = -1;
+    bool _memory_warned = false;
+    bool _memory_stopped = false;
 
     // For rendering output
     float _scroll_offset = 0.0f;
 
+    // Input queued since the last frame
+    std::vector<InputEvent> _input_events;
+    float _mouse_x = 0.0f;
+    float _mouse_y = 0.0f;
+
+    // Frame callback state
+    FramePacer _pacer;
+    double _frame_time = 0.0;
+    uint32_t _pixel_width_seen = 0;
+    uint32_t _pixel_height_seen = 0;
+
     // pygfx integration state
     bool _pygfx_initialized = false;
     bool _wgpu_handles_set = false;
     PyObject* _pygfx_module = nullptr;
     PyObject* _render_frame_func = nullptr;
+    double _pygfx_retry_at = 0.0;   // Negative cache for a failed import
+    double _pygfx_backoff = 0.0;
+    static constexpr double PYGFX_RETRY_MIN = 1.0;
+    static constexpr double PYGFX_RETRY_MAX = 30.0;
     uint32_t _texture_width = 0;
     uint32_t _texture_height = 0;
 
@@ -0,0 +1,196 @@
+"""
+yetty_cells - Reactive notebook cells for the Python layer REPL.
+
+A script split with "# %%" markers (or cells entered with %cell) becomes an
+ordered list of cells. The names each cell defines and uses are found with
+ast; a cell depends on the latest earlier cell that defines a name it uses.
+When a cell's source changes only that cell and its dependents run again,
+unchanged cells keep their cached output.
+
+Every layer keeps its own cell graph, keyed by the layer id the plugin
+passes as the first argument; cells still run in __main__ like the REPL.
+"""
+
+import ast
+import builtins
+import contextlib
+import io
+import re
+import traceback
+
+import __main__
+
+_CELL_MARKER = re.compile(r"^#\s?%%(.*)$")
+_BUILTINS = frozenset(dir(builtins))
+
+
+class Cell:
+    __slots__ = ("name", "source", "defines", "uses", "deps", "output", "ok", "stale")
+
+    def __init__(self, name, source):
+        self.name = name
+        self.source = source
+        self.defines, self.uses = _analyze(source)
+        self.deps = frozenset()
+        self.output = ""
+        self.ok = False
+        self.stale = True
+
+
+_graphs = {}  # layer id -> {name -> Cell}, in execution order
+
+
+def _cells(layer):
+    return _graphs.setdefault(layer, {})
+
+
+def _analyze(source):
+    """Return (defined names, used free names) of a cell; over-approximates."""
+    try:
+        tree = ast.parse(source)
+    except SyntaxError:
+        return frozenset(), frozenset()
+
+    defines, uses = set(), set()
+    for node in ast.walk(tree):
+        if isinstance(node, ast.Name):
+            if isinstance(node.ctx, ast.Load):
+                uses.add(node.id)
+            else:
+                defines.add(node.id)
+        elif isinstance(node, ast.AugAssign) and isinstance(node.target, ast.Name):
+            uses.add(node.target.id)
+        elif isinstance(node, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef)):
+            defines.add(node.name)
+        elif isinstance(node, (ast.Import, ast.ImportFrom)):
+            for alias in node.names:
+                if alias.name != "*":
+                    defines.add((alias.asname or alias.name).split(".")[0])
+    return frozenset(defines), frozenset(uses - _BUILTINS)
+
+
+def _resolve_deps(cells):
+    """Recompute edges; a cell whose providers changed is stale too."""
+    last_definer = {}
+    for cell in cells.values():
+        deps = frozenset(last_definer[n] for n in cell.uses if n in last_definer)
+        if deps != cell.deps:
+            cell.deps = deps
+            cell.stale = True
+        for name in cell.defines:
+            last_definer[name] = cell.name
+
+
+def _execute(cell):
+    out = io.StringIO()
+    with contextlib.redirect_stdout(out), contextlib.redirect_stderr(out):
+        try:
+            exec(compile(cell.source, f"<cell {cell.name}>", "exec"), __main__.__dict__)
+            cell.ok = True
+        except Exception:
+            traceback.print_exc()
+            cell.ok = False
+    cell.output = out.getvalue()
+    cell.stale = not cell.ok
+
+
+def run_stale(layer):
+    """Run stale cells and their dependents in order; returns a report."""
+    cells = _cells(layer)
+    _resolve_deps(cells)
+    ran, cached, skipped = [], [], []
+    rerun = set()
+    failed = set()
+    for cell in cells.values():
+        if cell.deps & failed:
+            cell.stale = True
+            failed.add(cell.name)
+            skipped.append(cell.name)
+            continue
+        if cell.stale or cell.deps & rerun:
+            _execute(cell)
+            rerun.add(cell.name)
+            ran.append(cell)
+            if not cell.ok:
+                failed.add(cell.name)
+        else:
+            cached.append(cell.name)
+
+    lines = []
+    for cell in ran:
+        status = "ok" if cell.ok else "error"
+        lines.append(f"[{cell.name}] {status}")
+        if cell.output:
+            lines.append(cell.output.rstrip("\n"))
+    if cached:
+        lines.append("cached: " + ", ".join(cached))
+    if skipped:
+        lines.append("skipped (upstream error): " + ", ".join(skipped))
+    return "\n".join(lines) + "\n" if lines else ""
+
+
+def set_cell(layer, name, source):
+    """Define or replace one cell and re-run what depends on it."""
+    cells = _cells(layer)
+    cell = cells.get(name)
+    if cell is None or cell.source != source:
+        cells[name] = Cell(name, source)
+    return run_stale(layer)
+
+
+def split_cells(source):
+    """Split a script on "# %%" markers into (name, source) pairs."""
+    cells, name, lines = [], None, []
+    for line in source.splitlines():
+        match = _CELL_MARKER.match(line)
+        if match:
+            if lines and any(l.strip() for l in lines):
+                cells.append((name or f"cell{len(cells)}", "\n".join(lines) + "\n"))
+            name, lines = match.group(1).strip() or None, []
+        else:
+            lines.append(line)
+    if lines and any(l.strip() for l in lines):
+        cells.append((name or f"cell{len(cells)}", "\n".join(lines) + "\n"))
+    return cells
+
+
+def has_cells(source):
+    return any(_CELL_MARKER.match(line) for line in source.splitlines())
+
+
+def load_script(layer, source):
+    """Replace the cell list with the script's cells, keeping unchanged ones."""
+    previous = _cells(layer)
+    cells = {}
+    for name, text in split_cells(source):
+        old = previous.get(name)
+        cells[name] = old if old is not None and old.source == text else Cell(name, text)
+    _graphs[layer] = cells
+    return run_stale(layer)
+
+
+def describe(layer):
+    """One line per cell: name, state, names it defines."""
+    lines = []
+    for cell in _graphs.get(layer, {}).values():
+        state = "stale" if cell.stale else ("ok" if cell.ok else "error")
+        defines = ", ".join(sorted(cell.defines)) or "-"
+        deps = ", ".join(sorted(cell.deps)) or "-"
+        lines.append(f"{cell.name}: {state}  defines {defines}  after {deps}")
+    return "\n".join(lines) + "\n" if lines else "no cells\n"
+
+
+def reset(layer):
+    """Forget a layer's cells, e.g. when the layer goes away."""
+    _graphs.pop(layer, None)
+
+
+__all__ = [
+    "set_cell",
+    "load_script",
+    "has_cells",
+    "split_cells",
+    "run_stale",
+    "describe",
+    "reset",
+]
@@ -0,0 +1,145 @@
+"""
+yetty_input - Keyboard and mouse input for Python layers.
+
+yetty queues input natively and hands it to Python once per frame as one
+packed batch, so a burst of mouse moves costs a single interpreter call
+instead of one per event. Handlers receive a numpy structured array (or a
+list of tuples when numpy is unavailable) with one record per event:
+
+    type    KEY, CHAR, MOUSE_MOVE, MOUSE_BUTTON or SCROLL
+    code    GLFW key, Unicode codepoint or mouse button
+    action  GLFW action for keys (0 release, 1 press, 2 repeat), 1/0 for buttons
+    mods    GLFW modifier bits
+    x, y    Layer-relative mouse position in pixels, or the scroll offsets
+
+    import yetty_input
+
+    @yetty_input.on_input
+    def handle(events):
+        for e in events[events["type"] == yetty_input.MOUSE_BUTTON]:
+            ...
+
+Handlers and mouse state belong to the layer whose code registered or read
+them; each layer only sees its own input.
+"""
+
+import struct
+
+import yetty_wgpu
+
+KEY = 1
+CHAR = 2
+MOUSE_MOVE = 3
+MOUSE_BUTTON = 4
+SCROLL = 5
+
+# Must match PythonLayer::InputEvent
+EVENT_FORMAT = "<Iiiiff"
+EVENT_SIZE = struct.calcsize(EVENT_FORMAT)
+
+try:
+    import numpy as _np
+    EVENT_DTYPE = _np.dtype([
+        ("type", "<u4"), ("code", "<i4"), ("action", "<i4"),
+        ("mods", "<i4"), ("x", "<f4"), ("y", "<f4"),
+    ])
+except ImportError:
+    _np = None
+    EVENT_DTYPE = None
+
+class _Layer:
+    __slots__ = ("handlers", "mouse")
+
+    def __init__(self):
+        self.handlers = []
+        # Latest mouse state, updated before handlers run
+        self.mouse = {"x": 0.0, "y": 0.0, "buttons": 0}
+
+
+_layers = {}  # layer id -> _Layer
+
+
+def _layer():
+    """State of the layer running Python now, created on first use."""
+    layer = yetty_wgpu.current_layer()
+    state = _layers.get(layer)
+    if state is None:
+        state = _layers[layer] = _Layer()
+        # Registered while this layer runs, so only this layer delivers to it
+        yetty_wgpu.register_callback("input", _deliver_to(state))
+    return state
+
+
+def __getattr__(name):
+    # yetty_input.mouse is the calling layer's mouse state
+    if name == "mouse":
+        return _layer().mouse
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+
+
+def on_input(callback):
+    """Register callback(events), called once per frame with new events."""
+    _layer().handlers.append(callback)
+    return callback
+
+
+def remove_handler(callback):
+    handlers = _layer().handlers
+    if callback in handlers:
+        handlers.remove(callback)
+
+
+def forget_layer(layer):
+    """Drop a disposed layer's handlers; yetty already dropped its callback."""
+    _layers.pop(layer, None)
+
+
+def decode(batch):
+    """Decode a packed batch as numpy records, or tuples without numpy."""
+    if _np is not None:
+        return _np.frombuffer(batch, dtype=EVENT_DTYPE)
+    return list(struct.iter_unpack(EVENT_FORMAT, batch))
+
+
+def text(events):
+    """Concatenate the CHAR events of a decoded batch into a string."""
+    return "".join(chr(e[1]) for e in events if e[0] == CHAR)
+
+
+def _update_mouse(mouse, events):
+    for e in events:
+        kind = e[0]
+        if kind == MOUSE_MOVE:
+            mouse["x"], mouse["y"] = float(e[4]), float(e[5])
+        elif kind == MOUSE_BUTTON:
+            bit = 1 << int(e[1])
+            if e[2]:
+                mouse["buttons"] |= bit
+            else:
+                mouse["buttons"] &= ~bit
+
+
+def _deliver_to(state):
+    def _deliver(batch):
+        """Called by yetty once per frame with the layer's packed events."""
+        events = decode(batch)
+        if _np is not None:
+            moves = events[(events["type"] == MOUSE_MOVE) | (events["type"] == MOUSE_BUTTON)]
+            _update_mouse(state.mouse, moves.tolist())
+        else:
+            _update_mouse(state.mouse, events)
+        for handler in list(state.handlers):
+            handler(events)
+    return _deliver
+
+
+# Native side batches events and hands them to _deliver once per frame; the
+# importing layer is set up now, others on first use
+_layer()
+
+
+__all__ = [
+    "KEY", "CHAR", "MOUSE_MOVE", "MOUSE_BUTTON", "SCROLL",
+    "EVENT_FORMAT", "EVENT_SIZE", "EVENT_DTYPE",
+    "mouse", "on_input", "remove_handler", "forget_layer", "decode", "text",
+]
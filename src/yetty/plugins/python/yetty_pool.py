@@ -0,0 +1,255 @@
+"""
+yetty_pool - Process pool for CPU-heavy work from Python layers.
+
+Work runs in worker processes started from the embedded interpreter binary,
+so the layer's interpreter stays free for plotting. numpy arrays in results
+come back through POSIX shared memory: the worker copies each large array
+into a segment once, and the layer maps it as an ndarray without copying.
+
+    import yetty_pool
+    fut = yetty_pool.submit(module.heavy_function, data)
+    fut = yetty_pool.submit_code("out = np.fft.fft(x)", {"x": x}, ["out"])
+    result = fut.result()           # or poll fut.done() from render_frame
+
+Functions must be importable by the workers (defined in a module, not in the
+REPL); code strings cover the REPL case. Work belongs to the layer that
+submitted it: disposing a layer cancels only its own futures, and the workers
+are terminated when the plugin shuts down.
+"""
+
+import concurrent.futures
+import mmap
+import multiprocessing
+import os
+import sys
+import threading
+from collections import namedtuple
+
+# Arrays smaller than this are pickled; larger ones go through shared memory
+SHARED_MIN_BYTES = 64 * 1024
+
+_Shared = namedtuple("_Shared", "name shape dtype nbytes")
+
+_executor = None
+_pending = {}  # layer id -> futures returned to that layer
+_pending_lock = threading.Lock()  # Futures complete on the executor's thread
+
+
+def _python_executable():
+    exe = os.environ.get("YETTY_PYTHON_EXECUTABLE")
+    if exe and os.path.exists(exe):
+        return exe
+    return sys.executable
+
+
+def _get_executor():
+    global _executor
+    if _executor is not None:
+        return _executor
+
+    exe = _python_executable()
+    # The embedded binary links libpython dynamically
+    libdir = os.path.join(os.path.dirname(os.path.dirname(exe)), "lib")
+    ld_path = os.environ.get("LD_LIBRARY_PATH", "")
+    if libdir not in ld_path.split(os.pathsep):
+        os.environ["LD_LIBRARY_PATH"] = libdir + (os.pathsep + ld_path if ld_path else "")
+
+    ctx = multiprocessing.get_context("spawn")
+    ctx.set_executable(exe)
+    workers = max(1, (os.cpu_count() or 2) - 1)
+    _executor = concurrent.futures.ProcessPoolExecutor(max_workers=workers, mp_context=ctx)
+    return _executor
+
+
+#-----------------------------------------------------------------------------
+# Worker side
+#-----------------------------------------------------------------------------
+
+def _pack(value):
+    try:
+        import numpy as np
+    except ImportError:
+        return value
+
+    # Object arrays hold pointers into this process; those are pickled
+    if (isinstance(value, np.ndarray) and value.nbytes >= SHARED_MIN_BYTES
+            and not value.dtype.hasobject):
+        from multiprocessing import shared_memory
+        shm = shared_memory.SharedMemory(create=True, size=value.nbytes, track=False)
+        view = np.ndarray(value.shape, value.dtype, buffer=shm.buf)
+        view[...] = value
+        del view
+        shm.close()
+        return _Shared(shm.name, value.shape, value.dtype.str, value.nbytes)
+    if isinstance(value, tuple) and not hasattr(value, "_fields"):
+        return tuple(_pack(v) for v in value)
+    if isinstance(value, list):
+        return [_pack(v) for v in value]
+    if isinstance(value, dict):
+        return {k: _pack(v) for k, v in value.items()}
+    return value
+
+
+def _run_function(fn, args, kwargs):
+    return _pack(fn(*args, **kwargs))
+
+
+def _run_code(source, inputs, names):
+    namespace = {"__name__": "__yetty_pool__"}
+    namespace.update(inputs)
+    exec(compile(source, "<yetty_pool>", "exec"), namespace)
+    return _pack({name: namespace[name] for name in names})
+
+
+#-----------------------------------------------------------------------------
+# Layer side
+#-----------------------------------------------------------------------------
+
+def _attach(desc):
+    """Map a worker's segment as an ndarray; the mapping lives as long as it."""
+    import numpy as np
+    import _posixshmem
+
+    path = "/" + desc.name
+    fd = _posixshmem.shm_open(path, os.O_RDWR, mode=0o600)
+    try:
+        mapping = mmap.mmap(fd, desc.nbytes)
+    finally:
+        os.close(fd)
+        # Unlinking only removes the name, our mapping stays valid
+        _posixshmem.shm_unlink(path)
+    return np.ndarray(desc.shape, np.dtype(desc.dtype), buffer=mapping)
+
+
+def _unpack(value):
+    if isinstance(value, _Shared):
+        return _attach(value)
+    if isinstance(value, tuple):
+        return tuple(_unpack(v) for v in value)
+    if isinstance(value, list):
+        return [_unpack(v) for v in value]
+    if isinstance(value, dict):
+        return {k: _unpack(v) for k, v in value.items()}
+    return value
+
+
+def _discard(value):
+    """Unlink segments of a result nobody will read (cancelled futures)."""
+    import _posixshmem
+
+    if isinstance(value, _Shared):
+        try:
+            _posixshmem.shm_unlink("/" + value.name)
+        except OSError:
+            pass
+    elif isinstance(value, (tuple, list)):
+        for v in value:
+            _discard(v)
+    elif isinstance(value, dict):
+        for v in value.values():
+            _discard(v)
+
+
+def _current_layer():
+    """Id of the layer running Python now; None outside any layer."""
+    try:
+        import yetty_wgpu
+    except ImportError:
+        return None
+    return yetty_wgpu.current_layer()
+
+
+def _chain(inner):
+    """Future resolving to the unpacked result of a worker future."""
+    outer = concurrent.futures.Future()
+    layer = _current_layer()
+    with _pending_lock:
+        _pending.setdefault(layer, set()).add(outer)
+
+    def forget(fut):
+        with _pending_lock:
+            owned = _pending.get(layer)
+            if owned is not None:
+                owned.discard(fut)
+                if not owned:
+                    del _pending[layer]
+
+    def done(src):
+        if src.cancelled() or outer.cancelled():
+            if not src.cancelled() and src.exception() is None:
+                _discard(src.result())
+            outer.cancel()
+            return
+        exc = src.exception()
+        if exc is not None:
+            outer.set_exception(exc)
+            return
+        try:
+            outer.set_result(_unpack(src.result()))
+        except BaseException as e:
+            outer.set_exception(e)
+
+    # Cancelling the returned future cancels queued work too; running work
+    # finishes in its worker and done() discards the result
+    def cancel_inner(fut):
+        forget(fut)
+        if fut.cancelled():
+            inner.cancel()
+
+    outer.add_done_callback(cancel_inner)
+    inner.add_done_callback(done)
+    return outer
+
+
+def submit(fn, *args, **kwargs):
+    """Run fn(*args, **kwargs) in a worker process; returns a Future."""
+    return _chain(_get_executor().submit(_run_function, fn, args, kwargs))
+
+
+def submit_code(source, inputs=None, names=()):
+    """Exec source in a worker with inputs as globals; the result maps names to values."""
+    return _chain(_get_executor().submit(_run_code, source, dict(inputs or {}), list(names)))
+
+
+def cancel_layer(layer):
+    """Cancel the outstanding work of one layer; other layers keep theirs."""
+    with _pending_lock:
+        futures = list(_pending.pop(layer, ()))
+    for fut in futures:
+        fut.cancel()
+
+
+def shutdown():
+    """Cancel all outstanding work and terminate the workers."""
+    global _executor
+    with _pending_lock:
+        layers = list(_pending)
+    for layer in layers:
+        cancel_layer(layer)
+    if _executor is None:
+        return
+    executor, _executor = _executor, None
+
+    processes = list((getattr(executor, "_processes", None) or {}).values())
+    executor.shutdown(wait=False, cancel_futures=True)
+    for process in processes:
+        if process.is_alive():
+            process.terminate()
+
+
+def stats():
+    return {
+        "running": _executor is not None,
+        "pending": sum(len(futures) for futures in list(_pending.values())),
+        "workers": getattr(_executor, "_max_workers", 0) if _executor else 0,
+    }
+
+
+__all__ = [
+    "submit",
+    "submit_code",
+    "cancel_layer",
+    "shutdown",
+    "stats",
+    "SHARED_MIN_BYTES",
+]
@@ -8,8 +8,18 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include <webgpu/webgpu.h>
+#include <webgpu/wgpu.h>
 #include <yetty/webgpu-context.h>
+#include "gpu-registry.h"
+#include "frame-callbacks.h"
+#include "frame-pacer.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace {
 
@@ -174,6 +184,973 @@ static PyObject* get_device_limits(PyObject* self, PyObject* args) {
     return limits;
 }
 
+//-----------------------------------------------------------------------------
+// Compute - WGSL kernels dispatched directly on yetty's device
+//-----------------------------------------------------------------------------
+// Kernels are compiled once and cached by (source, entry point), so calling
+// compile_kernel() every frame costs one map lookup. Bindings are
+// @group(0) in binding order: an int is a buffer id from create_buffer(),
+// anything supporting the buffer protocol (bytes, numpy arrays) is uploaded
+// into a scratch buffer owned by the kernel, and a str names a buffer or
+// storage texture in the GPURegistry. The bind group is reused while the
+// bound resources stay the same objects; they are compared by a serial given
+// to every buffer at creation, never by handle, because a released handle's
+// address can come back for a new buffer.
+//
+// Buffers and textures published to the GPURegistry can be bound by native
+// plugins; writes and dispatches touching them bump their generation.
+//-----------------------------------------------------------------------------
+
+struct ComputeBuffer {
+    WGPUBuffer buffer = nullptr;
+    uint64_t size = 0;
+    uint64_t serial = 0;    // Unique per created WGPUBuffer, never reused
+    std::string published;  // Registry name, empty if not shared
+};
+
+struct SharedTexture {
+    WGPUTexture texture = nullptr;
+    WGPUTextureView view = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t bytesPerPixel = 0;
+};
+
+struct Binding {
+    WGPUBuffer buffer = nullptr;
+    WGPUTextureView view = nullptr;
+    uint64_t serial = 0;  // Identity of the resource behind the handle
+    bool shared = false;  // serial is a GPURegistry publish generation
+    bool operator==(const Binding& other) const {
+        return serial == other.serial && shared == other.shared && buffer == other.buffer &&
+               view == other.view;
+    }
+};
+
+struct ComputeKernel {
+    WGPUComputePipeline pipeline = nullptr;
+    WGPUBindGroupLayout layout = nullptr;
+    std::vector<ComputeBuffer> scratch;    // Per binding, for host data
+    std::vector<Binding> bound;            // Resources referenced by bindGroup
+    WGPUBindGroup bindGroup = nullptr;
+};
+
+struct Readback {
+    enum class State { Pending, Ready, Failed };
+    ComputeBuffer staging;
+    uint64_t size = 0;
+    State state = State::Pending;
+};
+
+struct ComputeState {
+    std::unordered_map<uint64_t, ComputeKernel> kernels;
+    std::unordered_map<std::string, uint64_t> kernelIds;  // source + '\0' + entry -> kernel id
+    std::unordered_map<uint64_t, ComputeBuffer> buffers;
+    std::unordered_map<std::string, SharedTexture> textures;  // Keyed by registry name
+    std::unordered_map<uint64_t, std::unique_ptr<Readback>> readbacks;
+    std::vector<ComputeBuffer> stagingPool;
+    uint64_t nextId = 1;
+    uint64_t nextSerial = 1;
+    uint64_t cacheHits = 0;
+    uint64_t dispatches = 0;
+};
+
+static ComputeState g_compute;
+
+static constexpr size_t MAX_POOLED_STAGING = 4;
+
+static uint64_t align4(uint64_t n) { return (n + 3) & ~uint64_t(3); }
+
+static WGPUBuffer createBuffer(uint64_t size, WGPUBufferUsage usage, const char* label) {
+    WGPUBufferDescriptor desc = {};
+    desc.label = {.data = label, .length = WGPU_STRLEN};
+    desc.size = align4(size);
+    desc.usage = usage;
+    return wgpuDeviceCreateBuffer(g_state.device, &desc);
+}
+
+// wgpuQueueWriteBuffer needs a multiple of 4 bytes; pad the tail if necessary
+static void writeBuffer(WGPUBuffer buffer, uint64_t offset, const void* data, size_t len) {
+    size_t body = len & ~size_t(3);
+    if (body > 0) {
+        wgpuQueueWriteBuffer(g_state.queue, buffer, offset, data, body);
+    }
+    if (body < len) {
+        uint8_t tail[4] = {};
+        std::memcpy(tail, static_cast<const uint8_t*>(data) + body, len - body);
+        wgpuQueueWriteBuffer(g_state.queue, buffer, offset + body, tail, 4);
+    }
+}
+
+static bool requireDevice() {
+    if (!g_state.device || !g_state.queue) {
+        PyErr_SetString(PyExc_RuntimeError, "WebGPU device not initialized");
+        return false;
+    }
+    return true;
+}
+
+static ComputeBuffer* findBuffer(PyObject* idObj) {
+    uint64_t id = PyLong_AsUnsignedLongLong(idObj);
+    if (PyErr_Occurred()) return nullptr;
+    auto it = g_compute.buffers.find(id);
+    if (it == g_compute.buffers.end()) {
+        PyErr_Format(PyExc_KeyError, "unknown buffer id %llu", (unsigned long long)id);
+        return nullptr;
+    }
+    return &it->second;
+}
+
+// Bind groups keep their resources alive on the GPU side; release them with
+// the resource instead of at the kernel's next dispatch
+static void dropBindGroupsUsing(WGPUBuffer buffer, WGPUTextureView view) {
+    for (auto& [id, kernel] : g_compute.kernels) {
+        for (const Binding& binding : kernel.bound) {
+            if ((buffer && binding.buffer == buffer) || (view && binding.view == view)) {
+                if (kernel.bindGroup) wgpuBindGroupRelease(kernel.bindGroup);
+                kernel.bindGroup = nullptr;
+                kernel.bound.clear();
+                break;
+            }
+        }
+    }
+}
+
+static void submit(WGPUCommandEncoder encoder) {
+    WGPUCommandBufferDescriptor cmdDesc = {};
+    WGPUCommandBuffer cmd = wgpuCommandEncoderFinish(encoder, &cmdDesc);
+    if (cmd) {
+        wgpuQueueSubmit(g_state.queue, 1, &cmd);
+        wgpuCommandBufferRelease(cmd);
+    }
+    wgpuCommandEncoderRelease(encoder);
+}
+
+struct ScopeResult {
+    bool done = false;
+    WGPUErrorType type = WGPUErrorType_NoError;
+    std::string message;
+};
+
+static void onPopErrorScope(WGPUPopErrorScopeStatus status, WGPUErrorType type,
+                            WGPUStringView message, void* userdata1, void* userdata2) {
+    (void)userdata2;
+    auto* result = static_cast<ScopeResult*>(userdata1);
+    result->done = true;
+    if (status != WGPUPopErrorScopeStatus_Success) return;
+    result->type = type;
+    if (message.data) {
+        size_t len = message.length == WGPU_STRLEN ? std::strlen(message.data) : message.length;
+        result->message.assign(message.data, len);
+    }
+}
+
+// compile_kernel(wgsl, entry_point="main") -> kernel id
+static PyObject* compile_kernel(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* source;
+    Py_ssize_t sourceLen;
+    const char* entry = "main";
+    if (!PyArg_ParseTuple(args, "s#|s", &source, &sourceLen, &entry)) {
+        return nullptr;
+    }
+    if (!requireDevice()) return nullptr;
+
+    std::string key(source, sourceLen);
+    key.push_back('\0');
+    key += entry;
+    if (auto it = g_compute.kernelIds.find(key); it != g_compute.kernelIds.end()) {
+        g_compute.cacheHits++;
+        return PyLong_FromUnsignedLongLong(it->second);
+    }
+
+    // Catch WGSL errors here instead of letting them reach the uncaptured handler
+    wgpuDevicePushErrorScope(g_state.device, WGPUErrorFilter_Validation);
+
+    WGPUShaderSourceWGSL wgslSource = {};
+    wgslSource.chain.sType = WGPUSType_ShaderSourceWGSL;
+    wgslSource.code = {.data = source, .length = (size_t)sourceLen};
+
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = &wgslSource.chain;
+    shaderDesc.label = {.data = "yetty_wgpu_kernel", .length = WGPU_STRLEN};
+    WGPUShaderModule shader = wgpuDeviceCreateShaderModule(g_state.device, &shaderDesc);
+
+    WGPUComputePipeline pipeline = nullptr;
+    if (shader) {
+        WGPUComputePipelineDescriptor pipelineDesc = {};
+        pipelineDesc.label = {.data = "yetty_wgpu_kernel", .length = WGPU_STRLEN};
+        pipelineDesc.layout = nullptr;  // Derived from the shader
+        pipelineDesc.compute.module = shader;
+        pipelineDesc.compute.entryPoint = {.data = entry, .length = WGPU_STRLEN};
+        pipeline = wgpuDeviceCreateComputePipeline(g_state.device, &pipelineDesc);
+        wgpuShaderModuleRelease(shader);
+    }
+
+    ScopeResult scope;
+    WGPUPopErrorScopeCallbackInfo scopeInfo = {};
+    scopeInfo.mode = WGPUCallbackMode_AllowSpontaneous;
+    scopeInfo.callback = onPopErrorScope;
+    scopeInfo.userdata1 = &scope;
+    wgpuDevicePopErrorScope(g_state.device, scopeInfo);
+    while (!scope.done) {
+        wgpuDevicePoll(g_state.device, true, nullptr);
+    }
+
+    if (!pipeline || scope.type != WGPUErrorType_NoError) {
+        if (pipeline) wgpuComputePipelineRelease(pipeline);
+        PyErr_Format(PyExc_ValueError, "Failed to compile kernel: %s",
+                     scope.message.empty() ? "unknown error" : scope.message.c_str());
+        return nullptr;
+    }
+
+    ComputeKernel kernel;
+    kernel.pipeline = pipeline;
+    kernel.layout = wgpuComputePipelineGetBindGroupLayout(pipeline, 0);
+    uint64_t id = g_compute.nextId++;
+    g_compute.kernels.emplace(id, std::move(kernel));
+    g_compute.kernelIds.emplace(std::move(key), id);
+    return PyLong_FromUnsignedLongLong(id);
+}
+
+// create_buffer(size, data=None) -> buffer id
+static PyObject* create_buffer(PyObject* self, PyObject* args) {
+    (void)self;
+    unsigned long long size;
+    PyObject* data = Py_None;
+    if (!PyArg_ParseTuple(args, "K|O", &size, &data)) {
+        return nullptr;
+    }
+    if (!requireDevice()) return nullptr;
+    if (size == 0) {
+        PyErr_SetString(PyExc_ValueError, "Buffer size must be positive");
+        return nullptr;
+    }
+
+    Py_buffer view = {};
+    if (data != Py_None) {
+        if (PyObject_GetBuffer(data, &view, PyBUF_C_CONTIGUOUS) < 0) return nullptr;
+        if ((unsigned long long)view.len > size) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, "Initial data larger than buffer");
+            return nullptr;
+        }
+    }
+
+    ComputeBuffer buffer;
+    buffer.size = align4(size);
+    buffer.serial = g_compute.nextSerial++;
+    buffer.buffer = createBuffer(size,
+        WGPUBufferUsage_Storage | WGPUBufferUsage_Uniform | WGPUBufferUsage_Vertex |
+        WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst,
+        "yetty_wgpu_buffer");
+    if (!buffer.buffer) {
+        if (data != Py_None) PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create buffer");
+        return nullptr;
+    }
+    if (data != Py_None) {
+        writeBuffer(buffer.buffer, 0, view.buf, view.len);
+        PyBuffer_Release(&view);
+    }
+
+    uint64_t id = g_compute.nextId++;
+    g_compute.buffers.emplace(id, buffer);
+    return PyLong_FromUnsignedLongLong(id);
+}
+
+// write_buffer(buffer, data, offset=0)
+static PyObject* write_buffer(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* idObj;
+    Py_buffer view;
+    unsigned long long offset = 0;
+    if (!PyArg_ParseTuple(args, "Oy*|K", &idObj, &view, &offset)) {
+        return nullptr;
+    }
+    ComputeBuffer* buffer = findBuffer(idObj);
+    if (!buffer || !requireDevice()) {
+        PyBuffer_Release(&view);
+        return nullptr;
+    }
+    if (offset % 4 != 0 || offset + view.len > buffer->size) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "Write out of range or offset not a multiple of 4");
+        return nullptr;
+    }
+    writeBuffer(buffer->buffer, offset, view.buf, view.len);
+    PyBuffer_Release(&view);
+    if (!buffer->published.empty()) {
+        yetty::GPURegistry::instance().touch(buffer->published);
+    }
+    Py_RETURN_NONE;
+}
+
+// release_buffer(buffer)
+static PyObject* release_buffer(PyObject* self, PyObject* arg) {
+    (void)self;
+    ComputeBuffer* buffer = findBuffer(arg);
+    if (!buffer) return nullptr;
+    if (!buffer->published.empty()) {
+        yetty::GPURegistry::instance().remove(buffer->published);
+    }
+    dropBindGroupsUsing(buffer->buffer, nullptr);
+    wgpuBufferRelease(buffer->buffer);
+    g_compute.buffers.erase(PyLong_AsUnsignedLongLong(arg));
+    Py_RETURN_NONE;
+}
+
+// get_buffer_handle(buffer) -> WGPUBuffer as int (for wgpu-py interop)
+static PyObject* get_buffer_handle(PyObject* self, PyObject* arg) {
+    (void)self;
+    ComputeBuffer* buffer = findBuffer(arg);
+    if (!buffer) return nullptr;
+    return PyLong_FromVoidPtr(buffer->buffer);
+}
+
+// dispatch(kernel, bindings, x, y=1, z=1) - METH_FASTCALL, called per frame
+static PyObject* dispatch(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    (void)self;
+    if (nargs < 3 || nargs > 5) {
+        PyErr_SetString(PyExc_TypeError, "dispatch(kernel, bindings, x, y=1, z=1)");
+        return nullptr;
+    }
+    if (!requireDevice()) return nullptr;
+
+    uint64_t id = PyLong_AsUnsignedLongLong(args[0]);
+    if (PyErr_Occurred()) return nullptr;
+    auto it = g_compute.kernels.find(id);
+    if (it == g_compute.kernels.end()) {
+        PyErr_Format(PyExc_KeyError, "unknown kernel id %llu", (unsigned long long)id);
+        return nullptr;
+    }
+    ComputeKernel& kernel = it->second;
+
+    uint32_t groups[3] = {1, 1, 1};
+    for (Py_ssize_t i = 2; i < nargs; ++i) {
+        groups[i - 2] = static_cast<uint32_t>(PyLong_AsUnsignedLong(args[i]));
+        if (PyErr_Occurred()) return nullptr;
+    }
+
+    PyObject* seq = PySequence_Fast(args[1], "bindings must be a sequence");
+    if (!seq) return nullptr;
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    PyObject** items = PySequence_Fast_ITEMS(seq);
+
+    static std::vector<Binding> bound;
+    static std::vector<std::string> touched;
+    bound.assign(count, Binding{});
+    touched.clear();
+    if (kernel.scratch.size() < (size_t)count) {
+        kernel.scratch.resize(count);
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* item = items[i];
+        if (PyLong_Check(item)) {
+            ComputeBuffer* buffer = findBuffer(item);
+            if (!buffer) {
+                Py_DECREF(seq);
+                return nullptr;
+            }
+            bound[i].buffer = buffer->buffer;
+            bound[i].serial = buffer->serial;
+            if (!buffer->published.empty()) touched.push_back(buffer->published);
+            continue;
+        }
+
+        if (PyUnicode_Check(item)) {
+            const char* name = PyUnicode_AsUTF8(item);
+            if (!name) {
+                Py_DECREF(seq);
+                return nullptr;
+            }
+            auto& registry = yetty::GPURegistry::instance();
+            yetty::GPURegistry::Buffer sharedBuffer;
+            yetty::GPURegistry::Texture sharedTexture;
+            if (registry.findBuffer(name, sharedBuffer)) {
+                bound[i].buffer = sharedBuffer.buffer;
+                bound[i].serial = sharedBuffer.published;
+            } else if (registry.findTexture(name, sharedTexture)) {
+                bound[i].view = sharedTexture.view;
+                bound[i].serial = sharedTexture.published;
+            } else {
+                Py_DECREF(seq);
+                PyErr_Format(PyExc_KeyError, "no shared GPU resource named '%s'", name);
+                return nullptr;
+            }
+            bound[i].shared = true;
+            touched.push_back(name);
+            continue;
+        }
+
+        Py_buffer view;
+        if (PyObject_GetBuffer(item, &view, PyBUF_C_CONTIGUOUS) < 0) {
+            Py_DECREF(seq);
+            return nullptr;
+        }
+        ComputeBuffer& scratch = kernel.scratch[i];
+        uint64_t needed = align4(view.len > 0 ? view.len : 4);
+        if (scratch.size < needed) {
+            if (scratch.buffer) {
+                dropBindGroupsUsing(scratch.buffer, nullptr);
+                wgpuBufferRelease(scratch.buffer);
+            }
+            scratch.buffer = createBuffer(needed,
+                WGPUBufferUsage_Storage | WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+                "yetty_wgpu_scratch");
+            scratch.size = scratch.buffer ? needed : 0;
+            scratch.serial = g_compute.nextSerial++;
+        }
+        if (!scratch.buffer) {
+            PyBuffer_Release(&view);
+            Py_DECREF(seq);
+            PyErr_SetString(PyExc_RuntimeError, "Failed to create scratch buffer");
+            return nullptr;
+        }
+        writeBuffer(scratch.buffer, 0, view.buf, view.len);
+        PyBuffer_Release(&view);
+        bound[i].buffer = scratch.buffer;
+        bound[i].serial = scratch.serial;
+    }
+    Py_DECREF(seq);
+
+    if (!kernel.bindGroup || kernel.bound != bound) {
+        if (kernel.bindGroup) {
+            wgpuBindGroupRelease(kernel.bindGroup);
+            kernel.bindGroup = nullptr;
+        }
+        std::vector<WGPUBindGroupEntry> entries(count);
+        for (Py_ssize_t i = 0; i < count; ++i) {
+            entries[i] = {};
+            entries[i].binding = static_cast<uint32_t>(i);
+            if (bound[i].view) {
+                entries[i].textureView = bound[i].view;
+            } else {
+                entries[i].buffer = bound[i].buffer;
+                entries[i].offset = 0;
+                entries[i].size = WGPU_WHOLE_SIZE;
+            }
+        }
+        WGPUBindGroupDescriptor bgDesc = {};
+        bgDesc.layout = kernel.layout;
+        bgDesc.entryCount = entries.size();
+        bgDesc.entries = entries.data();
+        kernel.bindGroup = wgpuDeviceCreateBindGroup(g_state.device, &bgDesc);
+        if (!kernel.bindGroup) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to create bind group");
+            return nullptr;
+        }
+        kernel.bound = bound;
+    }
+
+    WGPUCommandEncoderDescriptor encDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(g_state.device, &encDesc);
+    if (!encoder) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create command encoder");
+        return nullptr;
+    }
+
+    WGPUComputePassDescriptor passDesc = {};
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+    wgpuComputePassEncoderSetPipeline(pass, kernel.pipeline);
+    wgpuComputePassEncoderSetBindGroup(pass, 0, kernel.bindGroup, 0, nullptr);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, groups[0], groups[1], groups[2]);
+    wgpuComputePassEncoderEnd(pass);
+    wgpuComputePassEncoderRelease(pass);
+    submit(encoder);
+
+    // Conservatively treat every shared binding as written
+    for (const auto& name : touched) {
+        yetty::GPURegistry::instance().touch(name);
+    }
+
+    g_compute.dispatches++;
+    Py_RETURN_NONE;
+}
+
+static void onReadbackMapped(WGPUMapAsyncStatus status, WGPUStringView message,
+                             void* userdata1, void* userdata2) {
+    (void)message; (void)userdata2;
+    auto* readback = static_cast<Readback*>(userdata1);
+    readback->state = status == WGPUMapAsyncStatus_Success
+        ? Readback::State::Ready : Readback::State::Failed;
+}
+
+static bool startReadback(PyObject* idObj, uint64_t offset, int64_t size, uint64_t* ticket) {
+    ComputeBuffer* buffer = findBuffer(idObj);
+    if (!buffer || !requireDevice()) return false;
+    // Compared without adding, so huge offsets cannot wrap into range
+    if (offset > buffer->size) {
+        PyErr_SetString(PyExc_ValueError, "Read out of range or offset not a multiple of 4");
+        return false;
+    }
+    uint64_t available = buffer->size - offset;
+    if (size < 0) size = static_cast<int64_t>(std::min<uint64_t>(available, INT64_MAX));
+    if (offset % 4 != 0 || static_cast<uint64_t>(size) > available || size == 0) {
+        PyErr_SetString(PyExc_ValueError, "Read out of range or offset not a multiple of 4");
+        return false;
+    }
+
+    auto readback = std::make_unique<Readback>();
+    readback->size = static_cast<uint64_t>(size);
+    uint64_t copySize = align4(readback->size);
+
+    for (size_t i = 0; i < g_compute.stagingPool.size(); ++i) {
+        if (g_compute.stagingPool[i].size >= copySize) {
+            readback->staging = g_compute.stagingPool[i];
+            g_compute.stagingPool.erase(g_compute.stagingPool.begin() + i);
+            break;
+        }
+    }
+    if (!readback->staging.buffer) {
+        readback->staging.buffer = createBuffer(copySize,
+            WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst, "yetty_wgpu_readback");
+        readback->staging.size = copySize;
+        if (!readback->staging.buffer) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to create readback buffer");
+            return false;
+        }
+    }
+
+    WGPUCommandEncoderDescriptor encDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(g_state.device, &encDesc);
+    wgpuCommandEncoderCopyBufferToBuffer(encoder, buffer->buffer, offset,
+                                         readback->staging.buffer, 0, copySize);
+    submit(encoder);
+
+    WGPUBufferMapCallbackInfo mapInfo = {};
+    mapInfo.mode = WGPUCallbackMode_AllowSpontaneous;
+    mapInfo.callback = onReadbackMapped;
+    mapInfo.userdata1 = readback.get();
+    wgpuBufferMapAsync(readback->staging.buffer, WGPUMapMode_Read, 0, copySize, mapInfo);
+
+    *ticket = g_compute.nextId++;
+    g_compute.readbacks.emplace(*ticket, std::move(readback));
+    return true;
+}
+
+// Returns bytes and retires the ticket; staging buffers go back to the pool
+static PyObject* finishReadback(uint64_t ticket) {
+    auto it = g_compute.readbacks.find(ticket);
+    Readback& readback = *it->second;
+
+    PyObject* result = nullptr;
+    if (readback.state == Readback::State::Ready) {
+        const void* data = wgpuBufferGetConstMappedRange(
+            readback.staging.buffer, 0, align4(readback.size));
+        result = PyBytes_FromStringAndSize(static_cast<const char*>(data), readback.size);
+        wgpuBufferUnmap(readback.staging.buffer);
+    } else {
+        PyErr_SetString(PyExc_RuntimeError, "Buffer readback failed");
+    }
+
+    if (readback.state == Readback::State::Ready &&
+        g_compute.stagingPool.size() < MAX_POOLED_STAGING) {
+        g_compute.stagingPool.push_back(readback.staging);
+    } else {
+        wgpuBufferRelease(readback.staging.buffer);
+    }
+    g_compute.readbacks.erase(it);
+    return result;
+}
+
+// read_buffer_async(buffer, offset=0, size=-1) -> ticket for poll_readback()
+static PyObject* read_buffer_async(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* idObj;
+    unsigned long long offset = 0;
+    long long size = -1;
+    if (!PyArg_ParseTuple(args, "O|KL", &idObj, &offset, &size)) {
+        return nullptr;
+    }
+    uint64_t ticket = 0;
+    if (!startReadback(idObj, offset, size, &ticket)) return nullptr;
+    return PyLong_FromUnsignedLongLong(ticket);
+}
+
+// poll_readback(ticket) -> bytes once the copy has landed, None before that
+static PyObject* poll_readback(PyObject* self, PyObject* arg) {
+    (void)self;
+    uint64_t ticket = PyLong_AsUnsignedLongLong(arg);
+    if (PyErr_Occurred()) return nullptr;
+    auto it = g_compute.readbacks.find(ticket);
+    if (it == g_compute.readbacks.end()) {
+        PyErr_Format(PyExc_KeyError, "unknown readback ticket %llu", (unsigned long long)ticket);
+        return nullptr;
+    }
+    if (it->second->state == Readback::State::Pending) {
+        wgpuDevicePoll(g_state.device, false, nullptr);
+    }
+    if (it->second->state == Readback::State::Pending) {
+        Py_RETURN_NONE;
+    }
+    return finishReadback(ticket);
+}
+
+// read_buffer(buffer, offset=0, size=-1) -> bytes, waiting for the GPU
+static PyObject* read_buffer(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* idObj;
+    unsigned long long offset = 0;
+    long long size = -1;
+    if (!PyArg_ParseTuple(args, "O|KL", &idObj, &offset, &size)) {
+        return nullptr;
+    }
+    uint64_t ticket = 0;
+    if (!startReadback(idObj, offset, size, &ticket)) return nullptr;
+
+    Readback* readback = g_compute.readbacks[ticket].get();
+    Py_BEGIN_ALLOW_THREADS
+    while (readback->state == Readback::State::Pending) {
+        wgpuDevicePoll(g_state.device, true, nullptr);
+    }
+    Py_END_ALLOW_THREADS
+    return finishReadback(ticket);
+}
+
+// compute_stats() -> dict
+static PyObject* compute_stats(PyObject* self, PyObject* args) {
+    (void)self; (void)args;
+    return Py_BuildValue("{s:n,s:n,s:K,s:K,s:n}",
+        "kernels", (Py_ssize_t)g_compute.kernels.size(),
+        "buffers", (Py_ssize_t)g_compute.buffers.size(),
+        "cache_hits", (unsigned long long)g_compute.cacheHits,
+        "dispatches", (unsigned long long)g_compute.dispatches,
+        "pending_readbacks", (Py_ssize_t)g_compute.readbacks.size());
+}
+
+//-----------------------------------------------------------------------------
+// Shared GPU resources - published to the GPURegistry for native plugins
+//-----------------------------------------------------------------------------
+
+// publish_buffer(buffer, name) - share a buffer id under a registry name
+static PyObject* publish_buffer(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* idObj;
+    const char* name;
+    if (!PyArg_ParseTuple(args, "Os", &idObj, &name)) {
+        return nullptr;
+    }
+    ComputeBuffer* buffer = findBuffer(idObj);
+    if (!buffer) return nullptr;
+
+    auto& registry = yetty::GPURegistry::instance();
+    if (!buffer->published.empty() && buffer->published != name) {
+        registry.remove(buffer->published);
+    }
+    registry.publishBuffer(name, buffer->buffer, buffer->size);
+    buffer->published = name;
+    Py_RETURN_NONE;
+}
+
+static bool textureFormatFromName(const char* name, WGPUTextureFormat& format,
+                                  uint32_t& bytesPerPixel) {
+    struct FormatName { const char* name; WGPUTextureFormat format; uint32_t bytes; };
+    static const FormatName formats[] = {
+        {"rgba8unorm", WGPUTextureFormat_RGBA8Unorm, 4},
+        {"rgba16float", WGPUTextureFormat_RGBA16Float, 8},
+        {"rgba32float", WGPUTextureFormat_RGBA32Float, 16},
+        {"r32float", WGPUTextureFormat_R32Float, 4},
+    };
+    for (const auto& f : formats) {
+        if (std::strcmp(f.name, name) == 0) {
+            format = f.format;
+            bytesPerPixel = f.bytes;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void releaseSharedTexture(SharedTexture& texture) {
+    dropBindGroupsUsing(nullptr, texture.view);
+    if (texture.view) wgpuTextureViewRelease(texture.view);
+    if (texture.texture) wgpuTextureRelease(texture.texture);
+    texture = SharedTexture{};
+}
+
+// create_texture(name, width, height, format="rgba8unorm") - usable as a
+// storage texture in dispatch() and sampled by native plugins
+static PyObject* create_texture(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* name;
+    uint32_t width, height;
+    const char* formatName = "rgba8unorm";
+    if (!PyArg_ParseTuple(args, "sII|s", &name, &width, &height, &formatName)) {
+        return nullptr;
+    }
+    if (!requireDevice()) return nullptr;
+
+    WGPUTextureFormat format;
+    uint32_t bytesPerPixel;
+    if (!textureFormatFromName(formatName, format, bytesPerPixel)) {
+        PyErr_Format(PyExc_ValueError, "unsupported texture format '%s'", formatName);
+        return nullptr;
+    }
+    if (width == 0 || height == 0) {
+        PyErr_SetString(PyExc_ValueError, "Texture size must be positive");
+        return nullptr;
+    }
+
+    WGPUTextureDescriptor texDesc = {};
+    texDesc.label = {.data = "yetty_wgpu_shared_texture", .length = WGPU_STRLEN};
+    texDesc.size = {width, height, 1};
+    texDesc.mipLevelCount = 1;
+    texDesc.sampleCount = 1;
+    texDesc.dimension = WGPUTextureDimension_2D;
+    texDesc.format = format;
+    texDesc.usage = WGPUTextureUsage_StorageBinding |
+                    WGPUTextureUsage_TextureBinding |
+                    WGPUTextureUsage_CopySrc |
+                    WGPUTextureUsage_CopyDst;
+
+    SharedTexture texture;
+    texture.texture = wgpuDeviceCreateTexture(g_state.device, &texDesc);
+    if (texture.texture) {
+        texture.view = wgpuTextureCreateView(texture.texture, nullptr);
+    }
+    if (!texture.view) {
+        releaseSharedTexture(texture);
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create texture");
+        return nullptr;
+    }
+    texture.width = width;
+    texture.height = height;
+    texture.bytesPerPixel = bytesPerPixel;
+
+    auto it = g_compute.textures.find(name);
+    if (it != g_compute.textures.end()) {
+        releaseSharedTexture(it->second);
+        it->second = texture;
+    } else {
+        g_compute.textures.emplace(name, texture);
+    }
+    yetty::GPURegistry::instance().publishTexture(
+        name, texture.texture, texture.view, width, height, format);
+    Py_RETURN_NONE;
+}
+
+// write_texture(name, data) - replace the whole texture with tightly packed rows
+static PyObject* write_texture(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* name;
+    Py_buffer view;
+    if (!PyArg_ParseTuple(args, "sy*", &name, &view)) {
+        return nullptr;
+    }
+    auto it = g_compute.textures.find(name);
+    if (it == g_compute.textures.end() || !requireDevice()) {
+        PyBuffer_Release(&view);
+        if (!PyErr_Occurred()) {
+            PyErr_Format(PyExc_KeyError, "no texture named '%s'", name);
+        }
+        return nullptr;
+    }
+    const SharedTexture& texture = it->second;
+    size_t expected = (size_t)texture.width * texture.height * texture.bytesPerPixel;
+    if ((size_t)view.len != expected) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "Data size doesn't match the texture");
+        return nullptr;
+    }
+
+    WGPUTexelCopyTextureInfo dst = {};
+    dst.texture = texture.texture;
+    dst.aspect = WGPUTextureAspect_All;
+
+    WGPUTexelCopyBufferLayout layout = {};
+    layout.bytesPerRow = texture.width * texture.bytesPerPixel;
+    layout.rowsPerImage = texture.height;
+
+    WGPUExtent3D extent = {texture.width, texture.height, 1};
+    wgpuQueueWriteTexture(g_state.queue, &dst, view.buf, view.len, &layout, &extent);
+    PyBuffer_Release(&view);
+
+    yetty::GPURegistry::instance().touch(name);
+    Py_RETURN_NONE;
+}
+
+// get_texture_handle(name) -> WGPUTexture as int
+static PyObject* get_texture_handle(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name)) return nullptr;
+    yetty::GPURegistry::Texture texture;
+    if (!yetty::GPURegistry::instance().findTexture(name, texture)) {
+        PyErr_Format(PyExc_KeyError, "no texture named '%s'", name);
+        return nullptr;
+    }
+    return PyLong_FromVoidPtr(texture.texture);
+}
+
+// touch(name) - mark a shared resource as changed (e.g. after wgpu-py writes)
+static PyObject* touch(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name)) return nullptr;
+    if (!yetty::GPURegistry::instance().touch(name)) {
+        PyErr_Format(PyExc_KeyError, "no shared GPU resource named '%s'", name);
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// generation(name) -> int, 0 if unknown
+static PyObject* generation(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name)) return nullptr;
+    return PyLong_FromUnsignedLongLong(yetty::GPURegistry::instance().generation(name));
+}
+
+// unpublish(name) - remove a shared buffer or texture from the registry
+static PyObject* unpublish(PyObject* self, PyObject* args) {
+    (void)self;
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name)) return nullptr;
+    yetty::GPURegistry::instance().remove(name);
+
+    auto it = g_compute.textures.find(name);
+    if (it != g_compute.textures.end()) {
+        releaseSharedTexture(it->second);
+        g_compute.textures.erase(it);
+    }
+    for (auto& [id, buffer] : g_compute.buffers) {
+        if (buffer.published == name) buffer.published.clear();
+    }
+    Py_RETURN_NONE;
+}
+
+static void releaseCompute() {
+    // Releasing a staging buffer aborts its pending map; the callback still
+    // writes into the Readback, so release before the readbacks are freed
+    for (auto& [ticket, readback] : g_compute.readbacks) {
+        wgpuBufferRelease(readback->staging.buffer);
+    }
+    g_compute.readbacks.clear();
+    for (auto& staging : g_compute.stagingPool) {
+        wgpuBufferRelease(staging.buffer);
+    }
+    for (auto& [id, kernel] : g_compute.kernels) {
+        if (kernel.bindGroup) wgpuBindGroupRelease(kernel.bindGroup);
+        for (auto& scratch : kernel.scratch) {
+            if (scratch.buffer) wgpuBufferRelease(scratch.buffer);
+        }
+        if (kernel.layout) wgpuBindGroupLayoutRelease(kernel.layout);
+        wgpuComputePipelineRelease(kernel.pipeline);
+    }
+    g_compute.kernels.clear();
+    g_compute.kernelIds.clear();
+    for (auto& [id, buffer] : g_compute.buffers) {
+        if (!buffer.published.empty()) {
+            yetty::GPURegistry::instance().remove(buffer.published);
+        }
+        wgpuBufferRelease(buffer.buffer);
+    }
+    for (auto& [name, texture] : g_compute.textures) {
+        yetty::GPURegistry::instance().remove(name);
+        releaseSharedTexture(texture);
+    }
+    g_compute = ComputeState{};
+}
+
+//-----------------------------------------------------------------------------
+// Frame callbacks - see FrameCallbacks
+//-----------------------------------------------------------------------------
+
+static bool parseCallbackArgs(PyObject* args, yetty::FrameCallbacks::Kind& kind,
+                              PyObject*& callable) {
+    const char* kindName;
+    if (!PyArg_ParseTuple(args, "sO", &kindName, &callable)) {
+        return false;
+    }
+    if (!yetty::FrameCallbacks::kindFromName(kindName, kind)) {
+        PyErr_Format(PyExc_ValueError,
+                     "unknown callback kind '%s' (frame, resize, input, idle)", kindName);
+        return false;
+    }
+    return true;
+}
+
+// register_callback(kind, fn) -> fn
+static PyObject* register_callback(PyObject* self, PyObject* args) {
+    (void)self;
+    yetty::FrameCallbacks::Kind kind;
+    PyObject* callable;
+    if (!parseCallbackArgs(args, kind, callable)) return nullptr;
+    if (!PyCallable_Check(callable)) {
+        PyErr_SetString(PyExc_TypeError, "callback must be callable");
+        return nullptr;
+    }
+    yetty::FrameCallbacks::instance().add(kind, callable);
+    Py_INCREF(callable);
+    return callable;
+}
+
+// unregister_callback(kind, fn) -> bool
+static PyObject* unregister_callback(PyObject* self, PyObject* args) {
+    (void)self;
+    yetty::FrameCallbacks::Kind kind;
+    PyObject* callable;
+    if (!parseCallbackArgs(args, kind, callable)) return nullptr;
+    return PyBool_FromLong(yetty::FrameCallbacks::instance().remove(kind, callable));
+}
+
+// current_layer() -> int or None; identifies the layer running Python now
+static PyObject* current_layer(PyObject* self, PyObject* args) {
+    (void)self; (void)args;
+    const void* owner = yetty::FrameCallbacks::instance().activeOwner();
+    if (!owner) Py_RETURN_NONE;
+    return PyLong_FromUnsignedLongLong(reinterpret_cast<uintptr_t>(owner));
+}
+
+// callback_stats() -> {kind: [{name, calls, errors, total_us, max_us}]}
+static PyObject* callback_stats(PyObject* self, PyObject* args) {
+    (void)self; (void)args;
+    return yetty::FrameCallbacks::instance().stats();
+}
+
+//-----------------------------------------------------------------------------
+// Frame pacing
+//-----------------------------------------------------------------------------
+
+static yetty::FramePacer* requirePacer() {
+    yetty::FramePacer* pacer = yetty::FramePacer::active();
+    if (!pacer) {
+        PyErr_SetString(PyExc_RuntimeError, "not running inside a Python layer");
+    }
+    return pacer;
+}
+
+// frame_info() -> {frame, period, deadline, remaining, pacing, budget, ...}
+static PyObject* frame_info(PyObject* self, PyObject* args) {
+    (void)self; (void)args;
+    yetty::FramePacer* pacer = requirePacer();
+    return pacer ? pacer->info() : nullptr;
+}
+
+// remaining_budget() -> seconds left before this frame's deadline
+static PyObject* remaining_budget(PyObject* self, PyObject* args) {
+    (void)self; (void)args;
+    yetty::FramePacer* pacer = requirePacer();
+    return pacer ? PyFloat_FromDouble(pacer->remaining()) : nullptr;
+}
+
+// set_frame_pacing(enabled, budget=0.75)
+static PyObject* set_frame_pacing(PyObject* self, PyObject* args) {
+    (void)self;
+    int enabled;
+    double budget = 0.75;
+    if (!PyArg_ParseTuple(args, "p|d", &enabled, &budget)) {
+        return nullptr;
+    }
+    yetty::FramePacer* pacer = requirePacer();
+    if (!pacer) return nullptr;
+    pacer->setPacing(enabled != 0, budget);
+    Py_RETURN_NONE;
+}
+
 //-----------------------------------------------------------------------------
 // Module definition
 //-----------------------------------------------------------------------------
@@ -201,6 +1178,54 @@ static PyMethodDef YettyWgpuMethods[] = {
      "Get device features as a set"},
     {"get_device_limits", get_device_limits, METH_NOARGS,
      "Get device limits as a dict"},
+    {"compile_kernel", compile_kernel, METH_VARARGS,
+     "Compile a WGSL compute kernel (source, entry_point='main'), cached by source hash"},
+    {"create_buffer", create_buffer, METH_VARARGS,
+     "Create a GPU buffer (size, data=None) and return its id"},
+    {"write_buffer", write_buffer, METH_VARARGS,
+     "Write bytes into a GPU buffer (buffer, data, offset=0)"},
+    {"release_buffer", release_buffer, METH_O,
+     "Release a GPU buffer"},
+    {"get_buffer_handle", get_buffer_handle, METH_O,
+     "Get the WGPUBuffer handle of a buffer id"},
+    {"dispatch", (PyCFunction)(void(*)(void))dispatch, METH_FASTCALL,
+     "Dispatch a kernel (kernel, bindings, x, y=1, z=1)"},
+    {"read_buffer", read_buffer, METH_VARARGS,
+     "Read a GPU buffer back as bytes (buffer, offset=0, size=-1), blocking"},
+    {"read_buffer_async", read_buffer_async, METH_VARARGS,
+     "Start reading a GPU buffer back; returns a ticket for poll_readback"},
+    {"poll_readback", poll_readback, METH_O,
+     "Return the bytes of a finished readback, or None while pending"},
+    {"compute_stats", compute_stats, METH_NOARGS,
+     "Get compute cache statistics as a dict"},
+    {"publish_buffer", publish_buffer, METH_VARARGS,
+     "Share a buffer with native plugins under a name (buffer, name)"},
+    {"create_texture", create_texture, METH_VARARGS,
+     "Create a shared texture (name, width, height, format='rgba8unorm')"},
+    {"write_texture", write_texture, METH_VARARGS,
+     "Upload tightly packed pixel data to a shared texture (name, data)"},
+    {"get_texture_handle", get_texture_handle, METH_VARARGS,
+     "Get the WGPUTexture handle of a shared texture"},
+    {"touch", touch, METH_VARARGS,
+     "Mark a shared buffer or texture as changed"},
+    {"generation", generation, METH_VARARGS,
+     "Get the change counter of a shared buffer or texture (0 if unknown)"},
+    {"unpublish", unpublish, METH_VARARGS,
+     "Remove a shared buffer or texture from the registry"},
+    {"register_callback", register_callback, METH_VARARGS,
+     "Call fn every frame: kind is 'frame', 'resize', 'input' or 'idle'"},
+    {"unregister_callback", unregister_callback, METH_VARARGS,
+     "Remove a callback registered with register_callback"},
+    {"frame_info", frame_info, METH_NOARGS,
+     "Frame period, deadline and remaining budget of the current layer"},
+    {"remaining_budget", remaining_budget, METH_NOARGS,
+     "Seconds left before the current frame's deadline"},
+    {"set_frame_pacing", set_frame_pacing, METH_VARARGS,
+     "Skip render_frame when it would not finish before the deadline"},
+    {"current_layer", current_layer, METH_NOARGS,
+     "Id of the layer whose Python is running, or None"},
+    {"callback_stats", callback_stats, METH_NOARGS,
+     "Get call counts and timings of registered callbacks"},
     {nullptr, nullptr, 0, nullptr}
 };
 
@@ -322,6 +1347,11 @@ WGPUTextureView yetty_wgpu_get_render_texture_view() {
 // claimed ownership via wrapped handles and destroyed it during Python cleanup.
 // Trying to destroy it again causes a panic in wgpu-native.
 void yetty_wgpu_cleanup() {
+    // Compute objects are never wrapped by wgpu-py, so they are ours to release
+    if (g_state.device) {
+        releaseCompute();
+    }
+
     // Just null out references, don't destroy
     // The texture will be destroyed when the wgpu device is destroyed
     g_state.renderTextureView = nullptr;
@@ -0,0 +1,115 @@
+#include "gpu-registry.h"
+
+namespace yetty {
+
+GPURegistry& GPURegistry::instance() {
+    static GPURegistry registry;
+    return registry;
+}
+
+GPURegistry::~GPURegistry() {
+    // The device is usually gone by static destruction time; leak the references
+    _entries.clear();
+}
+
+void GPURegistry::releaseEntry(Entry& entry) {
+    if (entry.isTexture) {
+        if (entry.texture.view) wgpuTextureViewRelease(entry.texture.view);
+        if (entry.texture.texture) wgpuTextureRelease(entry.texture.texture);
+    } else if (entry.buffer.buffer) {
+        wgpuBufferRelease(entry.buffer.buffer);
+    }
+}
+
+void GPURegistry::publishBuffer(const std::string& name, WGPUBuffer buffer, uint64_t size) {
+    if (!buffer) return;
+    wgpuBufferAddRef(buffer);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry entry;
+    uint64_t generation = ++_generation;
+    entry.buffer = {buffer, size, generation, generation};
+
+    auto it = _entries.find(name);
+    if (it != _entries.end()) {
+        releaseEntry(it->second);
+        it->second = entry;
+    } else {
+        _entries.emplace(name, entry);
+    }
+}
+
+void GPURegistry::publishTexture(const std::string& name, WGPUTexture texture,
+                                 WGPUTextureView view, uint32_t width, uint32_t height,
+                                 WGPUTextureFormat format) {
+    if (!texture || !view) return;
+    wgpuTextureAddRef(texture);
+    wgpuTextureViewAddRef(view);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry entry;
+    entry.isTexture = true;
+    uint64_t generation = ++_generation;
+    entry.texture = {texture, view, width, height, format, generation, generation};
+
+    auto it = _entries.find(name);
+    if (it != _entries.end()) {
+        releaseEntry(it->second);
+        it->second = entry;
+    } else {
+        _entries.emplace(name, entry);
+    }
+}
+
+bool GPURegistry::touch(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (it == _entries.end()) return false;
+    if (it->second.isTexture) {
+        it->second.texture.generation = ++_generation;
+    } else {
+        it->second.buffer.generation = ++_generation;
+    }
+    return true;
+}
+
+bool GPURegistry::findBuffer(const std::string& name, Buffer& out) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (it == _entries.end() || it->second.isTexture) return false;
+    out = it->second.buffer;
+    return true;
+}
+
+bool GPURegistry::findTexture(const std::string& name, Texture& out) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (it == _entries.end() || !it->second.isTexture) return false;
+    out = it->second.texture;
+    return true;
+}
+
+uint64_t GPURegistry::generation(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (it == _entries.end()) return 0;
+    return it->second.isTexture ? it->second.texture.generation : it->second.buffer.generation;
+}
+
+void GPURegistry::remove(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (it == _entries.end()) return;
+    releaseEntry(it->second);
+    _entries.erase(it);
+}
+
+void GPURegistry::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& [name, entry] : _entries) {
+        releaseEntry(entry);
+    }
+    _entries.clear();
+}
+
+} // namespace yetty
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// GPURegistry - named GPU buffers and textures shared between plugins
+//-----------------------------------------------------------------------------
+// A producer (e.g. a Python layer running compute kernels) publishes a buffer
+// or texture under a name; any plugin on the same device can look it up and
+// bind it without a CPU round trip. The registry holds a reference on each
+// published object, so a looked-up handle stays valid until the entry is
+// replaced or removed. Consumers should look up once per frame and compare:
+//   - published, the generation the entry was published at, for state tied
+//     to the object itself (bind groups). A handle can be reused after
+//     remove(), so it is not an identity on its own.
+//   - generation, bumped on every publish() and touch(), for state derived
+//     from the contents (cached draws).
+// Generations come from one registry-wide counter and are never repeated,
+// even for a name that is removed and published again.
+//
+// Lives in its own shared library so every plugin sees the same instance.
+//-----------------------------------------------------------------------------
+class GPURegistry {
+public:
+    struct Buffer {
+        WGPUBuffer buffer = nullptr;
+        uint64_t size = 0;
+        uint64_t generation = 0;
+        uint64_t published = 0;
+    };
+
+    struct Texture {
+        WGPUTexture texture = nullptr;
+        WGPUTextureView view = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+        uint64_t generation = 0;
+        uint64_t published = 0;
+    };
+
+    static GPURegistry& instance();
+
+    // Publishing replaces any entry of the same name (of either kind)
+    void publishBuffer(const std::string& name, WGPUBuffer buffer, uint64_t size);
+    void publishTexture(const std::string& name, WGPUTexture texture, WGPUTextureView view,
+                        uint32_t width, uint32_t height, WGPUTextureFormat format);
+
+    // Mark the contents as changed; returns false if the name is unknown
+    bool touch(const std::string& name);
+
+    bool findBuffer(const std::string& name, Buffer& out) const;
+    bool findTexture(const std::string& name, Texture& out) const;
+
+    // 0 if the name is unknown
+    uint64_t generation(const std::string& name) const;
+
+    void remove(const std::string& name);
+    void clear();
+
+private:
+    GPURegistry() = default;
+    ~GPURegistry();
+
+    struct Entry {
+        bool isTexture = false;
+        Buffer buffer;
+        Texture texture;
+    };
+
+    void releaseEntry(Entry& entry);
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+    uint64_t _generation = 0;  // Last generation handed out
+};
+
+} // namespace yetty
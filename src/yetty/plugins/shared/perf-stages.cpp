@@ -0,0 +1,236 @@
+#include "perf-stages.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace yetty {
+
+namespace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//-----------------------------------------------------------------------------
+// Per-thread perf_event_open group, opened on first use
+//-----------------------------------------------------------------------------
+struct CounterGroup {
+    static constexpr int MAX_EVENTS = 4;
+
+    int fds[MAX_EVENTS] = {-1, -1, -1, -1};
+    uint32_t bits[MAX_EVENTS] = {};  // CounterBits of each group member, in read order
+    int count = 0;
+    bool tried = false;
+    std::string error;
+
+    ~CounterGroup() {
+#if defined(__linux__)
+        for (int i = 0; i < count; ++i) close(fds[i]);
+#endif
+    }
+
+    bool open() {
+        if (tried) return count > 0;
+        tried = true;
+#if defined(__linux__)
+        struct Event {
+            uint64_t config;
+            uint32_t bit;
+        };
+        // Cycles lead the group; the others are optional (not every PMU has them)
+        const Event events[MAX_EVENTS] = {
+            {PERF_COUNT_HW_CPU_CYCLES, PerfStages::CYCLES},
+            {PERF_COUNT_HW_INSTRUCTIONS, PerfStages::INSTRUCTIONS},
+            {PERF_COUNT_HW_CACHE_MISSES, PerfStages::CACHE_MISSES},
+            {PERF_COUNT_HW_BRANCH_MISSES, PerfStages::BRANCH_MISSES},
+        };
+
+        for (const Event& event : events) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = event.config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int groupFd = count > 0 ? fds[0] : -1;
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd,
+                                              PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0) {
+                if (count == 0) {
+                    error = std::string("perf_event_open: ") + std::strerror(errno);
+                    return false;
+                }
+                continue;
+            }
+            fds[count] = fd;
+            bits[count] = event.bit;
+            count++;
+        }
+        return true;
+#else
+        error = "hardware counters are only supported on Linux";
+        return false;
+#endif
+    }
+
+    uint32_t read(PerfStages::Counters& out) {
+#if defined(__linux__)
+        // { nr, time_enabled, time_running, value[nr] }
+        uint64_t buf[3 + MAX_EVENTS] = {};
+        if (::read(fds[0], buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+            return 0;
+        }
+        uint64_t enabled = buf[1];
+        uint64_t running = buf[2];
+        if (running == 0) return 0;
+        double scale = static_cast<double>(enabled) / static_cast<double>(running);
+
+        uint32_t filled = 0;
+        int n = static_cast<int>(std::min<uint64_t>(buf[0], static_cast<uint64_t>(count)));
+        for (int i = 0; i < n; ++i) {
+            uint64_t value = static_cast<uint64_t>(static_cast<double>(buf[3 + i]) * scale);
+            switch (bits[i]) {
+                case PerfStages::CYCLES: out.cycles = value; break;
+                case PerfStages::INSTRUCTIONS: out.instructions = value; break;
+                case PerfStages::CACHE_MISSES: out.cacheMisses = value; break;
+                case PerfStages::BRANCH_MISSES: out.branchMisses = value; break;
+            }
+            filled |= bits[i];
+        }
+        return filled;
+#else
+        (void)out;
+        return 0;
+#endif
+    }
+};
+
+thread_local CounterGroup t_group;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+// PerfStages
+//-----------------------------------------------------------------------------
+
+PerfStages& PerfStages::instance() {
+    static PerfStages stages;
+    return stages;
+}
+
+bool PerfStages::enable(bool hardwareCounters) {
+    bool ok = true;
+    if (hardwareCounters) {
+        // Probe on this thread; a kernel that refuses here refuses everywhere
+        ok = t_group.open();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters_error = ok ? std::string() : t_group.error;
+    }
+    _counters.store(hardwareCounters && ok, std::memory_order_relaxed);
+    _enabled.store(true, std::memory_order_relaxed);
+    return ok;
+}
+
+void PerfStages::disable() {
+    _enabled.store(false, std::memory_order_relaxed);
+    _counters.store(false, std::memory_order_relaxed);
+}
+
+std::string PerfStages::countersError() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _counters_error;
+}
+
+std::vector<PerfStages::Stage> PerfStages::snapshot() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<Stage> stages;
+    stages.reserve(_stages.size());
+    for (const auto& [name, stage] : _stages) {
+        stages.push_back(stage);
+    }
+    return stages;
+}
+
+void PerfStages::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stages.clear();
+}
+
+uint32_t PerfStages::readCounters(Counters& out) {
+    if (!t_group.open()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_counters_error.empty()) _counters_error = t_group.error;
+        return 0;
+    }
+    return t_group.read(out);
+}
+
+void PerfStages::record(const char* name, uint64_t wallNs, const Counters& delta,
+                        uint32_t available) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _stages.find(std::string_view(name));
+    if (it == _stages.end()) {
+        it = _stages.emplace(name, Stage{}).first;
+        it->second.name = name;
+        it->second.available = available;
+    }
+
+    Stage& stage = it->second;
+    stage.calls++;
+    stage.wallNs += wallNs;
+    stage.counters.cycles += delta.cycles;
+    stage.counters.instructions += delta.instructions;
+    stage.counters.cacheMisses += delta.cacheMisses;
+    stage.counters.branchMisses += delta.branchMisses;
+    stage.available &= available;
+}
+
+//-----------------------------------------------------------------------------
+// Scope
+//-----------------------------------------------------------------------------
+
+PerfStages::Scope::Scope(const char* name) {
+    PerfStages& stages = instance();
+    if (!stages.enabled()) return;
+
+    _name = name;
+    if (stages.countersEnabled()) {
+        _available = stages.readCounters(_start);
+    }
+    _start_ns = nowNs();
+}
+
+PerfStages::Scope::~Scope() {
+    if (!_name) return;
+    uint64_t wallNs = nowNs() - _start_ns;
+
+    PerfStages& stages = instance();
+    Counters delta;
+    uint32_t available = 0;
+    if (_available) {
+        Counters end;
+        available = stages.readCounters(end) & _available;
+        // Scaled counts of a multiplexed group can step back by a few events
+        auto diff = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+        delta.cycles = diff(end.cycles, _start.cycles);
+        delta.instructions = diff(end.instructions, _start.instructions);
+        delta.cacheMisses = diff(end.cacheMisses, _start.cacheMisses);
+        delta.branchMisses = diff(end.branchMisses, _start.branchMisses);
+    }
+    stages.record(_name, wallNs, delta, available);
+}
+
+} // namespace yetty
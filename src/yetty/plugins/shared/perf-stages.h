@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// PerfStages - wall time and hardware counters around named pipeline stages
+//-----------------------------------------------------------------------------
+// Plugins wrap their expensive stages in a PerfStages::Scope:
+//
+//     PerfStages::Scope stage("video.decode");
+//
+// While disabled (the default) a scope costs one relaxed atomic load. Once a
+// host enables it, every scope adds its wall time to the stage; with hardware
+// counters requested it also adds cycles, instructions, cache misses and
+// branch misses, read from a per-thread perf_event_open group (user space
+// only, scaled for multiplexing). Where the kernel refuses counters
+// (perf_event_paranoid, containers, VMs without a PMU) only wall time is
+// kept and countersError() says why.
+//
+// Lives in its own shared library so the host and all plugins share it.
+//-----------------------------------------------------------------------------
+class PerfStages {
+public:
+    struct Counters {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t cacheMisses = 0;
+        uint64_t branchMisses = 0;
+    };
+
+    // Bit per counter in Counters, set when the kernel provided it
+    enum CounterBits : uint32_t {
+        CYCLES = 1u << 0,
+        INSTRUCTIONS = 1u << 1,
+        CACHE_MISSES = 1u << 2,
+        BRANCH_MISSES = 1u << 3,
+    };
+
+    struct Stage {
+        std::string name;
+        uint64_t calls = 0;
+        uint64_t wallNs = 0;
+        Counters counters;
+        uint32_t available = 0;  // CounterBits present in every recorded call
+    };
+
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* _name = nullptr;  // nullptr while disabled
+        uint64_t _start_ns = 0;
+        Counters _start;
+        uint32_t _available = 0;
+    };
+
+    static PerfStages& instance();
+
+    // Returns false if hardware counters were requested but are unavailable;
+    // wall-time recording is enabled either way
+    bool enable(bool hardwareCounters);
+    void disable();
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    bool countersEnabled() const { return _counters.load(std::memory_order_relaxed); }
+    std::string countersError() const;
+
+    std::vector<Stage> snapshot() const;
+    void reset();
+
+private:
+    PerfStages() = default;
+
+    // Reads this thread's counter group; returns the CounterBits it filled in
+    uint32_t readCounters(Counters& out);
+    void record(const char* name, uint64_t wallNs, const Counters& delta, uint32_t available);
+
+    std::atomic<bool> _enabled{false};
+    std::atomic<bool> _counters{false};
+
+    mutable std::mutex _mutex;
+    std::map<std::string, Stage, std::less<>> _stages;
+    std::string _counters_error;
+};
+
+} // namespace yetty
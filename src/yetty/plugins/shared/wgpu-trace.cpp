@@ -0,0 +1,214 @@
+#include "wgpu-trace.h"
+
+#include <webgpu/webgpu.h>
+
+#include <dlfcn.h>
+#include <cstdio>
+#include <cstdlib>
+
+namespace yetty {
+
+WgpuTrace& WgpuTrace::instance() {
+    static WgpuTrace trace;
+    return trace;
+}
+
+const char* WgpuTrace::counterName(int counter) {
+    static constexpr const char* NAMES[COUNTER_COUNT] = {
+        "submits",           "command_buffers", "command_encoders",   "render_passes",
+        "compute_passes",    "draws",           "dispatches",         "render_pipelines",
+        "compute_pipelines", "bind_groups",     "bind_group_layouts", "shader_modules",
+        "buffers",           "textures",        "texture_views",      "samplers",
+        "buffer_writes",     "texture_writes",  "upload_bytes",       "copy_bytes",
+    };
+    return counter >= 0 && counter < COUNTER_COUNT ? NAMES[counter] : "";
+}
+
+bool WgpuTrace::interposed() const {
+    // Whoever wins symbol lookup for a traced entry point must be this library
+    void* resolved = dlsym(RTLD_DEFAULT, "wgpuQueueSubmit");
+    Dl_info resolvedInfo{};
+    Dl_info selfInfo{};
+    if (!resolved || !dladdr(resolved, &resolvedInfo) ||
+        !dladdr(reinterpret_cast<void*>(&WgpuTrace::counterName), &selfInfo)) {
+        return false;
+    }
+    return resolvedInfo.dli_fbase == selfInfo.dli_fbase;
+}
+
+WgpuTrace::Counts WgpuTrace::snapshot() const {
+    Counts counts{};
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        counts[i] = _counts[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+} // namespace yetty
+
+//-----------------------------------------------------------------------------
+// Interposed entry points
+//-----------------------------------------------------------------------------
+
+namespace {
+
+using yetty::WgpuTrace;
+
+template <typename Fn>
+Fn nextSymbol(const char* name) {
+    void* sym = dlsym(RTLD_NEXT, name);
+    if (!sym) {
+        // Nothing after us defines it - calling ourselves would recurse forever
+        std::fprintf(stderr, "wgpu-trace: no definition of %s after the trace library\n", name);
+        std::abort();
+    }
+    return reinterpret_cast<Fn>(sym);
+}
+
+void count(WgpuTrace::Counter counter, uint64_t n = 1) {
+    WgpuTrace::instance().add(counter, n);
+}
+
+} // namespace
+
+// Resolves the wgpu-native definition once per entry point
+#define WGPU_TRACE_NEXT(fn) static const auto next = nextSymbol<decltype(&fn)>(#fn)
+
+extern "C" {
+
+void wgpuQueueSubmit(WGPUQueue queue, size_t commandCount, WGPUCommandBuffer const* commands) {
+    WGPU_TRACE_NEXT(wgpuQueueSubmit);
+    count(WgpuTrace::Submits);
+    count(WgpuTrace::CommandBuffers, commandCount);
+    next(queue, commandCount, commands);
+}
+
+void wgpuQueueWriteBuffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t bufferOffset,
+                          void const* data, size_t size) {
+    WGPU_TRACE_NEXT(wgpuQueueWriteBuffer);
+    count(WgpuTrace::BufferWrites);
+    count(WgpuTrace::UploadBytes, size);
+    next(queue, buffer, bufferOffset, data, size);
+}
+
+void wgpuQueueWriteTexture(WGPUQueue queue, WGPUTexelCopyTextureInfo const* destination,
+                           void const* data, size_t dataSize,
+                           WGPUTexelCopyBufferLayout const* dataLayout,
+                           WGPUExtent3D const* writeSize) {
+    WGPU_TRACE_NEXT(wgpuQueueWriteTexture);
+    count(WgpuTrace::TextureWrites);
+    count(WgpuTrace::UploadBytes, dataSize);
+    next(queue, destination, data, dataSize, dataLayout, writeSize);
+}
+
+WGPUCommandEncoder wgpuDeviceCreateCommandEncoder(WGPUDevice device,
+                                                  WGPUCommandEncoderDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateCommandEncoder);
+    count(WgpuTrace::CommandEncoders);
+    return next(device, descriptor);
+}
+
+WGPURenderPassEncoder wgpuCommandEncoderBeginRenderPass(WGPUCommandEncoder commandEncoder,
+                                                        WGPURenderPassDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuCommandEncoderBeginRenderPass);
+    count(WgpuTrace::RenderPasses);
+    return next(commandEncoder, descriptor);
+}
+
+WGPUComputePassEncoder wgpuCommandEncoderBeginComputePass(WGPUCommandEncoder commandEncoder,
+                                                          WGPUComputePassDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuCommandEncoderBeginComputePass);
+    count(WgpuTrace::ComputePasses);
+    return next(commandEncoder, descriptor);
+}
+
+void wgpuCommandEncoderCopyBufferToBuffer(WGPUCommandEncoder commandEncoder, WGPUBuffer source,
+                                          uint64_t sourceOffset, WGPUBuffer destination,
+                                          uint64_t destinationOffset, uint64_t size) {
+    WGPU_TRACE_NEXT(wgpuCommandEncoderCopyBufferToBuffer);
+    count(WgpuTrace::CopyBytes, size);
+    next(commandEncoder, source, sourceOffset, destination, destinationOffset, size);
+}
+
+void wgpuRenderPassEncoderDraw(WGPURenderPassEncoder renderPassEncoder, uint32_t vertexCount,
+                               uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
+    WGPU_TRACE_NEXT(wgpuRenderPassEncoderDraw);
+    count(WgpuTrace::Draws);
+    next(renderPassEncoder, vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+void wgpuRenderPassEncoderDrawIndexed(WGPURenderPassEncoder renderPassEncoder, uint32_t indexCount,
+                                      uint32_t instanceCount, uint32_t firstIndex,
+                                      int32_t baseVertex, uint32_t firstInstance) {
+    WGPU_TRACE_NEXT(wgpuRenderPassEncoderDrawIndexed);
+    count(WgpuTrace::Draws);
+    next(renderPassEncoder, indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
+
+void wgpuComputePassEncoderDispatchWorkgroups(WGPUComputePassEncoder computePassEncoder,
+                                              uint32_t workgroupCountX, uint32_t workgroupCountY,
+                                              uint32_t workgroupCountZ) {
+    WGPU_TRACE_NEXT(wgpuComputePassEncoderDispatchWorkgroups);
+    count(WgpuTrace::Dispatches);
+    next(computePassEncoder, workgroupCountX, workgroupCountY, workgroupCountZ);
+}
+
+WGPURenderPipeline wgpuDeviceCreateRenderPipeline(WGPUDevice device,
+                                                  WGPURenderPipelineDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateRenderPipeline);
+    count(WgpuTrace::RenderPipelines);
+    return next(device, descriptor);
+}
+
+WGPUComputePipeline wgpuDeviceCreateComputePipeline(WGPUDevice device,
+                                                    WGPUComputePipelineDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateComputePipeline);
+    count(WgpuTrace::ComputePipelines);
+    return next(device, descriptor);
+}
+
+WGPUBindGroup wgpuDeviceCreateBindGroup(WGPUDevice device, WGPUBindGroupDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateBindGroup);
+    count(WgpuTrace::BindGroups);
+    return next(device, descriptor);
+}
+
+WGPUBindGroupLayout wgpuDeviceCreateBindGroupLayout(WGPUDevice device,
+                                                    WGPUBindGroupLayoutDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateBindGroupLayout);
+    count(WgpuTrace::BindGroupLayouts);
+    return next(device, descriptor);
+}
+
+WGPUShaderModule wgpuDeviceCreateShaderModule(WGPUDevice device,
+                                              WGPUShaderModuleDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateShaderModule);
+    count(WgpuTrace::ShaderModules);
+    return next(device, descriptor);
+}
+
+WGPUBuffer wgpuDeviceCreateBuffer(WGPUDevice device, WGPUBufferDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateBuffer);
+    count(WgpuTrace::Buffers);
+    return next(device, descriptor);
+}
+
+WGPUTexture wgpuDeviceCreateTexture(WGPUDevice device, WGPUTextureDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateTexture);
+    count(WgpuTrace::Textures);
+    return next(device, descriptor);
+}
+
+WGPUTextureView wgpuTextureCreateView(WGPUTexture texture, WGPUTextureViewDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuTextureCreateView);
+    count(WgpuTrace::TextureViews);
+    return next(texture, descriptor);
+}
+
+WGPUSampler wgpuDeviceCreateSampler(WGPUDevice device, WGPUSamplerDescriptor const* descriptor) {
+    WGPU_TRACE_NEXT(wgpuDeviceCreateSampler);
+    count(WgpuTrace::Samplers);
+    return next(device, descriptor);
+}
+
+} // extern "C"
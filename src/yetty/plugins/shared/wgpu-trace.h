@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// WgpuTrace - counts the WebGPU calls plugins make
+//-----------------------------------------------------------------------------
+// The library defines the wgpu* entry points plugins use (submits, pass
+// begins, draws, object creation, queue writes), bumps a counter and forwards
+// to the next definition, i.e. wgpu-native. It only sees calls while it comes
+// before libwgpu_native in symbol lookup order: link it ahead of webgpu (as
+// yetty-plugin-tester does) or LD_PRELOAD it into any other host.
+// interposed() tells whether that worked.
+//
+// Calls made by wgpu-py through its own handle to wgpu-native are not seen.
+// Counters are process-wide; a host diffs snapshots to get per-frame values.
+//-----------------------------------------------------------------------------
+class WgpuTrace {
+public:
+    enum Counter {
+        Submits,
+        CommandBuffers,
+        CommandEncoders,
+        RenderPasses,
+        ComputePasses,
+        Draws,
+        Dispatches,
+        RenderPipelines,
+        ComputePipelines,
+        BindGroups,
+        BindGroupLayouts,
+        ShaderModules,
+        Buffers,
+        Textures,
+        TextureViews,
+        Samplers,
+        BufferWrites,
+        TextureWrites,
+        UploadBytes,  // CPU to GPU: queue buffer and texture writes
+        CopyBytes,    // GPU to GPU: buffer-to-buffer copies
+        COUNTER_COUNT
+    };
+
+    using Counts = std::array<uint64_t, COUNTER_COUNT>;
+
+    static WgpuTrace& instance();
+
+    // snake_case name for reports
+    static const char* counterName(int counter);
+
+    // True if plugin calls actually reach this library
+    bool interposed() const;
+
+    Counts snapshot() const;
+
+    void add(Counter counter, uint64_t n = 1) {
+        _counts[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+private:
+    WgpuTrace() = default;
+
+    std::array<std::atomic<uint64_t>, COUNTER_COUNT> _counts{};
+};
+
+} // namespace yetty
@@ -0,0 +1,90 @@
+#include "mosaic-atlas.h"
+#include <algorithm>
+
+namespace yetty {
+
+std::optional<MosaicAtlasPacker::Rect> MosaicAtlasPacker::allocate(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0 || width > _size || height > _size) {
+        return std::nullopt;
+    }
+
+    // Best fit: the lowest existing shelf that wastes at most half the tile height
+    Shelf* best = nullptr;
+    size_t bestSpan = 0;
+    for (auto& shelf : _shelves) {
+        if (shelf.height < height || shelf.height > height + height / 2) continue;
+        if (best && shelf.height >= best->height) continue;
+
+        for (size_t i = 0; i < shelf.free.size(); i++) {
+            if (shelf.free[i].w >= width) {
+                best = &shelf;
+                bestSpan = i;
+                break;
+            }
+        }
+    }
+
+    // Otherwise open a new shelf on top of the last one
+    if (!best) {
+        uint32_t top = _shelves.empty() ? 0 : _shelves.back().y + _shelves.back().height;
+        if (top + height > _size) {
+            return std::nullopt;
+        }
+        Shelf shelf;
+        shelf.y = top;
+        shelf.height = height;
+        shelf.free.push_back({0, _size});
+        _shelves.push_back(std::move(shelf));
+        best = &_shelves.back();
+        bestSpan = 0;
+    }
+
+    Span& span = best->free[bestSpan];
+    Rect rect{span.x, best->y, width, height};
+    span.x += width;
+    span.w -= width;
+    if (span.w == 0) {
+        best->free.erase(best->free.begin() + static_cast<std::ptrdiff_t>(bestSpan));
+    }
+
+    _used_area += static_cast<uint64_t>(width) * height;
+    return rect;
+}
+
+void MosaicAtlasPacker::release(const Rect& rect) {
+    auto it = std::find_if(_shelves.begin(), _shelves.end(),
+                           [&](const Shelf& s) { return s.y == rect.y; });
+    if (it == _shelves.end() || rect.w == 0) return;
+
+    // Insert the span in x order and merge with its neighbours
+    auto& free = it->free;
+    auto pos = std::lower_bound(free.begin(), free.end(), rect.x,
+                                [](const Span& s, uint32_t x) { return s.x < x; });
+    pos = free.insert(pos, Span{rect.x, rect.w});
+
+    if (pos + 1 != free.end() && pos->x + pos->w == (pos + 1)->x) {
+        pos->w += (pos + 1)->w;
+        free.erase(pos + 1);
+    }
+    if (pos != free.begin() && (pos - 1)->x + (pos - 1)->w == pos->x) {
+        (pos - 1)->w += pos->w;
+        free.erase(pos);
+    }
+
+    _used_area -= std::min<uint64_t>(_used_area, static_cast<uint64_t>(rect.w) * rect.h);
+
+    // Empty shelves at the top give their height back for any tile size
+    while (!_shelves.empty()) {
+        const auto& last = _shelves.back();
+        if (last.free.size() != 1 || last.free[0].x != 0 || last.free[0].w != _size) break;
+        _shelves.pop_back();
+    }
+}
+
+void MosaicAtlasPacker::reset(uint32_t size) {
+    _size = size;
+    _used_area = 0;
+    _shelves.clear();
+}
+
+} // namespace yetty
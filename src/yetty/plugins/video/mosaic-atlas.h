@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// MosaicAtlasPacker - shelf packer for the shared video mosaic texture
+//-----------------------------------------------------------------------------
+// Tiles are placed on horizontal shelves. Each shelf keeps a sorted list of
+// free spans so a released tile can be reused by a clip of similar height.
+// The packer only tracks rectangles - the owner is responsible for growing
+// the texture and re-uploading tiles after reset().
+//-----------------------------------------------------------------------------
+class MosaicAtlasPacker {
+public:
+    struct Rect {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t w = 0;
+        uint32_t h = 0;
+    };
+
+    explicit MosaicAtlasPacker(uint32_t size) : _size(size) {}
+
+    // Returns std::nullopt when no shelf can hold the tile
+    std::optional<Rect> allocate(uint32_t width, uint32_t height);
+    void release(const Rect& rect);
+
+    // Drop all placements (used for compaction and atlas growth)
+    void reset(uint32_t size);
+
+    uint32_t size() const { return _size; }
+    uint64_t usedArea() const { return _used_area; }
+
+private:
+    struct Span {
+        uint32_t x;
+        uint32_t w;
+    };
+
+    struct Shelf {
+        uint32_t y = 0;
+        uint32_t height = 0;
+        std::vector<Span> free;  // sorted by x, adjacent spans coalesced
+    };
+
+    uint32_t _size;
+    uint64_t _used_area = 0;
+    std::vector<Shelf> _shelves;
+};
+
+} // namespace yetty
@@ -1,20 +1,35 @@
 #include "video.h"
+#include "perf-stages.h"
+#include "gpu-registry.h"
 #include <yetty/yetty.h>
 #include <yetty/webgpu-context.h>
 #include <yetty/wgpu-compat.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <optional>
 #include <cstring>
+#include <cstddef>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
 namespace yetty {
 
+// Layers at or below this on-screen size (pixels) are drawn through the mosaic atlas
+static constexpr float MOSAIC_MAX_TILE_SIZE = 256.0f;
+static constexpr uint32_t MOSAIC_ATLAS_MAX_SIZE = 4096;
+// Tiles not drawn for this many frames are evicted when the atlas is full
+static constexpr uint64_t MOSAIC_EVICT_FRAMES = 120;
+// Payload prefix naming a GPURegistry texture instead of video data
+static constexpr const char* SHARED_TEXTURE_PREFIX = "gpu-texture:";
+
 //-----------------------------------------------------------------------------
 // Custom AVIOContext for reading from memory
 //-----------------------------------------------------------------------------
@@ -65,6 +80,28 @@ static int64_t seek_packet(void* opaque, int64_t offset, int whence) {
     return new_pos;
 }
 
+//-----------------------------------------------------------------------------
+// High bit depth planar YUV detection (yuv420p10le, yuv444p12le, ...)
+//-----------------------------------------------------------------------------
+static bool isHighBitDepthPlanarYuv(AVPixelFormat fmt) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(fmt);
+    if (!desc || desc->nb_components != 3) return false;
+
+    constexpr uint64_t rejected = AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_PAL |
+                                  AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL |
+                                  AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_FLOAT;
+    if (desc->flags & rejected) return false;
+    if (!(desc->flags & AV_PIX_FMT_FLAG_PLANAR)) return false;
+
+    // One little-endian 16-bit sample per plane, LSB aligned
+    for (int i = 0; i < 3; i++) {
+        const auto& comp = desc->comp[i];
+        if (comp.plane != i || comp.step != 2 || comp.shift != 0) return false;
+        if (comp.depth <= 8 || comp.depth > 16) return false;
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // Video format detection via magic bytes
 //-----------------------------------------------------------------------------
@@ -127,7 +164,9 @@ VideoPlugin::~VideoPlugin() { (void)dispose(); }
 
 Result<PluginPtr> VideoPlugin::create(YettyPtr engine) noexcept {
     auto p = PluginPtr(new VideoPlugin(std::move(engine)));
-    if (auto res = static_cast<VideoPlugin*>(p.get())->init(); !res) {
+    auto plugin = std::static_pointer_cast<VideoPlugin>(p);
+    plugin->_self = plugin;
+    if (auto res = plugin->init(); !res) {
         return Err<PluginPtr>("Failed to init VideoPlugin", res);
     }
     return Ok(p);
@@ -142,12 +181,19 @@ Result<void> VideoPlugin::dispose() {
     if (auto res = Plugin::dispose(); !res) {
         return Err<void>("Failed to dispose VideoPlugin", res);
     }
+    releaseMosaicGpu();
+    _mosaic_tiles.clear();
+    _mosaic_reported.clear();
+    _mosaic_expected.clear();
+    _mosaic_instances.clear();
+    _mosaic_frame_view = nullptr;
+    _mosaic_flushed = false;
     _initialized = false;
     return Ok();
 }
 
 Result<PluginLayerPtr> VideoPlugin::createLayer(const std::string& payload) {
-    auto layer = std::make_shared<VideoLayer>();
+    auto layer = std::make_shared<VideoLayer>(_self);
     auto result = layer->init(payload);
     if (!result) {
         return Err<PluginLayerPtr>("Failed to init VideoLayer", result);
@@ -159,7 +205,7 @@ Result<PluginLayerPtr> VideoPlugin::createLayer(const std::string& payload) {
 // VideoLayer
 //-----------------------------------------------------------------------------
 
-VideoLayer::VideoLayer() = default;
+VideoLayer::VideoLayer(std::weak_ptr<VideoPlugin> plugin) : _plugin(std::move(plugin)) {}
 
 VideoLayer::~VideoLayer() { (void)dispose(); }
 
@@ -171,6 +217,15 @@ Result<void> VideoLayer::init(const std::string& payload) {
     _payload = payload;
     (void)dispose();
 
+    if (payload.rfind(SHARED_TEXTURE_PREFIX, 0) == 0) {
+        _shared_name = payload.substr(std::strlen(SHARED_TEXTURE_PREFIX));
+        if (_shared_name.empty()) {
+            return Err<void>("VideoLayer: empty shared texture name");
+        }
+        std::cout << "VideoLayer: showing shared texture '" << _shared_name << "'" << std::endl;
+        return Ok();
+    }
+
     auto result = initFFmpeg(payload);
     if (!result) {
         return result;
@@ -300,23 +355,37 @@ Result<void> VideoLayer::initFFmpeg(const std::string& data) {
         return Err<void>("Failed to allocate frame/packet");
     }
 
-    // Allocate RGBA frame buffer
-    int num_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, _video_width, _video_height, 1);
-    _frame_buffer.resize(num_bytes);
-
-    av_image_fill_arrays(_frame_rgba->data, _frame_rgba->linesize,
-                         _frame_buffer.data(), AV_PIX_FMT_RGBA,
-                         _video_width, _video_height, 1);
-
-    // Create swscale context for format conversion
-    _sws_ctx = sws_getContext(
-        _video_width, _video_height, _codec_ctx->pix_fmt,
-        _video_width, _video_height, AV_PIX_FMT_RGBA,
-        SWS_BILINEAR, nullptr, nullptr, nullptr
-    );
+    // 10/12-bit content skips the (expensive, lossy) swscale conversion to RGBA8
+    _hdr_path = isHighBitDepthPlanarYuv(_codec_ctx->pix_fmt);
+    if (_hdr_path) {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(_codec_ctx->pix_fmt);
+        _bit_depth = desc->comp[0].depth;
+        _chroma_width = (_video_width + (1 << desc->log2_chroma_w) - 1) >> desc->log2_chroma_w;
+        _chroma_height = (_video_height + (1 << desc->log2_chroma_h) - 1) >> desc->log2_chroma_h;
+
+        switch (_codec_ctx->color_trc) {
+            case AVCOL_TRC_SMPTE2084: _transfer = 1; break;
+            case AVCOL_TRC_ARIB_STD_B67: _transfer = 2; break;
+            default: _transfer = 0; break;
+        }
+        switch (_codec_ctx->colorspace) {
+            case AVCOL_SPC_BT2020_NCL:
+            case AVCOL_SPC_BT2020_CL: _matrix = 1; break;
+            case AVCOL_SPC_BT470BG:
+            case AVCOL_SPC_SMPTE170M: _matrix = 2; break;
+            case AVCOL_SPC_UNSPECIFIED: _matrix = _transfer ? 1 : 0; break;
+            default: _matrix = 0; break;
+        }
+        _full_range = _codec_ctx->color_range == AVCOL_RANGE_JPEG;
 
-    if (!_sws_ctx) {
-        return Err<void>("Failed to create swscale context");
+        std::cout << "VideoLayer: " << _bit_depth << "-bit "
+                  << av_get_pix_fmt_name(_codec_ctx->pix_fmt)
+                  << " decoded on the GPU (transfer=" << _transfer << ")" << std::endl;
+    } else {
+        // Allocate RGBA frame buffer and swscale context at native size
+        if (auto res = configureOutput(_video_width, _video_height); !res) {
+            return res;
+        }
     }
 
     // Decode first frame
@@ -332,6 +401,9 @@ Result<void> VideoLayer::decodeNextFrame() {
     if (!_format_ctx || !_codec_ctx || !_frame || !_packet) {
         return Err<void>("FFmpeg not initialized");
     }
+    // Closed before conversion so video.decode and video.convert never overlap
+    std::optional<PerfStages::Scope> decode;
+    decode.emplace("video.decode");
 
     while (true) {
         int ret = av_read_frame(_format_ctx, _packet);
@@ -369,11 +441,17 @@ Result<void> VideoLayer::decodeNextFrame() {
             return Err<void>("Error decoding frame");
         }
 
-        // Convert to RGBA
-        sws_scale(_sws_ctx,
-                  _frame->data, _frame->linesize,
-                  0, _video_height,
-                  _frame_rgba->data, _frame_rgba->linesize);
+        decode.reset();
+
+        // Convert to RGBA (high bit depth planes go to the GPU untouched)
+        if (!_hdr_path || _mosaic) {
+            PerfStages::Scope convert("video.convert");
+            sws_scale(_sws_ctx,
+                      _frame->data, _frame->linesize,
+                      0, _video_height,
+                      _frame_rgba->data, _frame_rgba->linesize);
+        }
+        _has_frame = true;
 
         // Update current time from PTS
         if (_frame->pts != AV_NOPTS_VALUE) {
@@ -416,13 +494,24 @@ bool VideoLayer::onMouseButton(int button, bool pressed) {
 }
 
 Result<void> VideoLayer::dispose() {
+    // The plugin may already be gone when the host tears layers down last
+    if (_mosaic) {
+        if (auto plugin = _plugin.lock()) plugin->releaseMosaicTile(this);
+    }
+    _mosaic = false;
+
     // Release WebGPU resources
     if (_bind_group) { wgpuBindGroupRelease(_bind_group); _bind_group = nullptr; }
+    if (_bind_group_layout) { wgpuBindGroupLayoutRelease(_bind_group_layout); _bind_group_layout = nullptr; }
     if (_pipeline) { wgpuRenderPipelineRelease(_pipeline); _pipeline = nullptr; }
     if (_uniform_buffer) { wgpuBufferRelease(_uniform_buffer); _uniform_buffer = nullptr; }
     if (_sampler) { wgpuSamplerRelease(_sampler); _sampler = nullptr; }
     if (_texture_view) { wgpuTextureViewRelease(_texture_view); _texture_view = nullptr; }
     if (_texture) { wgpuTextureRelease(_texture); _texture = nullptr; }
+    for (int i = 0; i < 3; i++) {
+        if (_plane_views[i]) { wgpuTextureViewRelease(_plane_views[i]); _plane_views[i] = nullptr; }
+        if (_plane_textures[i]) { wgpuTextureRelease(_plane_textures[i]); _plane_textures[i] = nullptr; }
+    }
 
     // Release FFmpeg resources
     if (_sws_ctx) { sws_freeContext(_sws_ctx); _sws_ctx = nullptr; }
@@ -444,22 +533,63 @@ Result<void> VideoLayer::dispose() {
     }
 
     _frame_buffer.clear();
+    _out_width = 0;
+    _out_height = 0;
+    _has_frame = false;
+    _hdr_path = false;
     _input_data.clear();
+    _shared_name.clear();
+    _shared_published = 0;
     _gpu_initialized = false;
 
     return Ok();
 }
 
+Result<void> VideoLayer::configureOutput(int width, int height) {
+    if (width == _out_width && height == _out_height && _sws_ctx) {
+        return Ok();
+    }
+
+    // Convert directly to the output size so mosaic tiles never scale on the CPU twice
+    _sws_ctx = sws_getCachedContext(
+        _sws_ctx,
+        _video_width, _video_height, _codec_ctx->pix_fmt,
+        width, height, AV_PIX_FMT_RGBA,
+        SWS_BILINEAR, nullptr, nullptr, nullptr
+    );
+    if (!_sws_ctx) {
+        return Err<void>("Failed to create swscale context");
+    }
+
+    int num_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, width, height, 1);
+    _frame_buffer.assign(num_bytes, 0);
+    av_image_fill_arrays(_frame_rgba->data, _frame_rgba->linesize,
+                         _frame_buffer.data(), AV_PIX_FMT_RGBA,
+                         width, height, 1);
+    _out_width = width;
+    _out_height = height;
+
+    // Re-convert the last decoded frame so a paused clip stays visible
+    if (_has_frame) {
+        sws_scale(_sws_ctx,
+                  _frame->data, _frame->linesize,
+                  0, _video_height,
+                  _frame_rgba->data, _frame_rgba->linesize);
+    }
+    _frame_updated = true;
+    return Ok();
+}
+
 void VideoLayer::updateTexture(WebGPUContext& ctx) {
     if (!_texture || !_frame_updated || _frame_buffer.empty()) return;
 
     WGPUTexelCopyTextureInfo dst = {};
     dst.texture = _texture;
     WGPUTexelCopyBufferLayout layout = {};
-    layout.bytesPerRow = _video_width * 4;
-    layout.rowsPerImage = _video_height;
-    WGPUExtent3D extent = {static_cast<uint32_t>(_video_width),
-                           static_cast<uint32_t>(_video_height), 1};
+    layout.bytesPerRow = _out_width * 4;
+    layout.rowsPerImage = _out_height;
+    WGPUExtent3D extent = {static_cast<uint32_t>(_out_width),
+                           static_cast<uint32_t>(_out_height), 1};
 
     wgpuQueueWriteTexture(ctx.getQueue(), &dst, _frame_buffer.data(),
                           _frame_buffer.size(), &layout, &extent);
@@ -469,14 +599,20 @@ void VideoLayer::updateTexture(WebGPUContext& ctx) {
 
 Result<void> VideoLayer::render(WebGPUContext& ctx) {
     if (_failed) return Err<void>("VideoLayer already failed");
-    if (!_visible) return Ok();
-    if (_frame_buffer.empty()) return Err<void>("VideoLayer has no frame data");
 
     // Get render context set by owner
     const auto& rc = _render_context;
+    auto plugin = _plugin.lock();
+    if (!plugin) _mosaic = false;
+
+    if (!_visible) {
+        return _mosaic ? plugin->skipMosaicTile(ctx, rc, this) : Ok();
+    }
+    bool shared = !_shared_name.empty();
+    if (!shared && !_hdr_path && _frame_buffer.empty()) return Err<void>("VideoLayer has no frame data");
 
     // Update playback (integrate former update() logic)
-    if (_playing) {
+    if (_playing && !shared) {
         _accumulated_time += rc.deltaTime;
         if (_accumulated_time >= _frame_time) {
             _accumulated_time -= _frame_time;
@@ -487,20 +623,6 @@ Result<void> VideoLayer::render(WebGPUContext& ctx) {
         }
     }
 
-    if (!_gpu_initialized) {
-        auto result = createPipeline(ctx, rc.targetFormat);
-        if (!result) {
-            _failed = true;
-            return Err<void>("Failed to create pipeline", result);
-        }
-        _gpu_initialized = true;
-    }
-
-    if (!_pipeline || !_uniform_buffer || !_bind_group) {
-        _failed = true;
-        return Err<void>("VideoLayer pipeline not initialized");
-    }
-
     // Calculate pixel position from cell position
     float pixelX = _x * rc.cellWidth;
     float pixelY = _y * rc.cellHeight;
@@ -516,12 +638,65 @@ Result<void> VideoLayer::render(WebGPUContext& ctx) {
     if (rc.termRows > 0) {
         float screenPixelHeight = rc.termRows * rc.cellHeight;
         if (pixelY + pixelH <= 0 || pixelY >= screenPixelHeight) {
-            return Ok();
+            return _mosaic ? plugin->skipMosaicTile(ctx, rc, this) : Ok();
+        }
+    }
+
+    if (shared) {
+        if (auto res = bindSharedTexture(ctx, rc.targetFormat); !res) {
+            _failed = true;
+            return Err<void>("Failed to bind shared texture", res);
         }
+        // Not published (yet): nothing to draw
+        if (!_bind_group) return Ok();
+        return drawQuad(ctx, pixelX, pixelY, pixelW, pixelH);
+    }
+
+    // Small previews share the plugin's atlas and instanced draw
+    if (plugin && pixelW <= MOSAIC_MAX_TILE_SIZE && pixelH <= MOSAIC_MAX_TILE_SIZE) {
+        return renderMosaic(*plugin, ctx, pixelX, pixelY, pixelW, pixelH);
+    }
+
+    if (_mosaic) {
+        plugin->releaseMosaicTile(this);
+        _mosaic = false;
+        _frame_updated = true;
+    }
+    if (!_hdr_path) {
+        if (auto res = configureOutput(_video_width, _video_height); !res) {
+            _failed = true;
+            return Err<void>("Failed to restore native output size", res);
+        }
+    }
+
+    if (!_gpu_initialized) {
+        auto result = _hdr_path ? createHdrPipeline(ctx, rc.targetFormat)
+                                : createPipeline(ctx, rc.targetFormat);
+        if (!result) {
+            _failed = true;
+            return Err<void>("Failed to create pipeline", result);
+        }
+        _gpu_initialized = true;
+    }
+
+    if (!_pipeline || !_uniform_buffer || !_bind_group) {
+        _failed = true;
+        return Err<void>("VideoLayer pipeline not initialized");
     }
 
     // Update texture with latest frame
-    updateTexture(ctx);
+    if (_hdr_path) {
+        updateHdrTextures(ctx);
+    } else {
+        updateTexture(ctx);
+    }
+
+    return drawQuad(ctx, pixelX, pixelY, pixelW, pixelH);
+}
+
+Result<void> VideoLayer::drawQuad(WebGPUContext& ctx, float pixelX, float pixelY, float pixelW,
+                                  float pixelH) {
+    const auto& rc = _render_context;
 
     // Update uniforms
     float ndcX = (pixelX / rc.screenWidth) * 2.0f - 1.0f;
@@ -573,6 +748,33 @@ Result<void> VideoLayer::render(WebGPUContext& ctx) {
     return Ok();
 }
 
+Result<void> VideoLayer::renderMosaic(VideoPlugin& plugin, WebGPUContext& ctx, float pixelX,
+                                      float pixelY, float pixelW, float pixelH) {
+    const auto& rc = _render_context;
+
+    // Tile matches the on-screen size, but never upscales past the source
+    int tileW = std::clamp(static_cast<int>(std::lround(pixelW)), 1, _video_width);
+    int tileH = std::clamp(static_cast<int>(std::lround(pixelH)), 1, _video_height);
+    if (auto res = configureOutput(tileW, tileH); !res) {
+        _failed = true;
+        return Err<void>("Failed to configure mosaic output", res);
+    }
+    _mosaic = true;
+
+    float ndcRect[4] = {
+        (pixelX / rc.screenWidth) * 2.0f - 1.0f,
+        1.0f - (pixelY / rc.screenHeight) * 2.0f,
+        (pixelW / rc.screenWidth) * 2.0f,
+        (pixelH / rc.screenHeight) * 2.0f,
+    };
+
+    bool updated = _frame_updated;
+    _frame_updated = false;
+    return plugin.submitMosaicTile(ctx, rc, this, ndcRect, _frame_buffer.data(),
+                                   static_cast<uint32_t>(_out_width),
+                                   static_cast<uint32_t>(_out_height), updated);
+}
+
 bool VideoLayer::renderToPass(WGPURenderPassEncoder pass, WebGPUContext& ctx) {
     (void)pass;
     (void)ctx;
@@ -617,10 +819,19 @@ Result<void> VideoLayer::createPipeline(WebGPUContext& ctx, WGPUTextureFormat ta
     _texture_view = wgpuTextureCreateView(_texture, &viewDesc);
     if (!_texture_view) return Err<void>("Failed to create texture view");
 
+    if (auto res = createQuadPipeline(ctx, targetFormat, true); !res) return res;
+    return createBindGroup(ctx, _texture_view);
+}
+
+Result<void> VideoLayer::createQuadPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat,
+                                            bool filtering) {
+    WGPUDevice device = ctx.getDevice();
+    WGPUFilterMode filter = filtering ? WGPUFilterMode_Linear : WGPUFilterMode_Nearest;
+
     // Create sampler
     WGPUSamplerDescriptor samplerDesc = {};
-    samplerDesc.minFilter = WGPUFilterMode_Linear;
-    samplerDesc.magFilter = WGPUFilterMode_Linear;
+    samplerDesc.minFilter = filter;
+    samplerDesc.magFilter = filter;
     samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
     samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
     samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
@@ -668,31 +879,296 @@ struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) uv: v
     entries[0].binding = 0; entries[0].visibility = WGPUShaderStage_Vertex;
     entries[0].buffer.type = WGPUBufferBindingType_Uniform;
     entries[1].binding = 1; entries[1].visibility = WGPUShaderStage_Fragment;
-    entries[1].sampler.type = WGPUSamplerBindingType_Filtering;
+    entries[1].sampler.type = filtering ? WGPUSamplerBindingType_Filtering
+                                        : WGPUSamplerBindingType_NonFiltering;
     entries[2].binding = 2; entries[2].visibility = WGPUShaderStage_Fragment;
-    entries[2].texture.sampleType = WGPUTextureSampleType_Float;
+    entries[2].texture.sampleType = filtering ? WGPUTextureSampleType_Float
+                                              : WGPUTextureSampleType_UnfilterableFloat;
     entries[2].texture.viewDimension = WGPUTextureViewDimension_2D;
 
     WGPUBindGroupLayoutDescriptor bglDesc = {};
     bglDesc.entryCount = 3; bglDesc.entries = entries;
-    WGPUBindGroupLayout bgl = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
-    if (!bgl) { wgpuShaderModuleRelease(shaderModule); return Err<void>("Failed to create bgl"); }
+    _bind_group_layout = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+    if (!_bind_group_layout) { wgpuShaderModuleRelease(shaderModule); return Err<void>("Failed to create bgl"); }
 
     // Pipeline layout
     WGPUPipelineLayoutDescriptor plDesc = {};
-    plDesc.bindGroupLayoutCount = 1; plDesc.bindGroupLayouts = &bgl;
+    plDesc.bindGroupLayoutCount = 1; plDesc.bindGroupLayouts = &_bind_group_layout;
     WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
 
-    // Bind group
+    // Render pipeline
+    WGPURenderPipelineDescriptor pipelineDesc = {};
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.vertex.module = shaderModule;
+    pipelineDesc.vertex.entryPoint = WGPU_STR("vs_main");
+    WGPUFragmentState fragState = {};
+    fragState.module = shaderModule; fragState.entryPoint = WGPU_STR("fs_main");
+    WGPUColorTargetState colorTarget = {};
+    colorTarget.format = targetFormat; colorTarget.writeMask = WGPUColorWriteMask_All;
+    WGPUBlendState blend = {};
+    blend.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.color.operation = WGPUBlendOperation_Add;
+    blend.alpha.srcFactor = WGPUBlendFactor_One;
+    blend.alpha.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.alpha.operation = WGPUBlendOperation_Add;
+    colorTarget.blend = &blend;
+    fragState.targetCount = 1; fragState.targets = &colorTarget;
+    pipelineDesc.fragment = &fragState;
+    pipelineDesc.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipelineDesc.multisample.count = 1; pipelineDesc.multisample.mask = ~0u;
+
+    _pipeline = wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
+
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+
+    if (!_pipeline) return Err<void>("Failed to create render pipeline");
+
+    std::cout << "VideoLayer: pipeline created" << std::endl;
+    return Ok();
+}
+
+Result<void> VideoLayer::createBindGroup(WebGPUContext& ctx, WGPUTextureView view) {
+    if (_bind_group) { wgpuBindGroupRelease(_bind_group); _bind_group = nullptr; }
+
     WGPUBindGroupEntry bgE[3] = {};
     bgE[0].binding = 0; bgE[0].buffer = _uniform_buffer; bgE[0].size = 16;
     bgE[1].binding = 1; bgE[1].sampler = _sampler;
-    bgE[2].binding = 2; bgE[2].textureView = _texture_view;
+    bgE[2].binding = 2; bgE[2].textureView = view;
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.layout = _bind_group_layout; bgDesc.entryCount = 3; bgDesc.entries = bgE;
+    _bind_group = wgpuDeviceCreateBindGroup(ctx.getDevice(), &bgDesc);
+    if (!_bind_group) return Err<void>("Failed to create bind group");
+    return Ok();
+}
+
+Result<void> VideoLayer::bindSharedTexture(WebGPUContext& ctx, WGPUTextureFormat targetFormat) {
+    GPURegistry::Texture shared;
+    if (!GPURegistry::instance().findTexture(_shared_name, shared)) {
+        // Removed by the producer; keep polling for a new publish
+        if (_bind_group) { wgpuBindGroupRelease(_bind_group); _bind_group = nullptr; }
+        _shared_published = 0;
+        return Ok();
+    }
+
+    if (!_pipeline) {
+        // Any float format the producer picks can be sampled unfiltered
+        if (auto res = createQuadPipeline(ctx, targetFormat, false); !res) return res;
+    }
+
+    // The bind group keeps its own reference to the view; only a new object
+    // behind the name needs a new one
+    if (shared.published != _shared_published || !_bind_group) {
+        if (auto res = createBindGroup(ctx, shared.view); !res) return res;
+        _shared_published = shared.published;
+    }
+    return Ok();
+}
+
+//-----------------------------------------------------------------------------
+// VideoLayer - high bit depth path
+//-----------------------------------------------------------------------------
+
+void VideoLayer::updateHdrTextures(WebGPUContext& ctx) {
+    if (!_plane_textures[0] || !_frame_updated || !_has_frame) return;
+
+    for (int i = 0; i < 3; i++) {
+        uint32_t w = static_cast<uint32_t>(i == 0 ? _video_width : _chroma_width);
+        uint32_t h = static_cast<uint32_t>(i == 0 ? _video_height : _chroma_height);
+        if (!_frame->data[i] || _frame->linesize[i] <= 0) continue;
+
+        WGPUTexelCopyTextureInfo dst = {};
+        dst.texture = _plane_textures[i];
+        WGPUTexelCopyBufferLayout layout = {};
+        layout.bytesPerRow = static_cast<uint32_t>(_frame->linesize[i]);
+        layout.rowsPerImage = h;
+        WGPUExtent3D extent = {w, h, 1};
+        wgpuQueueWriteTexture(ctx.getQueue(), &dst, _frame->data[i],
+                              static_cast<size_t>(_frame->linesize[i]) * h, &layout, &extent);
+    }
+
+    _frame_updated = false;
+}
+
+Result<void> VideoLayer::createHdrPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat) {
+    WGPUDevice device = ctx.getDevice();
+
+    // One R16Uint texture per plane - core WebGPU, no 16-bit norm feature needed.
+    // Filtering is done manually in the shader with textureLoad.
+    for (int i = 0; i < 3; i++) {
+        WGPUTextureDescriptor texDesc = {};
+        texDesc.size.width = static_cast<uint32_t>(i == 0 ? _video_width : _chroma_width);
+        texDesc.size.height = static_cast<uint32_t>(i == 0 ? _video_height : _chroma_height);
+        texDesc.size.depthOrArrayLayers = 1;
+        texDesc.mipLevelCount = 1;
+        texDesc.sampleCount = 1;
+        texDesc.dimension = WGPUTextureDimension_2D;
+        texDesc.format = WGPUTextureFormat_R16Uint;
+        texDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+        _plane_textures[i] = wgpuDeviceCreateTexture(device, &texDesc);
+        if (!_plane_textures[i]) return Err<void>("Failed to create plane texture");
+
+        WGPUTextureViewDescriptor viewDesc = {};
+        viewDesc.format = WGPUTextureFormat_R16Uint;
+        viewDesc.dimension = WGPUTextureViewDimension_2D;
+        viewDesc.mipLevelCount = 1;
+        viewDesc.arrayLayerCount = 1;
+        _plane_views[i] = wgpuTextureCreateView(_plane_textures[i], &viewDesc);
+        if (!_plane_views[i]) return Err<void>("Failed to create plane texture view");
+    }
+    _frame_updated = _has_frame;
+
+    // rect + sample scale (2^(depth-8)), transfer, matrix, full range
+    struct HdrUniforms {
+        float rect[4];
+        float scale;
+        uint32_t transfer;
+        uint32_t matrix;
+        uint32_t fullRange;
+    } params = {};
+    params.scale = static_cast<float>(1 << (_bit_depth - 8));
+    params.transfer = _transfer;
+    params.matrix = _matrix;
+    params.fullRange = _full_range ? 1u : 0u;
+
+    WGPUBufferDescriptor bufDesc = {};
+    bufDesc.size = sizeof(HdrUniforms);
+    bufDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+    _uniform_buffer = wgpuDeviceCreateBuffer(device, &bufDesc);
+    if (!_uniform_buffer) return Err<void>("Failed to create uniform buffer");
+    wgpuQueueWriteBuffer(ctx.getQueue(), _uniform_buffer, 0, &params, sizeof(params));
+
+    const char* shaderCode = R"(
+struct Uniforms { rect: vec4<f32>, scale: f32, transfer: u32, matrix: u32, fullRange: u32, }
+@group(0) @binding(0) var<uniform> u: Uniforms;
+@group(0) @binding(1) var texY: texture_2d<u32>;
+@group(0) @binding(2) var texU: texture_2d<u32>;
+@group(0) @binding(3) var texV: texture_2d<u32>;
+struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) uv: vec2<f32>, }
+@vertex fn vs_main(@builtin(vertex_index) vi: u32) -> VertexOutput {
+    var p = array<vec2<f32>,6>(vec2(0.,0.),vec2(1.,0.),vec2(1.,1.),vec2(0.,0.),vec2(1.,1.),vec2(0.,1.));
+    let pos = p[vi];
+    var o: VertexOutput;
+    o.position = vec4(u.rect.x + pos.x * u.rect.z, u.rect.y - pos.y * u.rect.w, 0., 1.);
+    o.uv = pos;
+    return o;
+}
+// Bilinear filter for integer textures
+fn loadPlane(t: texture_2d<u32>, uv: vec2<f32>) -> f32 {
+    let dims = vec2<i32>(textureDimensions(t));
+    let p = uv * vec2<f32>(dims) - 0.5;
+    let i = vec2<i32>(floor(p));
+    let f = fract(p);
+    let hi = dims - vec2<i32>(1, 1);
+    let lo = vec2<i32>(0, 0);
+    let a = f32(textureLoad(t, clamp(i, lo, hi), 0).r);
+    let b = f32(textureLoad(t, clamp(i + vec2<i32>(1, 0), lo, hi), 0).r);
+    let c = f32(textureLoad(t, clamp(i + vec2<i32>(0, 1), lo, hi), 0).r);
+    let d = f32(textureLoad(t, clamp(i + vec2<i32>(1, 1), lo, hi), 0).r);
+    return mix(mix(a, b, f.x), mix(c, d, f.x), f.y);
+}
+fn pqEotf(e: vec3<f32>) -> vec3<f32> {
+    let m1 = 0.1593017578125; let m2 = 78.84375;
+    let c1 = 0.8359375; let c2 = 18.8515625; let c3 = 18.6875;
+    let ep = pow(max(e, vec3(0.0)), vec3(1.0 / m2));
+    return pow(max(ep - c1, vec3(0.0)) / (c2 - c3 * ep), vec3(1.0 / m1));  // 1.0 = 10000 nits
+}
+fn hlgEotf(e: vec3<f32>) -> vec3<f32> {
+    let a = 0.17883277; let b = 0.28466892; let c = 0.55991073;
+    let lo = e * e / 3.0;
+    let hi = (exp((e - c) / a) + b) / 12.0;
+    let scene = select(hi, lo, e <= vec3(0.5));
+    let ys = dot(scene, vec3(0.2627, 0.6780, 0.0593));
+    return scene * pow(max(ys, 1e-6), 0.2);  // OOTF, system gamma 1.2, 1.0 = 1000 nits
+}
+const BT2020_TO_BT709 = mat3x3<f32>(
+    vec3<f32>( 1.6605, -0.1246, -0.0182),
+    vec3<f32>(-0.5876,  1.1329, -0.1006),
+    vec3<f32>(-0.0728, -0.0083,  1.1187));
+@fragment fn fs_main(@location(0) uv: vec2<f32>) -> @location(0) vec4<f32> {
+    let s = u.scale;
+    let yv = loadPlane(texY, uv);
+    let cb = loadPlane(texU, uv);
+    let cr = loadPlane(texV, uv);
+    var y: f32; var pb: f32; var pr: f32;
+    if (u.fullRange != 0u) {
+        let maxv = 256.0 * s - 1.0;
+        y = yv / maxv; pb = (cb - 128.0 * s) / maxv; pr = (cr - 128.0 * s) / maxv;
+    } else {
+        y = (yv - 16.0 * s) / (219.0 * s);
+        pb = (cb - 128.0 * s) / (224.0 * s);
+        pr = (cr - 128.0 * s) / (224.0 * s);
+    }
+    var kr = 0.2126; var kb = 0.0722;
+    if (u.matrix == 1u) { kr = 0.2627; kb = 0.0593; }
+    else if (u.matrix == 2u) { kr = 0.299; kb = 0.114; }
+    let r = y + 2.0 * (1.0 - kr) * pr;
+    let b = y + 2.0 * (1.0 - kb) * pb;
+    let g = (y - kr * r - kb * b) / (1.0 - kr - kb);
+    var rgb = clamp(vec3(r, g, b), vec3(0.0), vec3(1.0));
+
+    if (u.transfer == 0u) {
+        if (u.matrix == 1u) {
+            rgb = pow(clamp(BT2020_TO_BT709 * pow(rgb, vec3(2.4)), vec3(0.0), vec3(1.0)), vec3(1.0 / 2.4));
+        }
+        return vec4(rgb, 1.0);
+    }
+
+    // Linear light relative to SDR reference white (203 nits), then BT.709 primaries
+    var lin: vec3<f32>;
+    if (u.transfer == 1u) { lin = pqEotf(rgb) * (10000.0 / 203.0); }
+    else { lin = hlgEotf(rgb) * (1000.0 / 203.0); }
+    lin = max(BT2020_TO_BT709 * lin, vec3(0.0));
+
+    // Extended Reinhard on the max channel preserves hue; 1000 nit peak maps to white
+    let peak = 1000.0 / 203.0;
+    let m = max(max(lin.r, lin.g), max(lin.b, 1e-6));
+    let mapped = m * (1.0 + m / (peak * peak)) / (1.0 + m);
+    lin = lin * (mapped / m);
+    return vec4(pow(clamp(lin, vec3(0.0), vec3(1.0)), vec3(1.0 / 2.2)), 1.0);
+}
+)";
+
+    WGPUShaderSourceWGSL wgslDesc = {};
+    wgslDesc.chain.sType = WGPUSType_ShaderSourceWGSL;
+    wgslDesc.code = WGPU_STR(shaderCode);
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = &wgslDesc.chain;
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
+    if (!shaderModule) return Err<void>("Failed to create HDR shader module");
+
+    // Bind group layout: uniforms + Y/U/V planes
+    WGPUBindGroupLayoutEntry entries[4] = {};
+    entries[0].binding = 0;
+    entries[0].visibility = WGPUShaderStage_Vertex | WGPUShaderStage_Fragment;
+    entries[0].buffer.type = WGPUBufferBindingType_Uniform;
+    for (int i = 1; i < 4; i++) {
+        entries[i].binding = static_cast<uint32_t>(i);
+        entries[i].visibility = WGPUShaderStage_Fragment;
+        entries[i].texture.sampleType = WGPUTextureSampleType_Uint;
+        entries[i].texture.viewDimension = WGPUTextureViewDimension_2D;
+    }
+
+    WGPUBindGroupLayoutDescriptor bglDesc = {};
+    bglDesc.entryCount = 4; bglDesc.entries = entries;
+    WGPUBindGroupLayout bgl = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+    if (!bgl) { wgpuShaderModuleRelease(shaderModule); return Err<void>("Failed to create bgl"); }
+
+    WGPUPipelineLayoutDescriptor plDesc = {};
+    plDesc.bindGroupLayoutCount = 1; plDesc.bindGroupLayouts = &bgl;
+    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
+
+    WGPUBindGroupEntry bgE[4] = {};
+    bgE[0].binding = 0; bgE[0].buffer = _uniform_buffer; bgE[0].size = sizeof(HdrUniforms);
+    for (int i = 1; i < 4; i++) {
+        bgE[i].binding = static_cast<uint32_t>(i);
+        bgE[i].textureView = _plane_views[i - 1];
+    }
     WGPUBindGroupDescriptor bgDesc = {};
-    bgDesc.layout = bgl; bgDesc.entryCount = 3; bgDesc.entries = bgE;
+    bgDesc.layout = bgl; bgDesc.entryCount = 4; bgDesc.entries = bgE;
     _bind_group = wgpuDeviceCreateBindGroup(device, &bgDesc);
 
-    // Render pipeline
     WGPURenderPipelineDescriptor pipelineDesc = {};
     pipelineDesc.layout = pipelineLayout;
     pipelineDesc.vertex.module = shaderModule;
@@ -720,12 +1196,425 @@ struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) uv: v
     wgpuBindGroupLayoutRelease(bgl);
     wgpuPipelineLayoutRelease(pipelineLayout);
 
-    if (!_pipeline) return Err<void>("Failed to create render pipeline");
+    if (!_pipeline) return Err<void>("Failed to create HDR render pipeline");
 
-    std::cout << "VideoLayer: pipeline created" << std::endl;
+    std::cout << "VideoLayer: HDR pipeline created" << std::endl;
+    return Ok();
+}
+
+//-----------------------------------------------------------------------------
+// VideoPlugin - mosaic atlas
+//-----------------------------------------------------------------------------
+
+Result<void> VideoPlugin::submitMosaicTile(WebGPUContext& ctx, const RenderContext& rc,
+                                           VideoLayer* layer, const float ndcRect[4],
+                                           const uint8_t* pixels, uint32_t width, uint32_t height,
+                                           bool updated) {
+    beginMosaicFrame(rc, layer);
+
+    auto& tile = _mosaic_tiles[layer];
+    tile.lastFrame = _mosaic_frame;
+
+    if (!tile.allocated || tile.width != width || tile.height != height) {
+        if (tile.allocated) {
+            _mosaic_packer.release(tile.rect);
+            tile.allocated = false;
+        }
+        if (auto res = allocateMosaicTile(ctx, rc, tile, width, height); !res) {
+            return res;
+        }
+    }
+
+    if (updated || !tile.uploaded) {
+        WGPUTexelCopyTextureInfo dst = {};
+        dst.texture = _mosaic_texture;
+        dst.origin = {tile.rect.x, tile.rect.y, 0};
+        WGPUTexelCopyBufferLayout layout = {};
+        layout.bytesPerRow = width * 4;
+        layout.rowsPerImage = height;
+        WGPUExtent3D extent = {width, height, 1};
+        wgpuQueueWriteTexture(ctx.getQueue(), &dst, pixels,
+                              static_cast<size_t>(width) * height * 4, &layout, &extent);
+        tile.uploaded = true;
+    }
+
+    // Half-texel inset keeps linear filtering inside the tile
+    float texel = 1.0f / static_cast<float>(_mosaic_packer.size());
+    MosaicInstance instance;
+    std::memcpy(instance.rect, ndcRect, sizeof(instance.rect));
+    instance.uv[0] = (tile.rect.x + 0.5f) * texel;
+    instance.uv[1] = (tile.rect.y + 0.5f) * texel;
+    instance.uv[2] = (width - 1.0f) * texel;
+    instance.uv[3] = (height - 1.0f) * texel;
+    _mosaic_instances.push_back(instance);
+
+    return reportMosaicLayer(ctx, rc, layer);
+}
+
+Result<void> VideoPlugin::skipMosaicTile(WebGPUContext& ctx, const RenderContext& rc,
+                                         VideoLayer* layer) {
+    // Evicted layers no longer take part in the batch
+    if (!_mosaic_tiles.count(layer)) return Ok();
+
+    beginMosaicFrame(rc, layer);
+    return reportMosaicLayer(ctx, rc, layer);
+}
+
+void VideoPlugin::releaseMosaicTile(VideoLayer* layer) {
+    auto it = _mosaic_tiles.find(layer);
+    if (it == _mosaic_tiles.end()) return;
+
+    if (it->second.allocated) {
+        _mosaic_packer.release(it->second.rect);
+    }
+    _mosaic_tiles.erase(it);
+    _mosaic_reported.erase(layer);
+    _mosaic_expected.erase(layer);
+}
+
+void VideoPlugin::beginMosaicFrame(const RenderContext& rc, VideoLayer* layer) {
+    // A new target view, or a layer reporting twice, means the previous frame
+    // is over (the view handle alone may be recycled by the surface)
+    if (rc.targetView == _mosaic_frame_view && !_mosaic_reported.count(layer)) return;
+
+    if (!_mosaic_instances.empty()) {
+        // Built for a frame that has been presented; drawing it now would put
+        // last frame's tiles on this frame's target
+        _mosaic_instances.clear();
+        if (_mosaic_dropped++ == 0) {
+            std::cout << "VideoPlugin: dropped a mosaic batch whose frame ended early" << std::endl;
+        }
+    }
+
+    // Whoever reported last frame is who we wait for this frame
+    _mosaic_expected = std::move(_mosaic_reported);
+    _mosaic_reported.clear();
+    if (_mosaic_expected.empty()) {
+        for (const auto& entry : _mosaic_tiles) _mosaic_expected.insert(entry.first);
+    }
+    _mosaic_frame_view = rc.targetView;
+    _mosaic_flushed = false;
+    _mosaic_frame++;
+}
+
+Result<void> VideoPlugin::reportMosaicLayer(WebGPUContext& ctx, const RenderContext& rc,
+                                            VideoLayer* layer) {
+    _mosaic_reported.insert(layer);
+
+    // A layer that was not rendered last frame comes after the batch was
+    // drawn: draw its tile on its own rather than wait for the next frame
+    if (_mosaic_flushed) return flushMosaic(ctx, rc);
+
+    for (VideoLayer* expected : _mosaic_expected) {
+        if (!_mosaic_reported.count(expected) && _mosaic_tiles.count(expected)) return Ok();
+    }
+    _mosaic_flushed = true;
+    return flushMosaic(ctx, rc);
+}
+
+Result<void> VideoPlugin::allocateMosaicTile(WebGPUContext& ctx, const RenderContext& rc,
+                                             MosaicTile& tile, uint32_t width, uint32_t height) {
+    if (!_mosaic_texture) {
+        if (auto res = createMosaicTexture(ctx, _mosaic_packer.size()); !res) return res;
+    }
+
+    // One texel gutter on the right/bottom keeps neighbours from bleeding in
+    uint32_t paddedW = width + 1;
+    uint32_t paddedH = height + 1;
+
+    auto rect = _mosaic_packer.allocate(paddedW, paddedH);
+
+    if (!rect) {
+        // Evict tiles of layers that have not been drawn for a while
+        for (auto it = _mosaic_tiles.begin(); it != _mosaic_tiles.end();) {
+            auto& other = it->second;
+            if (&other != &tile && _mosaic_frame - other.lastFrame > MOSAIC_EVICT_FRAMES) {
+                if (other.allocated) _mosaic_packer.release(other.rect);
+                _mosaic_reported.erase(it->first);
+                _mosaic_expected.erase(it->first);
+                it = _mosaic_tiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        rect = _mosaic_packer.allocate(paddedW, paddedH);
+    }
+
+    if (!rect) {
+        // Draw what is queued, then repack everything - possibly into a larger
+        // atlas. Other tiles re-upload from their layer on the next submit.
+        if (auto res = flushMosaic(ctx, rc); !res) return res;
+
+        uint64_t needed = static_cast<uint64_t>(paddedW) * paddedH;
+        for (const auto& [layer, other] : _mosaic_tiles) {
+            if (&other != &tile) {
+                needed += static_cast<uint64_t>(other.width + 1) * (other.height + 1);
+            }
+        }
+
+        uint32_t size = _mosaic_packer.size();
+        while (size < MOSAIC_ATLAS_MAX_SIZE &&
+               needed * 4 > static_cast<uint64_t>(size) * size * 3) {
+            size *= 2;
+        }
+        if (size != _mosaic_packer.size()) {
+            if (auto res = createMosaicTexture(ctx, size); !res) return res;
+            std::cout << "VideoPlugin: mosaic atlas grown to " << size << "x" << size << std::endl;
+        }
+
+        _mosaic_packer.reset(size);
+        for (auto& [layer, other] : _mosaic_tiles) {
+            other.allocated = false;
+            other.uploaded = false;
+        }
+        rect = _mosaic_packer.allocate(paddedW, paddedH);
+    }
+
+    if (!rect) {
+        return Err<void>("Video mosaic atlas is full");
+    }
+
+    tile.rect = *rect;
+    tile.width = width;
+    tile.height = height;
+    tile.allocated = true;
+    tile.uploaded = false;
+    return Ok();
+}
+
+Result<void> VideoPlugin::flushMosaic(WebGPUContext& ctx, const RenderContext& rc) {
+    auto instances = std::move(_mosaic_instances);
+    _mosaic_instances.clear();
+    if (instances.empty()) return Ok();
+
+    if (!_mosaic_bind_group) {
+        return Err<void>("Video mosaic atlas not initialized");
+    }
+    if (!_mosaic_pipeline || _mosaic_format != rc.targetFormat) {
+        if (auto res = createMosaicPipeline(ctx, rc.targetFormat); !res) return res;
+    }
+
+    WGPUDevice device = ctx.getDevice();
+
+    // Grow the instance buffer geometrically
+    if (instances.size() > _mosaic_instance_capacity) {
+        if (_mosaic_instance_buffer) {
+            wgpuBufferRelease(_mosaic_instance_buffer);
+            _mosaic_instance_buffer = nullptr;
+        }
+        _mosaic_instance_capacity = std::max<size_t>({instances.size(), _mosaic_instance_capacity * 2, 64});
+
+        WGPUBufferDescriptor bufDesc = {};
+        bufDesc.size = _mosaic_instance_capacity * sizeof(MosaicInstance);
+        bufDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
+        _mosaic_instance_buffer = wgpuDeviceCreateBuffer(device, &bufDesc);
+        if (!_mosaic_instance_buffer) {
+            _mosaic_instance_capacity = 0;
+            return Err<void>("Failed to create mosaic instance buffer");
+        }
+    }
+
+    size_t bytes = instances.size() * sizeof(MosaicInstance);
+    wgpuQueueWriteBuffer(ctx.getQueue(), _mosaic_instance_buffer, 0, instances.data(), bytes);
+
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+    if (!encoder) return Err<void>("Failed to create command encoder");
+
+    WGPURenderPassColorAttachment colorAttachment = {};
+    colorAttachment.view = rc.targetView;
+    colorAttachment.loadOp = WGPULoadOp_Load;
+    colorAttachment.storeOp = WGPUStoreOp_Store;
+    colorAttachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+    WGPURenderPassDescriptor passDesc = {};
+    passDesc.colorAttachmentCount = 1;
+    passDesc.colorAttachments = &colorAttachment;
+
+    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &passDesc);
+    if (!pass) {
+        wgpuCommandEncoderRelease(encoder);
+        return Err<void>("Failed to begin render pass");
+    }
+
+    wgpuRenderPassEncoderSetPipeline(pass, _mosaic_pipeline);
+    wgpuRenderPassEncoderSetBindGroup(pass, 0, _mosaic_bind_group, 0, nullptr);
+    wgpuRenderPassEncoderSetVertexBuffer(pass, 0, _mosaic_instance_buffer, 0, bytes);
+    wgpuRenderPassEncoderDraw(pass, 6, static_cast<uint32_t>(instances.size()), 0, 0);
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+
+    WGPUCommandBufferDescriptor cmdDesc = {};
+    WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdDesc);
+    if (cmdBuffer) {
+        wgpuQueueSubmit(ctx.getQueue(), 1, &cmdBuffer);
+        wgpuCommandBufferRelease(cmdBuffer);
+    }
+    wgpuCommandEncoderRelease(encoder);
+    return Ok();
+}
+
+Result<void> VideoPlugin::createMosaicTexture(WebGPUContext& ctx, uint32_t size) {
+    WGPUDevice device = ctx.getDevice();
+
+    if (_mosaic_bind_group) { wgpuBindGroupRelease(_mosaic_bind_group); _mosaic_bind_group = nullptr; }
+    if (_mosaic_view) { wgpuTextureViewRelease(_mosaic_view); _mosaic_view = nullptr; }
+    if (_mosaic_texture) { wgpuTextureRelease(_mosaic_texture); _mosaic_texture = nullptr; }
+
+    WGPUTextureDescriptor texDesc = {};
+    texDesc.size.width = size;
+    texDesc.size.height = size;
+    texDesc.size.depthOrArrayLayers = 1;
+    texDesc.mipLevelCount = 1;
+    texDesc.sampleCount = 1;
+    texDesc.dimension = WGPUTextureDimension_2D;
+    texDesc.format = WGPUTextureFormat_RGBA8Unorm;
+    texDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+    _mosaic_texture = wgpuDeviceCreateTexture(device, &texDesc);
+    if (!_mosaic_texture) return Err<void>("Failed to create mosaic texture");
+
+    WGPUTextureViewDescriptor viewDesc = {};
+    viewDesc.format = WGPUTextureFormat_RGBA8Unorm;
+    viewDesc.dimension = WGPUTextureViewDimension_2D;
+    viewDesc.mipLevelCount = 1;
+    viewDesc.arrayLayerCount = 1;
+    _mosaic_view = wgpuTextureCreateView(_mosaic_texture, &viewDesc);
+    if (!_mosaic_view) return Err<void>("Failed to create mosaic texture view");
+
+    if (!_mosaic_sampler) {
+        WGPUSamplerDescriptor samplerDesc = {};
+        samplerDesc.minFilter = WGPUFilterMode_Linear;
+        samplerDesc.magFilter = WGPUFilterMode_Linear;
+        samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+        samplerDesc.maxAnisotropy = 1;
+        _mosaic_sampler = wgpuDeviceCreateSampler(device, &samplerDesc);
+        if (!_mosaic_sampler) return Err<void>("Failed to create mosaic sampler");
+    }
+
+    if (!_mosaic_bgl) {
+        WGPUBindGroupLayoutEntry entries[2] = {};
+        entries[0].binding = 0; entries[0].visibility = WGPUShaderStage_Fragment;
+        entries[0].sampler.type = WGPUSamplerBindingType_Filtering;
+        entries[1].binding = 1; entries[1].visibility = WGPUShaderStage_Fragment;
+        entries[1].texture.sampleType = WGPUTextureSampleType_Float;
+        entries[1].texture.viewDimension = WGPUTextureViewDimension_2D;
+
+        WGPUBindGroupLayoutDescriptor bglDesc = {};
+        bglDesc.entryCount = 2; bglDesc.entries = entries;
+        _mosaic_bgl = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+        if (!_mosaic_bgl) return Err<void>("Failed to create mosaic bgl");
+    }
+
+    WGPUBindGroupEntry bgE[2] = {};
+    bgE[0].binding = 0; bgE[0].sampler = _mosaic_sampler;
+    bgE[1].binding = 1; bgE[1].textureView = _mosaic_view;
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.layout = _mosaic_bgl; bgDesc.entryCount = 2; bgDesc.entries = bgE;
+    _mosaic_bind_group = wgpuDeviceCreateBindGroup(device, &bgDesc);
+    if (!_mosaic_bind_group) return Err<void>("Failed to create mosaic bind group");
+
+    return Ok();
+}
+
+Result<void> VideoPlugin::createMosaicPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat) {
+    WGPUDevice device = ctx.getDevice();
+
+    if (_mosaic_pipeline) { wgpuRenderPipelineRelease(_mosaic_pipeline); _mosaic_pipeline = nullptr; }
+
+    // One quad per instance: rect in NDC, uv sub-rectangle in the atlas
+    const char* shaderCode = R"(
+@group(0) @binding(0) var texSampler: sampler;
+@group(0) @binding(1) var tex: texture_2d<f32>;
+struct VertexOutput { @builtin(position) position: vec4<f32>, @location(0) uv: vec2<f32>, }
+@vertex fn vs_main(@builtin(vertex_index) vi: u32,
+                   @location(0) rect: vec4<f32>, @location(1) uvRect: vec4<f32>) -> VertexOutput {
+    var p = array<vec2<f32>,6>(vec2(0.,0.),vec2(1.,0.),vec2(1.,1.),vec2(0.,0.),vec2(1.,1.),vec2(0.,1.));
+    let pos = p[vi];
+    var o: VertexOutput;
+    o.position = vec4(rect.x + pos.x * rect.z, rect.y - pos.y * rect.w, 0., 1.);
+    o.uv = uvRect.xy + pos * uvRect.zw;
+    return o;
+}
+@fragment fn fs_main(@location(0) uv: vec2<f32>) -> @location(0) vec4<f32> {
+    return textureSample(tex, texSampler, uv);
+}
+)";
+
+    WGPUShaderSourceWGSL wgslDesc = {};
+    wgslDesc.chain.sType = WGPUSType_ShaderSourceWGSL;
+    wgslDesc.code = WGPU_STR(shaderCode);
+    WGPUShaderModuleDescriptor shaderDesc = {};
+    shaderDesc.nextInChain = &wgslDesc.chain;
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule(device, &shaderDesc);
+    if (!shaderModule) return Err<void>("Failed to create mosaic shader module");
+
+    WGPUPipelineLayoutDescriptor plDesc = {};
+    plDesc.bindGroupLayoutCount = 1; plDesc.bindGroupLayouts = &_mosaic_bgl;
+    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
+
+    WGPUVertexAttribute attributes[2] = {};
+    attributes[0].format = WGPUVertexFormat_Float32x4;
+    attributes[0].offset = offsetof(MosaicInstance, rect);
+    attributes[0].shaderLocation = 0;
+    attributes[1].format = WGPUVertexFormat_Float32x4;
+    attributes[1].offset = offsetof(MosaicInstance, uv);
+    attributes[1].shaderLocation = 1;
+
+    WGPUVertexBufferLayout instanceLayout = {};
+    instanceLayout.stepMode = WGPUVertexStepMode_Instance;
+    instanceLayout.arrayStride = sizeof(MosaicInstance);
+    instanceLayout.attributeCount = 2;
+    instanceLayout.attributes = attributes;
+
+    WGPURenderPipelineDescriptor pipelineDesc = {};
+    pipelineDesc.layout = pipelineLayout;
+    pipelineDesc.vertex.module = shaderModule;
+    pipelineDesc.vertex.entryPoint = WGPU_STR("vs_main");
+    pipelineDesc.vertex.bufferCount = 1;
+    pipelineDesc.vertex.buffers = &instanceLayout;
+    WGPUFragmentState fragState = {};
+    fragState.module = shaderModule; fragState.entryPoint = WGPU_STR("fs_main");
+    WGPUColorTargetState colorTarget = {};
+    colorTarget.format = targetFormat; colorTarget.writeMask = WGPUColorWriteMask_All;
+    WGPUBlendState blend = {};
+    blend.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    blend.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.color.operation = WGPUBlendOperation_Add;
+    blend.alpha.srcFactor = WGPUBlendFactor_One;
+    blend.alpha.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend.alpha.operation = WGPUBlendOperation_Add;
+    colorTarget.blend = &blend;
+    fragState.targetCount = 1; fragState.targets = &colorTarget;
+    pipelineDesc.fragment = &fragState;
+    pipelineDesc.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipelineDesc.multisample.count = 1; pipelineDesc.multisample.mask = ~0u;
+
+    _mosaic_pipeline = wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
+
+    wgpuShaderModuleRelease(shaderModule);
+    wgpuPipelineLayoutRelease(pipelineLayout);
+
+    if (!_mosaic_pipeline) return Err<void>("Failed to create mosaic pipeline");
+    _mosaic_format = targetFormat;
+
+    std::cout << "VideoPlugin: mosaic pipeline created" << std::endl;
     return Ok();
 }
 
+void VideoPlugin::releaseMosaicGpu() {
+    if (_mosaic_pipeline) { wgpuRenderPipelineRelease(_mosaic_pipeline); _mosaic_pipeline = nullptr; }
+    if (_mosaic_bind_group) { wgpuBindGroupRelease(_mosaic_bind_group); _mosaic_bind_group = nullptr; }
+    if (_mosaic_bgl) { wgpuBindGroupLayoutRelease(_mosaic_bgl); _mosaic_bgl = nullptr; }
+    if (_mosaic_sampler) { wgpuSamplerRelease(_mosaic_sampler); _mosaic_sampler = nullptr; }
+    if (_mosaic_view) { wgpuTextureViewRelease(_mosaic_view); _mosaic_view = nullptr; }
+    if (_mosaic_texture) { wgpuTextureRelease(_mosaic_texture); _mosaic_texture = nullptr; }
+    if (_mosaic_instance_buffer) { wgpuBufferRelease(_mosaic_instance_buffer); _mosaic_instance_buffer = nullptr; }
+    _mosaic_instance_capacity = 0;
+    _mosaic_format = WGPUTextureFormat_Undefined;
+}
+
 } // namespace yetty
 
 extern "C" {
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "mosaic-atlas.h"
 #include <yetty/plugin.h>
 #include <webgpu/webgpu.h>
 #include <memory>
+#include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include <atomic>
 #include <thread>
@@ -38,9 +42,65 @@ public:
     // Check if data looks like a video format
     static bool isVideoFormat(const std::string& data);
 
+    // Mosaic mode - small layers upload their frames into a shared atlas and
+    // are drawn together with one instanced draw. A frame is identified by its
+    // target view; the batch is drawn when the last layer seen in the previous
+    // frame reports, so it always lands on the frame it was built for. A batch
+    // whose frame ended early (a layer stopped being rendered) is dropped, not
+    // drawn over the next frame. ndcRect is x, y, w, h in normalized device coords.
+    Result<void> submitMosaicTile(WebGPUContext& ctx, const RenderContext& rc, VideoLayer* layer,
+                                  const float ndcRect[4], const uint8_t* pixels,
+                                  uint32_t width, uint32_t height, bool updated);
+    Result<void> skipMosaicTile(WebGPUContext& ctx, const RenderContext& rc, VideoLayer* layer);
+    void releaseMosaicTile(VideoLayer* layer);
+
 private:
     explicit VideoPlugin(YettyPtr engine) noexcept : Plugin(std::move(engine)) {}
+    std::weak_ptr<VideoPlugin> _self;  // handed to layers, which may outlive us
     Result<void> init() noexcept override;
+
+    struct MosaicTile {
+        MosaicAtlasPacker::Rect rect;  // includes the 1px gutter
+        uint32_t width = 0;
+        uint32_t height = 0;
+        bool allocated = false;
+        bool uploaded = false;
+        uint64_t lastFrame = 0;
+    };
+
+    struct MosaicInstance {
+        float rect[4];  // NDC x, y, w, h
+        float uv[4];    // atlas u, v, du, dv
+    };
+
+    void beginMosaicFrame(const RenderContext& rc, VideoLayer* layer);
+    Result<void> reportMosaicLayer(WebGPUContext& ctx, const RenderContext& rc, VideoLayer* layer);
+    Result<void> allocateMosaicTile(WebGPUContext& ctx, const RenderContext& rc,
+                                    MosaicTile& tile, uint32_t width, uint32_t height);
+    Result<void> flushMosaic(WebGPUContext& ctx, const RenderContext& rc);
+    Result<void> createMosaicTexture(WebGPUContext& ctx, uint32_t size);
+    Result<void> createMosaicPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat);
+    void releaseMosaicGpu();
+
+    MosaicAtlasPacker _mosaic_packer{1024};
+    std::unordered_map<VideoLayer*, MosaicTile> _mosaic_tiles;
+    std::unordered_set<VideoLayer*> _mosaic_reported;  // this frame
+    std::unordered_set<VideoLayer*> _mosaic_expected;  // reported last frame
+    std::vector<MosaicInstance> _mosaic_instances;
+    WGPUTextureView _mosaic_frame_view = nullptr;      // target of the pending batch
+    bool _mosaic_flushed = false;                      // batch for this frame drawn
+    uint64_t _mosaic_frame = 0;
+    uint64_t _mosaic_dropped = 0;
+
+    WGPUTexture _mosaic_texture = nullptr;
+    WGPUTextureView _mosaic_view = nullptr;
+    WGPUSampler _mosaic_sampler = nullptr;
+    WGPUBindGroupLayout _mosaic_bgl = nullptr;
+    WGPUBindGroup _mosaic_bind_group = nullptr;
+    WGPURenderPipeline _mosaic_pipeline = nullptr;
+    WGPUTextureFormat _mosaic_format = WGPUTextureFormat_Undefined;
+    WGPUBuffer _mosaic_instance_buffer = nullptr;
+    size_t _mosaic_instance_capacity = 0;
 };
 
 //-----------------------------------------------------------------------------
@@ -48,7 +108,8 @@ private:
 //-----------------------------------------------------------------------------
 class VideoLayer : public PluginLayer {
 public:
-    VideoLayer();
+    // Without a plugin the layer never uses the mosaic path
+    explicit VideoLayer(std::weak_ptr<VideoPlugin> plugin = {});
     ~VideoLayer() override;
 
     Result<void> init(const std::string& payload) override;
@@ -74,8 +135,27 @@ public:
 private:
     Result<void> initFFmpeg(const std::string& data);
     Result<void> decodeNextFrame();
+    Result<void> configureOutput(int width, int height);
+    Result<void> renderMosaic(VideoPlugin& plugin, WebGPUContext& ctx, float pixelX,
+                              float pixelY, float pixelW, float pixelH);
     void updateTexture(WebGPUContext& ctx);
     Result<void> createPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat);
+    // Textured quad shared by decoded frames and registry textures; float
+    // formats that cannot be filtered (rgba32float) are sampled nearest
+    Result<void> createQuadPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat, bool filtering);
+    Result<void> createBindGroup(WebGPUContext& ctx, WGPUTextureView view);
+    Result<void> drawQuad(WebGPUContext& ctx, float pixelX, float pixelY, float pixelW, float pixelH);
+
+    // Shared texture mode - the payload "gpu-texture:<name>" shows a texture
+    // another plugin (e.g. a Python compute layer) published to the GPURegistry
+    Result<void> bindSharedTexture(WebGPUContext& ctx, WGPUTextureFormat targetFormat);
+
+    // High bit depth path - 10/12-bit planar YUV is uploaded as R16Uint planes
+    // and converted (plus PQ/HLG tone mapped) in the fragment shader
+    void updateHdrTextures(WebGPUContext& ctx);
+    Result<void> createHdrPipeline(WebGPUContext& ctx, WGPUTextureFormat targetFormat);
+
+    std::weak_ptr<VideoPlugin> _plugin;
 
     // FFmpeg state
     AVFormatContext* _format_ctx = nullptr;
@@ -100,16 +180,36 @@ private:
     double _frame_time = 0.0;
     double _accumulated_time = 0.0;
 
-    // Frame buffer (RGBA)
+    // Frame buffer (RGBA) - video size, or tile size in mosaic mode
     std::vector<uint8_t> _frame_buffer;
+    int _out_width = 0;
+    int _out_height = 0;
     bool _frame_updated = false;
+    bool _has_frame = false;
+    bool _mosaic = false;
+
+    // High bit depth planar YUV (bypasses swscale outside mosaic mode)
+    bool _hdr_path = false;
+    int _bit_depth = 8;
+    int _chroma_width = 0;
+    int _chroma_height = 0;
+    uint32_t _transfer = 0;     // 0 = SDR, 1 = PQ, 2 = HLG
+    uint32_t _matrix = 0;       // 0 = BT.709, 1 = BT.2020, 2 = BT.601
+    bool _full_range = false;
+    WGPUTexture _plane_textures[3] = {};
+    WGPUTextureView _plane_views[3] = {};
 
     // Custom I/O buffer for in-memory data
     std::vector<uint8_t> _input_data;
     size_t _input_pos = 0;
 
+    // Shared texture mode
+    std::string _shared_name;
+    uint64_t _shared_published = 0;  // Publish generation _bind_group was built for
+
     // WebGPU resources
     WGPURenderPipeline _pipeline = nullptr;
+    WGPUBindGroupLayout _bind_group_layout = nullptr;
     WGPUBindGroup _bind_group = nullptr;
     WGPUBuffer _uniform_buffer = nullptr;
     WGPUTexture _texture = nullptr;
@@ -0,0 +1,85 @@
+#include "draw-cache.h"
+#include <imgui.h>
+
+#include <cstring>
+
+namespace yetty {
+
+DrawCache::~DrawCache() {
+    clear();
+}
+
+void DrawCache::release(Entry& entry) {
+    for (ImDrawList* list : entry.lists) {
+        IM_DELETE(list);
+    }
+    entry.lists.clear();
+}
+
+bool DrawCache::valid(const std::string& key, uint64_t stamp) const {
+    auto it = _entries.find(key);
+    return it != _entries.end() && it->second.stamp == stamp;
+}
+
+void DrawCache::capture(const std::string& key, uint64_t stamp, const ImDrawData* drawData,
+                        const OwnerFilter& filter) {
+    Entry& entry = _entries[key];
+    release(entry);
+    entry.stamp = stamp;
+    entry.used = true;
+    _misses++;
+    if (!drawData) return;
+
+    for (int i = 0; i < drawData->CmdListsCount; ++i) {
+        ImDrawList* list = drawData->CmdLists[i];
+        if (list->_OwnerName && filter(list->_OwnerName)) {
+            entry.lists.push_back(list->CloneOutput());
+        }
+    }
+}
+
+void DrawCache::splice(const std::string& key, ImDrawData* drawData) {
+    auto it = _entries.find(key);
+    if (it == _entries.end() || !drawData) return;
+    it->second.used = true;
+    _hits++;
+    for (ImDrawList* list : it->second.lists) {
+        drawData->AddDrawList(list);
+    }
+}
+
+void DrawCache::invalidate(const std::string& key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end()) return;
+    release(it->second);
+    _entries.erase(it);
+}
+
+void DrawCache::clear() {
+    for (auto& [key, entry] : _entries) {
+        release(entry);
+    }
+    _entries.clear();
+}
+
+void DrawCache::prune() {
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (!it->second.used) {
+            release(it->second);
+            it = _entries.erase(it);
+        } else {
+            it->second.used = false;
+            ++it;
+        }
+    }
+}
+
+DrawCache::OwnerFilter DrawCache::windowFilter(const std::string& prefix) {
+    return [prefix](const char* owner) {
+        size_t len = prefix.size();
+        return std::strncmp(owner, prefix.c_str(), len) == 0 &&
+               (owner[len] == '\0' || owner[len] == '/');
+    };
+}
+
+} // namespace yetty
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ImDrawList;
+struct ImDrawData;
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// DrawCache - ImGui draw lists kept across frames for unchanged windows
+//-----------------------------------------------------------------------------
+// A window whose inputs did not change since its last build is not submitted
+// to ImGui at all; the draw lists it produced last time (its own and those of
+// its child windows) are appended to this frame's ImDrawData instead. Building
+// the widgets and generating their vertices is then skipped entirely.
+//
+// An entry may be a top-level window or a child window whose parent is still
+// built each frame (the parent submits a placeholder of the same size). Each
+// entry carries a caller-computed stamp (rect, content version, ...) and is
+// only reused while the stamp matches. Callers must not skip a window that has
+// focus or owns the active widget: ImGui only keeps that state for windows
+// submitted every frame.
+//-----------------------------------------------------------------------------
+class DrawCache {
+public:
+    // Selects draw lists by their owner window name
+    using OwnerFilter = std::function<bool(const char* ownerName)>;
+
+    DrawCache() = default;
+    ~DrawCache();
+
+    DrawCache(const DrawCache&) = delete;
+    DrawCache& operator=(const DrawCache&) = delete;
+
+    // True if key has lists recorded with this stamp
+    bool valid(const std::string& key, uint64_t stamp) const;
+
+    // After ImGui::Render(): clone the lists accepted by filter
+    void capture(const std::string& key, uint64_t stamp, const ImDrawData* drawData,
+                 const OwnerFilter& filter);
+
+    // After ImGui::Render(): append key's lists to drawData
+    void splice(const std::string& key, ImDrawData* drawData);
+
+    void invalidate(const std::string& key);
+    void clear();
+
+    // Drop entries neither captured nor spliced since the last prune()
+    void prune();
+
+    uint64_t hits() const { return _hits; }
+    uint64_t misses() const { return _misses; }
+
+    // Windows named prefix, or children of it ("prefix/...")
+    static OwnerFilter windowFilter(const std::string& prefix);
+
+private:
+    struct Entry {
+        uint64_t stamp = 0;
+        std::vector<ImDrawList*> lists;  // Owned clones
+        bool used = true;
+    };
+
+    static void release(Entry& entry);
+
+    std::unordered_map<std::string, Entry> _entries;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+};
+
+// FNV-1a, for building stamps from window rects and content versions
+inline uint64_t stampMix(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint64_t stampMix(uint64_t hash, float value) {
+    return stampMix(hash, static_cast<uint64_t>(std::bit_cast<uint32_t>(value)));
+}
+
+constexpr uint64_t STAMP_SEED = 14695981039346656037ull;
+
+} // namespace yetty
@@ -0,0 +1,308 @@
+#include "table-source.h"
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace yetty {
+
+// Lines indexed between publishing to the main thread
+static constexpr size_t INDEX_CHUNK = 64 * 1024;
+
+static bool parseNumber(const char* begin, const char* end, double& value) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+    if (begin == end) return false;
+    if (*begin == '+') ++begin;
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+static std::string formatNumber(double value) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.6g", value);
+    return std::string(buf, n > 0 ? static_cast<size_t>(n) : 0);
+}
+
+std::string TableSource::describe() const {
+    return std::to_string(rowCount()) + " rows";
+}
+
+Result<TableSource::Ptr> openTableSource(const std::string& spec) {
+    if (spec.rfind("shm:", 0) == 0) {
+        return ColumnarSource::openShared(spec.substr(4));
+    }
+    return CsvSource::open(spec);
+}
+
+//-----------------------------------------------------------------------------
+// ColumnarSource
+//-----------------------------------------------------------------------------
+
+namespace {
+struct ColumnarHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t rows;
+    uint64_t cols;
+};
+static_assert(sizeof(ColumnarHeader) == 24, "ColumnarHeader must stay packed");
+
+// a * b <= limit, without overflowing on hostile header values
+bool productFits(uint64_t a, uint64_t b, uint64_t limit) {
+    return a == 0 || b <= limit / a;
+}
+} // anonymous namespace
+
+ColumnarSource::ColumnarSource(std::vector<std::string> names,
+                               std::vector<std::vector<double>> columns)
+    : _names(std::move(names)), _owned(std::move(columns)) {
+    _rows = _owned.empty() ? 0 : _owned[0].size();
+    for (const auto& column : _owned) {
+        _rows = std::min(_rows, column.size());
+        _columns.push_back(column.data());
+    }
+    _names.resize(_columns.size());
+}
+
+ColumnarSource::~ColumnarSource() {
+    if (_mapping) {
+        munmap(_mapping, _mapping_size);
+    }
+}
+
+Result<TableSource::Ptr> ColumnarSource::openShared(const std::string& name) {
+    std::string path = name.empty() || name[0] != '/' ? "/" + name : name;
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return Err<TableSource::Ptr>("ColumnarSource: shm_open failed for " + path +
+                                     ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ColumnarHeader)) {
+        close(fd);
+        return Err<TableSource::Ptr>("ColumnarSource: segment too small: " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return Err<TableSource::Ptr>("ColumnarSource: mmap failed for " + path);
+    }
+
+    ColumnarHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    // Names, then cols * rows doubles; each product is checked against what is left
+    uint64_t available = size - sizeof(header);
+    bool fits = productFits(header.cols, NAME_BYTES, available);
+    size_t namesBytes = fits ? static_cast<size_t>(header.cols * NAME_BYTES) : 0;
+    fits = fits && productFits(header.cols, header.rows, (available - namesBytes) / sizeof(double));
+    if (std::memcmp(header.magic, "YTBL", 4) != 0 || header.version != 1 || !fits) {
+        munmap(mapping, size);
+        return Err<TableSource::Ptr>("ColumnarSource: not a YTBL v1 segment: " + path);
+    }
+
+    auto source = std::shared_ptr<ColumnarSource>(new ColumnarSource());
+    source->_mapping = mapping;
+    source->_mapping_size = size;
+    source->_rows = header.rows;
+
+    const char* names = static_cast<const char*>(mapping) + sizeof(header);
+    const double* data = reinterpret_cast<const double*>(names + namesBytes);
+    for (uint64_t c = 0; c < header.cols; ++c) {
+        const char* colName = names + c * NAME_BYTES;
+        source->_names.emplace_back(colName, strnlen(colName, NAME_BYTES));
+        source->_columns.push_back(data + c * header.rows);
+    }
+
+    spdlog::info("ColumnarSource: mapped {} ({} rows x {} columns)", path, header.rows, header.cols);
+    return Ok<TableSource::Ptr>(source);
+}
+
+void ColumnarSource::fetchRow(size_t row, std::vector<std::string>& out) const {
+    out.clear();
+    for (const double* column : _columns) {
+        out.push_back(formatNumber(column[row]));
+    }
+}
+
+bool ColumnarSource::number(size_t row, size_t col, double& value) const {
+    value = _columns[col][row];
+    return true;
+}
+
+std::string ColumnarSource::cell(size_t row, size_t col) const {
+    return formatNumber(_columns[col][row]);
+}
+
+//-----------------------------------------------------------------------------
+// CsvSource
+//-----------------------------------------------------------------------------
+
+CsvSource::~CsvSource() {
+    _stop = true;
+    if (_indexer.joinable()) {
+        _indexer.join();
+    }
+    if (_data) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+}
+
+Result<TableSource::Ptr> CsvSource::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Err<TableSource::Ptr>("CsvSource: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return Err<TableSource::Ptr>("CsvSource: empty file: " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return Err<TableSource::Ptr>("CsvSource: mmap failed for " + path);
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    auto source = std::shared_ptr<CsvSource>(new CsvSource());
+    source->_path = path;
+    source->_data = static_cast<const char*>(mapping);
+    source->_size = size;
+
+    // Header line gives the column names and the delimiter
+    const char* data = source->_data;
+    const char* eol = static_cast<const char*>(std::memchr(data, '\n', size));
+    size_t headerEnd = eol ? static_cast<size_t>(eol - data) : size;
+    std::string_view header(data, headerEnd);
+    bool tsv = path.size() > 4 && path.compare(path.size() - 4, 4, ".tsv") == 0;
+    if (tsv || (header.find('\t') != std::string_view::npos && header.find(',') == std::string_view::npos)) {
+        source->_delimiter = '\t';
+    }
+
+    source->splitRange(data, data + headerEnd, source->_names);
+    source->_offsets.push_back(eol ? headerEnd + 1 : size);
+    if (source->_names.empty()) {
+        source->_names.push_back("column");
+    }
+
+    source->_indexer = std::thread(&CsvSource::indexLoop, source.get());
+    spdlog::info("CsvSource: mapped {} ({} bytes, {} columns)", path, size, source->_names.size());
+    return Ok<TableSource::Ptr>(source);
+}
+
+void CsvSource::indexLoop() {
+    size_t pos;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pos = _offsets.back();
+    }
+
+    std::vector<uint64_t> chunk;
+    chunk.reserve(INDEX_CHUNK);
+    while (pos < _size && !_stop.load(std::memory_order_relaxed)) {
+        const char* eol = static_cast<const char*>(std::memchr(_data + pos, '\n', _size - pos));
+        size_t end = eol ? static_cast<size_t>(eol - _data) + 1 : _size;
+        // A blank line is not a row; it becomes leading whitespace of the
+        // next one, which splitRange() skips
+        bool blank = _data[pos] == '\n' || (end - pos == 2 && eol && _data[pos] == '\r');
+        if (!blank) {
+            chunk.push_back(end);
+        }
+        pos = end;
+
+        if (chunk.size() == INDEX_CHUNK || (pos >= _size && !chunk.empty())) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _offsets.insert(_offsets.end(), chunk.begin(), chunk.end());
+            chunk.clear();
+        }
+    }
+    _indexed.store(true, std::memory_order_release);
+    spdlog::info("CsvSource: indexed {} rows of {}", rowCount(), _path);
+}
+
+size_t CsvSource::rowCount() const {
+    if (complete()) return _offsets.size() - 1;
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _offsets.size() - 1;
+}
+
+void CsvSource::splitLine(size_t row, std::vector<std::string>& out) const {
+    uint64_t begin, end;
+    if (complete()) {
+        begin = _offsets[row];
+        end = _offsets[row + 1];
+    } else {
+        std::lock_guard<std::mutex> lock(_mutex);
+        begin = _offsets[row];
+        end = _offsets[row + 1];
+    }
+    splitRange(_data + begin, _data + end, out);
+}
+
+void CsvSource::splitRange(const char* p, const char* lineEnd, std::vector<std::string>& out) const {
+    out.clear();
+    // Skip newlines of preceding blank lines and this line's own terminator
+    while (p < lineEnd && (*p == '\n' || *p == '\r')) ++p;
+    while (lineEnd > p && (lineEnd[-1] == '\n' || lineEnd[-1] == '\r')) --lineEnd;
+
+    std::string field;
+    bool quoted = false;
+    for (; p < lineEnd; ++p) {
+        char c = *p;
+        if (quoted) {
+            if (c == '"') {
+                if (p + 1 < lineEnd && p[1] == '"') {
+                    field += '"';
+                    ++p;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += c;
+            }
+        } else if (c == '"' && field.empty()) {
+            quoted = true;
+        } else if (c == _delimiter) {
+            out.push_back(std::move(field));
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    out.push_back(std::move(field));
+}
+
+void CsvSource::fetchRow(size_t row, std::vector<std::string>& out) const {
+    splitLine(row, out);
+    out.resize(_names.size());
+}
+
+bool CsvSource::number(size_t row, size_t col, double& value) const {
+    std::string text = cell(row, col);
+    return parseNumber(text.data(), text.data() + text.size(), value);
+}
+
+std::string CsvSource::cell(size_t row, size_t col) const {
+    std::vector<std::string> fields;
+    splitLine(row, fields);
+    return col < fields.size() ? std::move(fields[col]) : std::string();
+}
+
+std::string CsvSource::describe() const {
+    std::string text = TableSource::describe();
+    if (!complete()) text += ", indexing...";
+    return text;
+}
+
+} // namespace yetty
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <yetty/plugin.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// TableSource - row/column data read on demand by VirtualTable
+//-----------------------------------------------------------------------------
+// Only visible rows are ever read, so a source must answer random row
+// accesses cheaply. Row indices are in source order; sorting is applied by
+// the table on top. cell() may be called from the table's sort thread while
+// the main thread reads other rows, so implementations must be thread-safe
+// for concurrent reads.
+//-----------------------------------------------------------------------------
+class TableSource {
+public:
+    using Ptr = std::shared_ptr<TableSource>;
+
+    virtual ~TableSource() = default;
+
+    // May grow while a source is still indexing
+    virtual size_t rowCount() const = 0;
+    virtual size_t columnCount() const = 0;
+    virtual const std::string& columnName(size_t col) const = 0;
+
+    // Appends the row's cells to out (cleared first)
+    virtual void fetchRow(size_t row, std::vector<std::string>& out) const = 0;
+
+    // Numeric value of a cell, false if the cell is not a number
+    virtual bool number(size_t row, size_t col, double& value) const = 0;
+    virtual std::string cell(size_t row, size_t col) const = 0;
+
+    // True once rowCount() is final
+    virtual bool complete() const { return true; }
+
+    // Short description for the table header ("1.2M rows, indexing...")
+    virtual std::string describe() const;
+};
+
+// Opens "shm:/name" (ColumnarSource layout) or a CSV file path
+Result<TableSource::Ptr> openTableSource(const std::string& spec);
+
+//-----------------------------------------------------------------------------
+// ColumnarSource - float64 columns in memory or in a shared memory segment
+//-----------------------------------------------------------------------------
+// Segment layout (little endian), written e.g. by numpy from a Python layer:
+//   char magic[4] = "YTBL"; uint32 version = 1; uint64 rows; uint64 cols;
+//   char names[cols][64];    NUL-padded column names
+//   double data[cols][rows]; column-major values
+//-----------------------------------------------------------------------------
+class ColumnarSource : public TableSource {
+public:
+    static constexpr size_t NAME_BYTES = 64;
+
+    // In-memory columns, all of the same length
+    ColumnarSource(std::vector<std::string> names, std::vector<std::vector<double>> columns);
+    ~ColumnarSource() override;
+
+    static Result<TableSource::Ptr> openShared(const std::string& name);
+
+    size_t rowCount() const override { return _rows; }
+    size_t columnCount() const override { return _names.size(); }
+    const std::string& columnName(size_t col) const override { return _names[col]; }
+    void fetchRow(size_t row, std::vector<std::string>& out) const override;
+    bool number(size_t row, size_t col, double& value) const override;
+    std::string cell(size_t row, size_t col) const override;
+
+private:
+    ColumnarSource() = default;
+
+    std::vector<std::string> _names;
+    std::vector<std::vector<double>> _owned;
+    std::vector<const double*> _columns;
+    size_t _rows = 0;
+
+    // Shared memory mapping, if any
+    void* _mapping = nullptr;
+    size_t _mapping_size = 0;
+};
+
+//-----------------------------------------------------------------------------
+// CsvSource - memory-mapped CSV with a background line index
+//-----------------------------------------------------------------------------
+// The file is mapped, never read into memory. A worker thread records the
+// offset of every line; rows become visible as soon as they are indexed, so
+// the first screen of a multi-GB log shows immediately. Fields are parsed
+// only when a row is fetched. Quoted fields ("a,b", "say ""hi""") are
+// supported; embedded newlines inside quotes are not.
+//-----------------------------------------------------------------------------
+class CsvSource : public TableSource {
+public:
+    ~CsvSource() override;
+
+    static Result<TableSource::Ptr> open(const std::string& path);
+
+    size_t rowCount() const override;
+    size_t columnCount() const override { return _names.size(); }
+    const std::string& columnName(size_t col) const override { return _names[col]; }
+    void fetchRow(size_t row, std::vector<std::string>& out) const override;
+    bool number(size_t row, size_t col, double& value) const override;
+    std::string cell(size_t row, size_t col) const override;
+    bool complete() const override { return _indexed.load(std::memory_order_acquire); }
+    std::string describe() const override;
+
+private:
+    CsvSource() = default;
+
+    void indexLoop();
+    void splitLine(size_t row, std::vector<std::string>& out) const;
+    void splitRange(const char* begin, const char* end, std::vector<std::string>& out) const;
+
+    std::string _path;
+    const char* _data = nullptr;
+    size_t _size = 0;
+    char _delimiter = ',';
+    std::vector<std::string> _names;
+
+    // Start offset of each data row, plus the end of the last one
+    mutable std::mutex _mutex;
+    std::vector<uint64_t> _offsets;
+    std::thread _indexer;
+    std::atomic<bool> _indexed{false};
+    std::atomic<bool> _stop{false};
+};
+
+} // namespace yetty
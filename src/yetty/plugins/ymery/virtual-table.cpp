@@ -0,0 +1,223 @@
+#include "virtual-table.h"
+#include "draw-cache.h"
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <numeric>
+
+namespace yetty {
+
+// ImGui's per-table column limit
+static constexpr size_t MAX_COLUMNS = 512;
+
+// Work between cancellation checks, small enough that cancelSort() (run on
+// the UI thread) joins within a millisecond or so
+static constexpr size_t SORT_CHECK_ROWS = 4096;
+static constexpr size_t SORT_CHECK_COMPARES = 16 * 1024;
+
+// Thrown from the comparator to abandon a cancelled sort
+struct SortCancelled {};
+
+VirtualTable::VirtualTable(TableSource::Ptr source) : _source(std::move(source)) {}
+
+VirtualTable::~VirtualTable() {
+    cancelSort();
+}
+
+void VirtualTable::drawStatus() {
+    std::string status = _source->describe();
+    if (_sorting.load(std::memory_order_relaxed)) status += ", sorting...";
+    ImGui::TextUnformatted(status.c_str());
+}
+
+void VirtualTable::draw(const char* id) {
+    ++_frame;
+    takeSortResult();
+
+    size_t columns = _source->columnCount();
+    if (columns == 0) return;
+    columns = std::min(columns, MAX_COLUMNS);
+
+    ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_ScrollX |
+                            ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter |
+                            ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable |
+                            ImGuiTableFlags_Hideable | ImGuiTableFlags_Sortable |
+                            ImGuiTableFlags_SortTristate;
+    if (!ImGui::BeginTable(id, static_cast<int>(columns), flags)) return;
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    for (size_t c = 0; c < columns; ++c) {
+        ImGui::TableSetupColumn(_source->columnName(c).c_str());
+    }
+    ImGui::TableHeadersRow();
+
+    if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsDirty) {
+        if (specs->SpecsCount > 0) {
+            const ImGuiTableColumnSortSpecs& spec = specs->Specs[0];
+            requestSort(spec.ColumnIndex, spec.SortDirection == ImGuiSortDirection_Ascending);
+        } else {
+            // Tristate back to unsorted
+            cancelSort();
+            _order.clear();
+            _order_version++;
+            _pages.clear();
+        }
+        specs->SpecsDirty = false;
+    }
+
+    // Rows indexed after a sort started are appended in source order
+    size_t displayRows = _source->rowCount();
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(std::min<size_t>(displayRows, INT_MAX)));
+    while (clipper.Step()) {
+        for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+            const auto& cells = row(static_cast<size_t>(r), displayRows);
+            ImGui::TableNextRow();
+            for (size_t c = 0; c < columns && c < cells.size(); ++c) {
+                ImGui::TableSetColumnIndex(static_cast<int>(c));
+                ImGui::TextUnformatted(cells[c].data(), cells[c].data() + cells[c].size());
+            }
+        }
+    }
+    ImGui::EndTable();
+
+    evictPages();
+}
+
+uint64_t VirtualTable::contentStamp() {
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(_sort_mutex);
+        ready = _sorted_ready;
+    }
+    uint64_t stamp = stampMix(STAMP_SEED, static_cast<uint64_t>(_source->rowCount()));
+    stamp = stampMix(stamp, static_cast<uint64_t>(_source->complete()));
+    stamp = stampMix(stamp, static_cast<uint64_t>(ready));
+    return stampMix(stamp, _order_version);
+}
+
+const std::vector<std::string>& VirtualTable::row(size_t displayRow, size_t displayRows) {
+    size_t pageIndex = displayRow / PAGE_ROWS;
+    size_t first = pageIndex * PAGE_ROWS;
+    size_t count = std::min(PAGE_ROWS, displayRows - first);
+
+    Page& page = _pages[pageIndex];
+    page.lastUsed = _frame;
+    // A page cut short while the source was still indexing is refetched
+    if (page.rows.size() < count) {
+        size_t start = page.rows.size();
+        page.rows.resize(count);
+        for (size_t i = start; i < count; ++i) {
+            size_t displayIndex = first + i;
+            size_t sourceRow = displayIndex < _order.size() ? _order[displayIndex] : displayIndex;
+            _source->fetchRow(sourceRow, page.rows[i]);
+        }
+    }
+
+    size_t offset = displayRow - first;
+    return offset < page.rows.size() ? page.rows[offset] : _empty_row;
+}
+
+void VirtualTable::evictPages() {
+    while (_pages.size() > MAX_PAGES) {
+        auto oldest = _pages.begin();
+        for (auto it = _pages.begin(); it != _pages.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+        }
+        if (oldest->second.lastUsed == _frame) break;  // Everything is visible
+        _pages.erase(oldest);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Background sorting
+//-----------------------------------------------------------------------------
+
+void VirtualTable::requestSort(int column, bool ascending) {
+    cancelSort();
+    _cancel_sort = false;
+    _sorting = true;
+    _sorter = std::thread(&VirtualTable::sortLoop, this, column, ascending);
+}
+
+void VirtualTable::cancelSort() {
+    if (_sorter.joinable()) {
+        _cancel_sort = true;
+        _sorter.join();
+    }
+    std::lock_guard<std::mutex> lock(_sort_mutex);
+    _sorted.clear();
+    _sorted_ready = false;
+    _sorting = false;
+}
+
+void VirtualTable::sortLoop(int column, bool ascending) {
+    // Sorting a partial index would reorder again when it finishes
+    while (!_source->complete()) {
+        if (_cancel_sort.load(std::memory_order_relaxed)) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = _source->rowCount();
+    size_t col = static_cast<size_t>(column);
+
+    // Numbers sort numerically and before text
+    std::vector<double> numbers(rows);
+    std::vector<std::string> texts(rows);
+    std::vector<uint8_t> isNumber(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        if (r % SORT_CHECK_ROWS == 0 && _cancel_sort.load(std::memory_order_relaxed)) return;
+        isNumber[r] = _source->number(r, col, numbers[r]);
+        if (!isNumber[r]) texts[r] = _source->cell(r, col);
+    }
+
+    std::vector<size_t> order(rows);
+    std::iota(order.begin(), order.end(), size_t(0));
+    auto less = [&](size_t a, size_t b) {
+        if (isNumber[a] != isNumber[b]) return isNumber[a] > isNumber[b];
+        if (isNumber[a]) return numbers[a] < numbers[b];
+        return texts[a] < texts[b];
+    };
+    // A cancelled sort stops mid-way instead of finishing a multi-second sort
+    size_t compares = 0;
+    auto ordered = [&](size_t a, size_t b) {
+        if (++compares % SORT_CHECK_COMPARES == 0 && _cancel_sort.load(std::memory_order_relaxed)) {
+            throw SortCancelled{};
+        }
+        return ascending ? less(a, b) : less(b, a);
+    };
+    try {
+        std::stable_sort(order.begin(), order.end(), ordered);
+    } catch (const SortCancelled&) {
+        return;
+    }
+
+    spdlog::debug("VirtualTable: sorted {} rows by column {} in {} ms", rows, column,
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start).count());
+
+    std::lock_guard<std::mutex> lock(_sort_mutex);
+    if (_cancel_sort.load(std::memory_order_relaxed)) return;
+    _sorted = std::move(order);
+    _sorted_ready = true;
+}
+
+void VirtualTable::takeSortResult() {
+    {
+        std::lock_guard<std::mutex> lock(_sort_mutex);
+        if (!_sorted_ready) return;
+        _order = std::move(_sorted);
+        _sorted.clear();
+        _sorted_ready = false;
+    }
+    if (_sorter.joinable()) _sorter.join();
+    _sorting = false;
+    _order_version++;
+    _pages.clear();
+}
+
+} // namespace yetty
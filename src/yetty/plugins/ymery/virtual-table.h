@@ -0,0 +1,80 @@
+#pragma once
+
+#include "table-source.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace yetty {
+
+//-----------------------------------------------------------------------------
+// VirtualTable - ImGui table that only submits and fetches visible rows
+//-----------------------------------------------------------------------------
+// Rows are laid out with ImGuiListClipper, so a frame costs the same for a
+// hundred rows as for a hundred million. Visible rows are read from the
+// TableSource a page at a time and kept in a small LRU cache; scrolling back
+// and forth over the same region does not re-parse it.
+//
+// Clicking a column header builds the sort order on a worker thread. The
+// table keeps showing the previous order until the new one is ready. A newer
+// sort request or closing the table cancels the running one; the worker
+// checks for that while extracting keys and inside the comparator, so the UI
+// thread never waits for a sort to finish.
+//-----------------------------------------------------------------------------
+class VirtualTable {
+public:
+    explicit VirtualTable(TableSource::Ptr source);
+    ~VirtualTable();
+
+    VirtualTable(const VirtualTable&) = delete;
+    VirtualTable& operator=(const VirtualTable&) = delete;
+
+    // One line: source state and sort progress. Cheap, drawn every frame
+    void drawStatus();
+
+    // Draws the rows into the current ImGui window, filling it
+    void draw(const char* id);
+
+    // Changes whenever draw() would show different rows
+    uint64_t contentStamp();
+
+private:
+    static constexpr size_t PAGE_ROWS = 128;
+    static constexpr size_t MAX_PAGES = 32;
+
+    struct Page {
+        std::vector<std::vector<std::string>> rows;
+        uint64_t lastUsed = 0;
+    };
+
+    const std::vector<std::string>& row(size_t displayRow, size_t displayRows);
+    void evictPages();
+
+    void requestSort(int column, bool ascending);
+    void cancelSort();
+    void sortLoop(int column, bool ascending);
+    void takeSortResult();
+
+    TableSource::Ptr _source;
+
+    std::unordered_map<size_t, Page> _pages;
+    uint64_t _frame = 0;
+    std::vector<std::string> _empty_row;
+
+    // Sort order in effect: display row -> source row (empty = source order)
+    std::vector<size_t> _order;
+    uint64_t _order_version = 0;
+
+    std::thread _sorter;
+    std::atomic<bool> _cancel_sort{false};
+    std::atomic<bool> _sorting{false};
+    std::mutex _sort_mutex;
+    std::vector<size_t> _sorted;  // Finished order, guarded by _sort_mutex
+    bool _sorted_ready = false;
+};
+
+} // namespace yetty
@@ -1,14 +1,17 @@
 #include "ymery.h"
+#include "virtual-table.h"
 #include <yetty/yetty.h>
 #include <yetty/webgpu-context.h>
 
 #include <ymery/embedded.hpp>
 #include <imgui.h>
+#include <imgui_internal.h>
 #include <imgui_impl_wgpu.h>
 #include <implot.h>
 
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <filesystem>
 #include <spdlog/spdlog.h>
@@ -20,6 +23,30 @@
 
 namespace yetty {
 
+// Frames after the last input before cached windows are reused again, so
+// hover and release states are drawn before being frozen
+static constexpr uint64_t SETTLE_FRAMES = 3;
+
+static constexpr const char* APP_CACHE_KEY = "##ymery-app";
+static constexpr const char* TABLE_WINDOW_PREFIX = "##ymery-table-";
+
+static bool isTableWindow(const char* name) {
+    return std::strncmp(name, TABLE_WINDOW_PREFIX, std::strlen(TABLE_WINDOW_PREFIX)) == 0;
+}
+
+// Window ImGui keeps per-frame state for: the focused window and the one
+// owning the active widget (InputText editing, a held scrollbar). Such a
+// window must be submitted every frame or ImGui drops that state.
+static bool windowIsLive(ImGuiWindow* window, const DrawCache::OwnerFilter& filter) {
+    return window && window->Name && filter(window->Name);
+}
+
+static bool holdsFocus(const DrawCache::OwnerFilter& filter) {
+    ImGuiContext& g = *GImGui;
+    return windowIsLive(g.NavWindow, filter) ||
+           (g.ActiveId != 0 && windowIsLive(g.ActiveIdWindow, filter));
+}
+
 // Get the directory containing the executable
 static std::string getExecutableDir() {
 #ifdef __linux__
@@ -143,6 +170,7 @@ Result<void> YmeryPlugin::dispose() {
     // Finally clean up ImGui
     if (_imgui_ctx) {
         ImGui::SetCurrentContext(_imgui_ctx);
+        _draw_cache.clear();
         ImGui_ImplWGPU_Shutdown();
 
         if (_implot_ctx) {
@@ -240,10 +268,16 @@ Result<void> YmeryPlugin::render(WebGPUContext& ctx) {
         }
     }
 
-    // Lazy create ymery app on first render
-    if (!_app) {
-        auto firstLayer = std::static_pointer_cast<YmeryLayer>(_layers[0]);
-
+    // Lazy create ymery app on first render, from the first layer with a layout
+    std::shared_ptr<YmeryLayer> firstLayer;
+    for (auto& layer : _layers) {
+        auto ymeryLayer = std::static_pointer_cast<YmeryLayer>(layer);
+        if (!ymeryLayer->getLayoutPath().empty()) {
+            firstLayer = ymeryLayer;
+            break;
+        }
+    }
+    if (!_app && firstLayer) {
         ymery::EmbeddedConfig config;
         config.layout_paths.push_back(firstLayer->getLayoutPath());
 
@@ -275,7 +309,7 @@ Result<void> YmeryPlugin::render(WebGPUContext& ctx) {
         spdlog::info("YmeryPlugin: EmbeddedApp created");
     }
 
-    if (!_app) return Err<void>("YmeryPlugin: app not initialized");
+    if (!_app && firstLayer) return Err<void>("YmeryPlugin: app not initialized");
 
     // Store cell dimensions for input coordinate calculation
     _cell_width = rc.cellWidth;
@@ -298,13 +332,8 @@ Result<void> YmeryPlugin::render(WebGPUContext& ctx) {
     ImGui_ImplWGPU_NewFrame();
     ImGui::NewFrame();
 
-    // Render each layer at its position
-    for (auto& layerBase : _layers) {
-        if (!layerBase->isVisible()) continue;
-        if (layerBase->getScreenType() != currentScreen) continue;
-
-        auto layer = std::static_pointer_cast<YmeryLayer>(layerBase);
-
+    // Layer rect in pixels; false if it is off-screen
+    auto layerRect = [&](YmeryLayer* layer, ImVec2& pos, ImVec2& size) {
         float pixelX = layer->getX() * rc.cellWidth;
         float pixelY = layer->getY() * rc.cellHeight;
         float pixelW = layer->getWidthCells() * rc.cellWidth;
@@ -319,21 +348,121 @@ Result<void> YmeryPlugin::render(WebGPUContext& ctx) {
         if (rc.termRows > 0) {
             float screenPixelHeight = rc.termRows * rc.cellHeight;
             if (pixelY + pixelH <= 0 || pixelY >= screenPixelHeight) {
-                continue;
+                return false;
             }
         }
 
-        // Position the ImGui window for this layer
-        ImGui::SetNextWindowPos(ImVec2(pixelX, pixelY), ImGuiCond_Always);
-        ImGui::SetNextWindowSize(ImVec2(pixelW, pixelH), ImGuiCond_Always);
+        pos = ImVec2(pixelX, pixelY);
+        size = ImVec2(pixelW, pixelH);
+        return true;
+    };
+    auto stampRect = [](uint64_t stamp, const ImVec2& pos, const ImVec2& size) {
+        stamp = stampMix(stamp, pos.x);
+        stamp = stampMix(stamp, pos.y);
+        stamp = stampMix(stamp, size.x);
+        return stampMix(stamp, size.y);
+    };
+
+    // Windows are rebuilt only after input settles or when their stamp
+    // changes; otherwise last frame's draw lists are spliced in
+    ++_frame;
+    bool settled = _frame - _last_input_frame > SETTLE_FRAMES;
+
+    std::vector<std::shared_ptr<YmeryLayer>> layoutLayers;
+    std::vector<std::shared_ptr<YmeryLayer>> tableLayers;
+    for (auto& layerBase : _layers) {
+        if (!layerBase->isVisible()) continue;
+        if (layerBase->getScreenType() != currentScreen) continue;
+        auto layer = std::static_pointer_cast<YmeryLayer>(layerBase);
+        (layer->table() ? tableLayers : layoutLayers).push_back(layer);
+    }
+
+    // Render each layer at its position
+    uint64_t appStamp = stampMix(STAMP_SEED, io.DisplaySize.x);
+    appStamp = stampMix(appStamp, io.DisplaySize.y);
+    for (auto& layer : layoutLayers) {
+        ImVec2 pos, size;
+        if (!layerRect(layer.get(), pos, size)) continue;
+        appStamp = stampRect(appStamp, pos, size);
+        ImGui::SetNextWindowPos(pos, ImGuiCond_Always);
+        ImGui::SetNextWindowSize(size, ImGuiCond_Always);
     }
 
-    // Render ymery widgets
-    _app->render_widgets();
+    // Render ymery widgets; a static layout only changes in response to input.
+    // render_widgets() builds every layout window in one call, so the app is
+    // skipped or rebuilt as a whole, and never while one of its windows has focus
+    auto appFilter = [](const char* owner) { return !isTableWindow(owner); };
+    bool cacheApp = _app && firstLayer && firstLayer->isStaticLayout();
+    bool appCached = cacheApp && settled && !holdsFocus(appFilter) &&
+                     _draw_cache.valid(APP_CACHE_KEY, appStamp);
+    if (_app && !appCached) {
+        _app->render_widgets();
+    }
+
+    // Table layers draw their own window after the layout's. The window and
+    // its status line are cheap and always built; the rows child (and the
+    // table's scroll child inside it) is what gets cached
+    struct CachedChild {
+        std::string key;     // Layer's table window name
+        std::string window;  // ImGui name of the rows child, when built this frame
+        uint64_t stamp;
+        bool cached;
+    };
+    std::vector<CachedChild> tableChildren;
+    for (auto& layer : tableLayers) {
+        ImVec2 pos, size;
+        if (!layerRect(layer.get(), pos, size)) continue;
+
+        std::string name = TABLE_WINDOW_PREFIX + std::to_string(reinterpret_cast<uintptr_t>(layer.get()));
+        ImGui::SetNextWindowPos(pos, ImGuiCond_Always);
+        ImGui::SetNextWindowSize(size, ImGuiCond_Always);
+        ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings |
+                                       ImGuiWindowFlags_NoMove;
+        if (ImGui::Begin(name.c_str(), nullptr, windowFlags)) {
+            layer->table()->drawStatus();
+
+            ImVec2 avail = ImGui::GetContentRegionAvail();
+            uint64_t stamp = stampRect(layer->table()->contentStamp(), ImGui::GetCursorScreenPos(), avail);
+            bool cached = settled && !holdsFocus(DrawCache::windowFilter(name)) &&
+                          _draw_cache.valid(name, stamp);
+            std::string child;
+            if (cached) {
+                ImGui::Dummy(avail);  // Keeps the parent's layout as if the child were there
+            } else {
+                if (ImGui::BeginChild("##body", avail)) {
+                    child = ImGui::GetCurrentWindow()->Name;
+                    layer->table()->draw("##rows");
+                }
+                ImGui::EndChild();
+            }
+            tableChildren.push_back({std::move(name), std::move(child), stamp, cached});
+        }
+        ImGui::End();
+    }
 
     // End ImGui frame
     ImGui::Render();
 
+    // Capture what was rebuilt before splicing, so clones are not re-cloned
+    ImDrawData* drawData = ImGui::GetDrawData();
+    if (cacheApp && !appCached) {
+        _draw_cache.capture(APP_CACHE_KEY, appStamp, drawData, appFilter);
+    }
+    for (const auto& child : tableChildren) {
+        if (!child.cached && !child.window.empty()) {
+            _draw_cache.capture(child.key, child.stamp, drawData, DrawCache::windowFilter(child.window));
+        }
+    }
+    if (appCached) {
+        _draw_cache.splice(APP_CACHE_KEY, drawData);
+    }
+    for (const auto& child : tableChildren) {
+        if (child.cached) {
+            _draw_cache.splice(child.key, drawData);
+        }
+    }
+    _draw_cache.prune();
+
     // Create render pass
     WGPURenderPassColorAttachment colorAttachment = {};
     colorAttachment.view = rc.targetView;
@@ -396,11 +525,23 @@ Result<void> YmeryLayer::parsePayload(const std::string& payload) {
             _plugin_path = value;
         } else if (key == "main" || key == "module") {
             _main_module = value;
+        } else if (key == "table") {
+            _table_spec = value;
+        } else if (key == "static") {
+            _static_layout = value == "1" || value == "true" || value == "yes";
         }
     }
 
-    if (_layout_path.empty()) {
-        return Err<void>("YmeryLayer: layout_path is required");
+    if (_layout_path.empty() && _table_spec.empty()) {
+        return Err<void>("YmeryLayer: layout_path or table is required");
+    }
+
+    if (!_table_spec.empty()) {
+        auto source = openTableSource(_table_spec);
+        if (!source) {
+            return Err<void>("YmeryLayer: failed to open table " + _table_spec, source);
+        }
+        _table = std::make_unique<VirtualTable>(*source);
     }
 
     return Ok();
@@ -419,6 +560,7 @@ bool YmeryLayer::onMouseMove(float x, float y) {
     auto plugin = static_cast<YmeryPlugin*>(_parent);
     if (plugin && plugin->imguiContext()) {
         ImGui::SetCurrentContext(plugin->imguiContext());
+        plugin->noteInput();
         ImGuiIO& io = ImGui::GetIO();
         // Add layer offset to get absolute position
         float absX = x + getX() * plugin->_cell_width;
@@ -433,6 +575,7 @@ bool YmeryLayer::onMouseButton(int button, bool pressed) {
     auto plugin = static_cast<YmeryPlugin*>(_parent);
     if (plugin && plugin->imguiContext()) {
         ImGui::SetCurrentContext(plugin->imguiContext());
+        plugin->noteInput();
         ImGuiIO& io = ImGui::GetIO();
         if (button >= 0 && button < ImGuiMouseButton_COUNT) {
             io.AddMouseButtonEvent(button, pressed);
@@ -447,6 +590,7 @@ bool YmeryLayer::onMouseScroll(float xoffset, float yoffset, int mods) {
     auto plugin = static_cast<YmeryPlugin*>(_parent);
     if (plugin && plugin->imguiContext()) {
         ImGui::SetCurrentContext(plugin->imguiContext());
+        plugin->noteInput();
         ImGuiIO& io = ImGui::GetIO();
         io.AddMouseWheelEvent(xoffset, yoffset);
         return true;
@@ -459,6 +603,7 @@ bool YmeryLayer::onKey(int key, int scancode, int action, int mods) {
     auto plugin = static_cast<YmeryPlugin*>(_parent);
     if (plugin && plugin->imguiContext()) {
         ImGui::SetCurrentContext(plugin->imguiContext());
+        plugin->noteInput();
         ImGuiIO& io = ImGui::GetIO();
 
         ImGuiKey imgui_key = glfw_key_to_imgui_key(key);
@@ -479,6 +624,7 @@ bool YmeryLayer::onChar(unsigned int codepoint) {
     auto plugin = static_cast<YmeryPlugin*>(_parent);
     if (plugin && plugin->imguiContext()) {
         ImGui::SetCurrentContext(plugin->imguiContext());
+        plugin->noteInput();
         ImGuiIO& io = ImGui::GetIO();
         io.AddInputCharacter(codepoint);
         return io.WantCaptureKeyboard;
@@ -505,6 +651,7 @@ void YmeryLayer::setFocus(bool f) {
     auto plugin = static_cast<YmeryPlugin*>(_parent);
     if (plugin && plugin->imguiContext()) {
         ImGui::SetCurrentContext(plugin->imguiContext());
+        plugin->noteInput();
         ImGuiIO& io = ImGui::GetIO();
         io.AddFocusEvent(f);
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "draw-cache.h"
 #include <yetty/plugin.h>
 #include <webgpu/webgpu.h>
 #include <memory>
@@ -15,6 +16,7 @@ namespace ymery {
 namespace yetty {
 
 class YmeryLayer;
+class VirtualTable;
 
 //-----------------------------------------------------------------------------
 // YmeryPlugin - holds shared ImGui context and ymery::EmbeddedApp
@@ -41,6 +43,9 @@ public:
     // For input coordinate calculation
     float _cell_width = 0;
     float _cell_height = 0;
+
+    // Input invalidates cached draw lists for a few frames
+    void noteInput() { _last_input_frame = _frame; }
 #endif
 
 private:
@@ -56,6 +61,10 @@ private:
     WGPUDevice _device = nullptr;
     WGPUQueue _queue = nullptr;
     WGPUTextureFormat _format = WGPUTextureFormat_Undefined;
+
+    DrawCache _draw_cache;
+    uint64_t _frame = 0;
+    uint64_t _last_input_frame = 0;
 #endif
     double _last_time = 0.0;
 };
@@ -89,12 +98,22 @@ public:
     const std::string& getPluginPath() const { return _plugin_path; }
     const std::string& getMainModule() const { return _main_module; }
 
+    // Set when the payload has table=<csv path | shm:/name>
+    VirtualTable* table() const { return _table.get(); }
+
+    // static=1: the layout only changes in response to input, so its draw
+    // lists are reused between input events
+    bool isStaticLayout() const { return _static_layout; }
+
 private:
     Result<void> parsePayload(const std::string& payload);
 
     std::string _layout_path;
     std::string _plugin_path;
     std::string _main_module = "app";
+    std::string _table_spec;
+    bool _static_layout = false;
+    std::unique_ptr<VirtualTable> _table;
 };
 
 using Ymery = YmeryPlugin;